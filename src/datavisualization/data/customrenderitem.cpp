@@ -32,19 +32,23 @@ CustomRenderItem::CustomRenderItem()
       m_preserveOpacity(true),
       m_useHighDefShader(true),
       m_drawSlices(false),
-      m_drawSliceFrames(false)
+      m_drawSliceFrames(false),
+      m_brickGridWidth(0),
+      m_brickGridHeight(0),
+      m_brickGridDepth(0),
+      m_occupancyTexture(0)
 
 {
 }
 
 CustomRenderItem::~CustomRenderItem()
 {
-    ObjectHelper::releaseObjectHelper(m_renderer, m_object);
+    ObjectHelper::releaseObjectHelper(m_object);
 }
 
 void CustomRenderItem::setMesh(const QString &meshFile)
 {
-    ObjectHelper::resetObjectHelper(m_renderer, m_object, meshFile);
+    ObjectHelper::resetObjectHelper(m_object, meshFile);
 }
 
 void CustomRenderItem::setColorTable(const QList<QRgb> &colors)
@@ -63,6 +67,143 @@ void CustomRenderItem::setColorTable(const QList<QRgb> &colors)
     }
 }
 
+// Scans the bricks overlapping the given voxel box and records the value range of each.
+// For single channel formats the range is the minimum and maximum voxel value, which is
+// classified against the color table later, so color table changes do not need a rescan.
+// Otherwise the range is the maximum alpha of the voxels.
+void CustomRenderItem::scanOccupancy(const uchar *data, qsizetype dataSize, int dataWidth,
+                                     int x, int y, int z, int width, int height, int depth)
+{
+    const int gridWidth = (m_textureWidth + volumeBrickSize - 1) / volumeBrickSize;
+    const int gridHeight = (m_textureHeight + volumeBrickSize - 1) / volumeBrickSize;
+    const int gridDepth = (m_textureDepth + volumeBrickSize - 1) / volumeBrickSize;
+    if (gridWidth != m_brickGridWidth || gridHeight != m_brickGridHeight
+            || gridDepth != m_brickGridDepth) {
+        m_brickGridWidth = gridWidth;
+        m_brickGridHeight = gridHeight;
+        m_brickGridDepth = gridDepth;
+        m_brickRanges.resize(gridWidth * gridHeight * gridDepth * 2);
+        x = 0;
+        y = 0;
+        z = 0;
+        width = m_textureWidth;
+        height = m_textureHeight;
+        depth = m_textureDepth;
+    }
+    if (m_brickRanges.isEmpty() || width <= 0 || height <= 0 || depth <= 0)
+        return;
+
+    quint16 *ranges = m_brickRanges.data();
+    const qsizetype frameSize = qsizetype(dataWidth) * m_textureHeight;
+    if (!data || dataSize < frameSize * m_textureDepth) {
+        // Nothing sensible to scan, so never skip anything
+        for (int i = 0; i < m_brickRanges.size(); i += 2) {
+            ranges[i] = 0;
+            ranges[i + 1] = 0xffff;
+        }
+        return;
+    }
+
+    const bool indexed = (m_textureFormat == QImage::Format_Indexed8);
+    int alphaTable[256];
+    if (indexed) {
+        for (int i = 0; i < 256; i++)
+            alphaTable[i] = i < m_colorTable.size() ? qRound(m_colorTable.at(i).w() * 255.0f) : 0;
+    }
+
+    const uchar *bits = data;
+    const int firstBrickX = x / volumeBrickSize;
+    const int firstBrickY = y / volumeBrickSize;
+    const int firstBrickZ = z / volumeBrickSize;
+    const int lastBrickX = qMin(x + width - 1, m_textureWidth - 1) / volumeBrickSize;
+    const int lastBrickY = qMin(y + height - 1, m_textureHeight - 1) / volumeBrickSize;
+    const int lastBrickZ = qMin(z + depth - 1, m_textureDepth - 1) / volumeBrickSize;
+    for (int bz = firstBrickZ; bz <= lastBrickZ; bz++) {
+        const int endZ = qMin((bz + 1) * volumeBrickSize, m_textureDepth);
+        for (int by = firstBrickY; by <= lastBrickY; by++) {
+            const int endY = qMin((by + 1) * volumeBrickSize, m_textureHeight);
+            for (int bx = firstBrickX; bx <= lastBrickX; bx++) {
+                const int startX = bx * volumeBrickSize;
+                const int endX = qMin(startX + volumeBrickSize, m_textureWidth);
+                int minValue = 0xffff;
+                int maxValue = 0;
+                for (int vz = bz * volumeBrickSize; vz < endZ; vz++) {
+                    for (int vy = by * volumeBrickSize; vy < endY; vy++) {
+                        const uchar *line = bits + vz * frameSize + qsizetype(vy) * dataWidth;
+                        for (int vx = startX; vx < endX; vx++) {
+                            int value;
+                            switch (m_textureFormat) {
+                            case QImage::Format_Grayscale8:
+                                value = line[vx];
+                                break;
+                            case QImage::Format_Grayscale16:
+                                value = reinterpret_cast<const quint16 *>(line)[vx];
+                                break;
+                            case QImage::Format_Indexed8:
+                                value = alphaTable[line[vx]];
+                                break;
+                            default:
+                                value = qAlpha(reinterpret_cast<const QRgb *>(line)[vx]);
+                                break;
+                            }
+                            minValue = qMin(minValue, value);
+                            maxValue = qMax(maxValue, value);
+                        }
+                    }
+                }
+                const int brick = (bz * gridHeight + by) * gridWidth + bx;
+                ranges[brick * 2] = quint16(minValue);
+                ranges[brick * 2 + 1] = quint16(maxValue);
+            }
+        }
+    }
+}
+
+// Turns the brick value ranges into the occupancy grid uploaded to the GPU.
+// Grid lines are aligned to 32 bits like QImage::Format_Grayscale8 volume data.
+void CustomRenderItem::classifyOccupancy()
+{
+    const int lineSize = (m_brickGridWidth + 3) & ~3;
+    m_occupancy.fill(0, lineSize * m_brickGridHeight * m_brickGridDepth);
+    if (m_occupancy.isEmpty())
+        return;
+
+    const bool singleChannel = (m_textureFormat == QImage::Format_Grayscale8
+                                || m_textureFormat == QImage::Format_Grayscale16);
+    // visibleEntries[i] is the count of color table entries below i that are not transparent
+    int visibleEntries[257];
+    if (singleChannel) {
+        visibleEntries[0] = 0;
+        for (int i = 0; i < 256; i++) {
+            const bool visible = i < m_colorTable.size() && m_colorTable.at(i).w() > 0.0f;
+            visibleEntries[i + 1] = visibleEntries[i] + (visible ? 1 : 0);
+        }
+    }
+    const int maxValue = (m_textureFormat == QImage::Format_Grayscale16) ? 0xffff : 0xff;
+
+    const quint16 *ranges = m_brickRanges.constData();
+    uchar *occupancy = m_occupancy.data();
+    for (int bz = 0; bz < m_brickGridDepth; bz++) {
+        for (int by = 0; by < m_brickGridHeight; by++) {
+            for (int bx = 0; bx < m_brickGridWidth; bx++) {
+                const int brick = (bz * m_brickGridHeight + by) * m_brickGridWidth + bx;
+                bool visible;
+                if (singleChannel) {
+                    // The shader interpolates between the entry below and above the value
+                    const int first = int(ranges[brick * 2]) * 255 / maxValue;
+                    const int last = qMin((int(ranges[brick * 2 + 1]) * 255 + maxValue - 1)
+                                          / maxValue + 1, 255);
+                    visible = visibleEntries[last + 1] > visibleEntries[first];
+                } else {
+                    visible = ranges[brick * 2 + 1] > 0;
+                }
+                if (visible)
+                    occupancy[(bz * m_brickGridHeight + by) * lineSize + bx] = 255;
+            }
+        }
+    }
+}
+
 void CustomRenderItem::setMinBounds(const QVector3D &bounds)
 {
     m_minBounds = bounds;
@@ -16,6 +16,7 @@
 
 #include "abstractrenderitem_p.h"
 #include "objecthelper_p.h"
+#include "texturehelper_p.h"
 #include <QtGui/QRgb>
 #include <QtGui/QImage>
 #include <QtGui/QColor>
@@ -33,6 +34,7 @@ public:
 
     inline void setTexture(GLuint texture) { m_texture = texture; }
     inline GLuint texture() const { return m_texture; }
+    inline TextureStream &textureStream() { return m_textureStream; }
     void setMesh(const QString &meshFile);
     inline ObjectHelper *mesh() const { return m_object; }
     inline void setScaling(const QVector3D &scaling) { m_scaling = scaling; }
@@ -124,10 +126,24 @@ public:
     inline void setSliceFrameThicknesses(const QVector3D &thicknesses) { m_sliceFrameThicknesses = thicknesses; }
     inline const QVector3D &sliceFrameThicknesses() const { return m_sliceFrameThicknesses; }
 
+    // Coarse grid of volume bricks, telling which bricks contain visible voxels.
+    // The ray marching shader skips bricks that are fully transparent.
+    static const int volumeBrickSize = 8;
+    void scanOccupancy(const uchar *data, qsizetype dataSize, int dataWidth, int x, int y, int z,
+                       int width, int height, int depth);
+    void classifyOccupancy();
+    inline const QList<uchar> &occupancy() const { return m_occupancy; }
+    inline int brickGridWidth() const { return m_brickGridWidth; }
+    inline int brickGridHeight() const { return m_brickGridHeight; }
+    inline int brickGridDepth() const { return m_brickGridDepth; }
+    inline void setOccupancyTexture(GLuint texture) { m_occupancyTexture = texture; }
+    inline GLuint occupancyTexture() const { return m_occupancyTexture; }
+
 private:
     Q_DISABLE_COPY(CustomRenderItem)
 
     GLuint m_texture;
+    TextureStream m_textureStream;
     QVector3D m_scaling;
     QVector3D m_origScaling;
     QVector3D m_position;
@@ -165,6 +181,12 @@ private:
     QVector3D m_maxBoundsNormal;
     bool m_drawSlices;
     bool m_drawSliceFrames;
+    int m_brickGridWidth;
+    int m_brickGridHeight;
+    int m_brickGridDepth;
+    QList<quint16> m_brickRanges; // Minimum and maximum value or alpha of each brick
+    QList<uchar> m_occupancy;
+    GLuint m_occupancyTexture;
     QVector4D m_sliceFrameColor;
     QVector3D m_sliceFrameWidths;
     QVector3D m_sliceFrameGaps;
@@ -0,0 +1,158 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "labelatlas_p.h"
+#include "utils_p.h"
+
+#include <QtGui/QPainter>
+#include <QtCore/qmath.h>
+
+QT_BEGIN_NAMESPACE
+
+// Empty space around each label, so that mipmapping does not bleed neighboring labels
+// into each other at the smaller mip levels
+const int atlasPadding = 8;
+// A linearly filtered texel of mip level n covers 2^(n + 1) texels of the base level, so the
+// padding only separates the labels up to this level
+const int atlasMaxMipLevel = 2;
+
+LabelAtlas::LabelAtlas()
+    : m_textureId(0)
+{
+}
+
+LabelAtlas::~LabelAtlas()
+{
+    clear();
+}
+
+QImage LabelAtlas::packImages(const QList<QImage> &images, QList<QRect> &rects)
+{
+    rects.clear();
+    rects.reserve(images.size());
+
+    int maxWidth = 0;
+    qint64 totalArea = 0;
+    foreach (const QImage &image, images) {
+        if (image.isNull())
+            continue;
+        maxWidth = qMax(maxWidth, image.width());
+        totalArea += qint64(image.width() + atlasPadding) * (image.height() + atlasPadding);
+    }
+    if (!totalArea)
+        return QImage();
+
+    // Aim for a roughly square atlas, power of two sized for ES2 and for clean mipmaps
+    int atlasWidth = Utils::getNearestPowerOfTwo(qMax(maxWidth + atlasPadding,
+                                                      int(qSqrt(qreal(totalArea)))));
+    int maxSize = Utils::getMaxTextureSize();
+    if (maxSize && atlasWidth > maxSize)
+        return QImage();
+
+    // Place the images left to right on shelves as tall as the tallest image on them
+    int x = 0;
+    int y = 0;
+    int shelfHeight = 0;
+    foreach (const QImage &image, images) {
+        if (image.isNull()) {
+            rects.append(QRect());
+            continue;
+        }
+        if (x + image.width() > atlasWidth) {
+            x = 0;
+            y += shelfHeight + atlasPadding;
+            shelfHeight = 0;
+        }
+        rects.append(QRect(QPoint(x, y), image.size()));
+        x += image.width() + atlasPadding;
+        shelfHeight = qMax(shelfHeight, image.height());
+    }
+
+    int atlasHeight = Utils::getNearestPowerOfTwo(y + shelfHeight);
+    if (maxSize && atlasHeight > maxSize) {
+        rects.clear();
+        return QImage();
+    }
+
+    QImage atlas(atlasWidth, atlasHeight, QImage::Format_ARGB32);
+    atlas.fill(Qt::transparent);
+    QPainter painter(&atlas);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    for (int i = 0; i < images.size(); i++) {
+        if (!images.at(i).isNull())
+            painter.drawImage(rects.at(i).topLeft(), images.at(i));
+    }
+
+    return atlas;
+}
+
+QRectF LabelAtlas::uvRect(const QRect &rect, const QSize &atlasSize)
+{
+    // Textures are uploaded mirrored, so the first image row is at the top of the texture
+    qreal width = atlasSize.width();
+    qreal height = atlasSize.height();
+    return QRectF(rect.x() / width, (height - rect.y() - rect.height()) / height,
+                  rect.width() / width, rect.height() / height);
+}
+
+int LabelAtlas::maxMipLevel()
+{
+    return atlasMaxMipLevel;
+}
+
+void LabelAtlas::setTextureId(GLuint textureId)
+{
+    clear();
+    m_textureId = textureId;
+}
+
+GLuint LabelAtlas::textureId() const
+{
+    return m_textureId;
+}
+
+void LabelAtlas::clear()
+{
+    if (m_textureId && QOpenGLContext::currentContext())
+        QOpenGLContext::currentContext()->functions()->glDeleteTextures(1, &m_textureId);
+    m_textureId = 0;
+    m_size = QSize();
+    m_slots.clear();
+    m_images.clear();
+}
+
+void LabelAtlas::setContents(const QList<QImage> &images, const QList<QRect> &rects,
+                             const QSize &size)
+{
+    m_images = images;
+    m_slots = rects;
+    m_size = size;
+}
+
+bool LabelAtlas::findChangedImages(const QList<QImage> &images, QList<int> &changed) const
+{
+    changed.clear();
+    if (!m_textureId || images.size() > m_images.size())
+        return false;
+
+    for (int i = 0; i < images.size(); i++) {
+        const QImage &image = images.at(i);
+        if (image == m_images.at(i))
+            continue;
+        // Labels that grew or were empty when the atlas was packed have no room
+        if (!image.isNull() && (image.width() > m_slots.at(i).width()
+                                || image.height() > m_slots.at(i).height())) {
+            return false;
+        }
+        changed.append(i);
+    }
+    return true;
+}
+
+void LabelAtlas::replaceImages(const QList<QImage> &images)
+{
+    // Places of removed labels stay unused until the atlas is packed again
+    m_images = images;
+}
+
+QT_END_NAMESPACE
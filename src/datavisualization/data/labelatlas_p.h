@@ -0,0 +1,60 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef LABELATLAS_P_H
+#define LABELATLAS_P_H
+
+#include <private/datavisualizationglobal_p.h>
+#include <QtCore/QRect>
+#include <QtGui/QImage>
+
+QT_BEGIN_NAMESPACE
+
+// Shared texture for a set of labels. The label images are packed into one image, so that
+// the labels of an axis need only one texture upload and one texture bind.
+class Q_DATAVISUALIZATION_EXPORT LabelAtlas
+{
+public:
+    explicit LabelAtlas();
+    ~LabelAtlas();
+
+    static QImage packImages(const QList<QImage> &images, QList<QRect> &rects);
+    static QRectF uvRect(const QRect &rect, const QSize &atlasSize);
+    static int maxMipLevel();
+
+    void setTextureId(GLuint textureId);
+    GLuint textureId() const;
+    void clear();
+
+    // The images packed into the texture and their places, so that changed labels can be
+    // replaced in place instead of packing all labels again
+    void setContents(const QList<QImage> &images, const QList<QRect> &rects,
+                     const QSize &size);
+    // Returns false if the images cannot be replaced in place
+    bool findChangedImages(const QList<QImage> &images, QList<int> &changed) const;
+    void replaceImages(const QList<QImage> &images);
+    inline const QRect &slot(int index) const { return m_slots.at(index); }
+    inline const QSize &size() const { return m_size; }
+
+private:
+    Q_DISABLE_COPY(LabelAtlas)
+
+    GLuint m_textureId;
+    QSize m_size;
+    QList<QRect> m_slots;
+    QList<QImage> m_images;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -7,7 +7,9 @@ QT_BEGIN_NAMESPACE
 
 LabelItem::LabelItem()
     : m_size(QSize(0, 0)),
-      m_textureId(0)
+      m_textureId(0),
+      m_uvRect(0.0, 0.0, 1.0, 1.0),
+      m_ownsTexture(true)
 {
 }
 
@@ -28,8 +30,11 @@ QSize LabelItem::size() const
 
 void LabelItem::setTextureId(GLuint textureId)
 {
-    QOpenGLContext::currentContext()->functions()->glDeleteTextures(1, &m_textureId);
+    if (m_ownsTexture)
+        QOpenGLContext::currentContext()->functions()->glDeleteTextures(1, &m_textureId);
     m_textureId = textureId;
+    m_uvRect = QRectF(0.0, 0.0, 1.0, 1.0);
+    m_ownsTexture = true;
 }
 
 GLuint LabelItem::textureId() const
@@ -37,12 +42,24 @@ GLuint LabelItem::textureId() const
     return m_textureId;
 }
 
+void LabelItem::setAtlasEntry(GLuint atlasTextureId, const QSize &size, const QRectF &uvRect)
+{
+    // The atlas texture is owned by the LabelAtlas, the item only refers to a part of it
+    clear();
+    m_textureId = atlasTextureId;
+    m_size = size;
+    m_uvRect = uvRect;
+    m_ownsTexture = false;
+}
+
 void LabelItem::clear()
 {
-    if (m_textureId && QOpenGLContext::currentContext())
+    if (m_ownsTexture && m_textureId && QOpenGLContext::currentContext())
         QOpenGLContext::currentContext()->functions()->glDeleteTextures(1, &m_textureId);
     m_textureId = 0;
     m_size = QSize(0, 0);
+    m_uvRect = QRectF(0.0, 0.0, 1.0, 1.0);
+    m_ownsTexture = true;
 }
 
 QT_END_NAMESPACE
@@ -15,6 +15,7 @@
 #define LABELITEM_P_H
 
 #include <private/datavisualizationglobal_p.h>
+#include <QtCore/QRectF>
 #include <QtCore/QSize>
 
 QT_BEGIN_NAMESPACE
@@ -29,6 +30,8 @@ public:
     QSize size() const;
     void setTextureId(GLuint textureId);
     GLuint textureId() const;
+    void setAtlasEntry(GLuint atlasTextureId, const QSize &size, const QRectF &uvRect);
+    inline const QRectF &uvRect() const { return m_uvRect; }
     void clear();
 
 private:
@@ -36,6 +39,8 @@ private:
 
     QSize m_size;
     GLuint m_textureId;
+    QRectF m_uvRect;
+    bool m_ownsTexture;
 };
 
 QT_END_NAMESPACE
@@ -356,6 +356,8 @@ void QBar3DSeriesPrivate::connectControllerAndProxy(Abstract3DController *newCon
                          &Bars3DController::handleRowsInserted);
         QObject::connect(barDataProxy, &QBarDataProxy::itemChanged, controller,
                          &Bars3DController::handleItemChanged);
+        QObject::connect(barDataProxy, &QBarDataProxy::itemsChanged, controller,
+                         &Bars3DController::handleItemsChanged);
         QObject::connect(barDataProxy, &QBarDataProxy::rowLabelsChanged, controller,
                          &Bars3DController::handleDataRowLabelsChanged);
         QObject::connect(barDataProxy, &QBarDataProxy::columnLabelsChanged, controller,
@@ -233,6 +233,24 @@ void QBarDataProxy::setItem(const QPoint &position, const QBarDataItem &item)
     setItem(position.x(), position.y(), item);
 }
 
+/*!
+ * \since 6.5
+ *
+ * Changes the items at the positions specified by \a positions to the corresponding
+ * items in \a items. The x-value of each position indicates the row and the y-value
+ * indicates the column. Both lists must be of the same size.
+ *
+ * Instead of emitting itemChanged() for each item, emits a single itemsChanged() signal,
+ * which makes this the preferred way to change many scattered items at once.
+ */
+void QBarDataProxy::setItems(const QList<QPoint> &positions, const QList<QBarDataItem> &items)
+{
+    QList<QBitArray> changedColumns;
+    int startRow = dptr()->setItems(positions, items, changedColumns);
+    if (!changedColumns.isEmpty())
+        emit itemsChanged(startRow, changedColumns);
+}
+
 /*!
  * Adds the new row \a row to the end of an array.
  * Existing row labels are not affected.
@@ -524,6 +542,17 @@ const QBarDataProxyPrivate *QBarDataProxy::dptrc() const
  * this signal needs to be emitted to update the graph.
  */
 
+/*!
+ * \fn void QBarDataProxy::itemsChanged(int startRow, const QList<QBitArray> &changedColumns)
+ * \since 6.5
+ *
+ * This signal is emitted when multiple items change at once.
+ * Each bit array in \a changedColumns marks the changed columns of one row, starting
+ * from the row \a startRow. Rows without changes have an empty bit array.
+ * If items are changed in the array without calling setItems(),
+ * this signal can be emitted to update the graph.
+ */
+
 // QBarDataProxyPrivate
 
 QBarDataProxyPrivate::QBarDataProxyPrivate(QBarDataProxy *q)
@@ -590,6 +619,36 @@ void QBarDataProxyPrivate::setItem(int rowIndex, int columnIndex, const QBarData
     row[columnIndex] = item;
 }
 
+int QBarDataProxyPrivate::setItems(const QList<QPoint> &positions,
+                                   const QList<QBarDataItem> &items,
+                                   QList<QBitArray> &changedColumns)
+{
+    Q_ASSERT(positions.size() == items.size());
+    int count = qMin(positions.size(), items.size());
+    if (!count)
+        return 0;
+
+    int startRow = m_dataArray->size();
+    int endRow = -1;
+    for (int i = 0; i < count; i++) {
+        const QPoint &position = positions.at(i);
+        startRow = qMin(startRow, position.x());
+        endRow = qMax(endRow, position.x());
+    }
+
+    changedColumns.resize(endRow - startRow + 1);
+    for (int i = 0; i < count; i++) {
+        const QPoint &position = positions.at(i);
+        setItem(position.x(), position.y(), items.at(i));
+        QBitArray &rowBits = changedColumns[position.x() - startRow];
+        if (rowBits.size() <= position.y())
+            rowBits.resize(m_dataArray->at(position.x())->size());
+        rowBits.setBit(position.y());
+    }
+
+    return startRow;
+}
+
 int QBarDataProxyPrivate::addRow(QBarDataRow *row, const QString *label)
 {
     int currentSize = m_dataArray->size();
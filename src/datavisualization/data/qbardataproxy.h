@@ -6,6 +6,7 @@
 
 #include <QtDataVisualization/qabstractdataproxy.h>
 #include <QtDataVisualization/qbardataitem.h>
+#include <QtCore/QBitArray>
 #include <QtCore/QList>
 #include <QtCore/QStringList>
 
@@ -56,6 +57,7 @@ public:
 
     void setItem(int rowIndex, int columnIndex, const QBarDataItem &item);
     void setItem(const QPoint &position, const QBarDataItem &item);
+    void setItems(const QList<QPoint> &positions, const QList<QBarDataItem> &items);
 
     int addRow(QBarDataRow *row);
     int addRow(QBarDataRow *row, const QString &label);
@@ -76,6 +78,7 @@ Q_SIGNALS:
     void rowsRemoved(int startIndex, int count);
     void rowsInserted(int startIndex, int count);
     void itemChanged(int rowIndex, int columnIndex);
+    void itemsChanged(int startRow, const QList<QBitArray> &changedColumns);
 
     void rowCountChanged(int count);
     void rowLabelsChanged();
@@ -31,6 +31,8 @@ public:
     void setRow(int rowIndex, QBarDataRow *row, const QString *label);
     void setRows(int rowIndex, const QBarDataArray &rows, const QStringList *labels);
     void setItem(int rowIndex, int columnIndex, const QBarDataItem &item);
+    int setItems(const QList<QPoint> &positions, const QList<QBarDataItem> &items,
+                 QList<QBitArray> &changedColumns);
     int addRow(QBarDataRow *row, const QString *label);
     int addRows(const QBarDataArray &rows, const QStringList *labels);
     void insertRow(int rowIndex, QBarDataRow *row, const QString *label);
@@ -417,10 +417,46 @@ void QCustom3DItem::setTextureImage(const QImage &textureImage)
             emit textureFileChanged(d_ptr->m_textureFile);
         }
         d_ptr->m_dirtyBits.textureDirty = true;
+        d_ptr->m_dirtyBits.textureStreamed = false;
         emit d_ptr->needUpdate();
     }
 }
 
+/*!
+ * \since 6.5
+ *
+ * Replaces the contents of the item texture with \a textureImage.
+ *
+ * Unlike setTextureImage(), this function is meant for textures that change
+ * often, such as video frames. As long as the image size stays the same, the
+ * existing texture is updated in place and the data is streamed to the GPU
+ * without allocating a new texture. The image is not compared to the previous
+ * one. A null image clears the texture like setTextureImage() does.
+ *
+ * \note To conserve memory, the given QImage is cleared after the texture is
+ * updated.
+ *
+ * \sa setTextureImage()
+ */
+void QCustom3DItem::updateTextureImage(const QImage &textureImage)
+{
+    if (textureImage.isNull() || d_ptr->m_isLabelItem || d_ptr->m_isVolumeItem) {
+        setTextureImage(textureImage);
+        return;
+    }
+
+    d_ptr->m_textureImage = textureImage;
+    if (!d_ptr->m_textureFile.isEmpty()) {
+        d_ptr->m_textureFile.clear();
+        emit textureFileChanged(d_ptr->m_textureFile);
+    }
+    // A pending full texture change must not be turned into an update
+    if (!d_ptr->m_dirtyBits.textureDirty)
+        d_ptr->m_dirtyBits.textureStreamed = true;
+    d_ptr->m_dirtyBits.textureDirty = true;
+    emit d_ptr->needUpdate();
+}
+
 /*! \property QCustom3DItem::textureFile
  *
  * \brief The texture file name for the item.
@@ -443,6 +479,7 @@ void QCustom3DItem::setTextureFile(const QString &textureFile)
         }
         emit textureFileChanged(textureFile);
         d_ptr->m_dirtyBits.textureDirty = true;
+        d_ptr->m_dirtyBits.textureStreamed = false;
         emit d_ptr->needUpdate();
     }
 }
@@ -509,6 +546,7 @@ void QCustom3DItemPrivate::resetDirtyBits()
     m_dirtyBits.rotationDirty = false;
     m_dirtyBits.visibleDirty = false;
     m_dirtyBits.shadowCastingDirty = false;
+    m_dirtyBits.textureStreamed = false;
 }
 
 QT_END_NAMESPACE
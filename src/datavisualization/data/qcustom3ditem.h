@@ -64,6 +64,7 @@ public:
     Q_INVOKABLE void setRotationAxisAndAngle(const QVector3D &axis, float angle);
 
     void setTextureImage(const QImage &textureImage);
+    void updateTextureImage(const QImage &textureImage);
 
 Q_SIGNALS:
     void meshFileChanged(const QString &meshFile);
@@ -27,6 +27,7 @@ struct QCustomItemDirtyBitField {
     bool rotationDirty              : 1;
     bool visibleDirty               : 1;
     bool shadowCastingDirty         : 1;
+    bool textureStreamed            : 1;
 
     QCustomItemDirtyBitField()
         : textureDirty(false),
@@ -35,7 +36,8 @@ struct QCustomItemDirtyBitField {
           scalingDirty(false),
           rotationDirty(false),
           visibleDirty(false),
-          shadowCastingDirty(false)
+          shadowCastingDirty(false),
+          textureStreamed(false)
     {
     }
 };
@@ -2,7 +2,7 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
 
 #include "qcustom3dlabel_p.h"
-#include "utils_p.h"
+#include "labelimagecache_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -342,8 +342,8 @@ void QCustom3DLabelPrivate::createTextureImage()
 void QCustom3DLabelPrivate::createTextureImage(const QColor &bgrColor, const QColor &txtColor,
                                                bool background, bool borders)
 {
-    m_textureImage = Utils::printTextToImage(m_font, m_text, bgrColor, txtColor, background,
-                                             borders, 0);
+    m_textureImage = LabelImageCache::labelImage(m_font, m_text, bgrColor, txtColor, background,
+                                                 borders, 0);
 }
 
 void QCustom3DLabelPrivate::handleTextureChange()
@@ -4,6 +4,12 @@
 #include "qcustom3dvolume_p.h"
 #include "utils_p.h"
 
+#include <QtCore/QFile>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -380,17 +386,24 @@ void QCustom3DVolume::setTextureDimensions(int width, int height, int depth)
 
 /*!
  * Returns the actual texture data width. When the texture format is QImage::Format_Indexed8,
- * this value equals textureWidth aligned to a 32-bit boundary. Otherwise, this
+ * this value equals textureWidth aligned to a 32-bit boundary. When the texture format is
+ * QImage::Format_Grayscale8 or QImage::Format_Grayscale16, this value equals the byte count
+ * of a line of textureWidth voxels, rounded up to a multiple of four. Otherwise, this
  * value equals four times textureWidth.
  */
 int QCustom3DVolume::textureDataWidth() const
 {
     int dataWidth = dptrc()->m_textureWidth;
 
-    if (dptrc()->m_textureFormat == QImage::Format_Indexed8)
+    if (dptrc()->m_textureFormat == QImage::Format_Indexed8) {
         dataWidth += dataWidth % 4;
-    else
+    } else if (dptrc()->m_textureFormat == QImage::Format_Grayscale8
+               || dptrc()->m_textureFormat == QImage::Format_Grayscale16) {
+        dataWidth *= QCustom3DVolumePrivate::bytesPerVoxel(dptrc()->m_textureFormat);
+        dataWidth = (dataWidth + 3) & ~3;
+    } else {
         dataWidth *= 4;
+    }
 
     return dataWidth;
 }
@@ -495,7 +508,13 @@ void QCustom3DVolume::setSliceIndices(int x, int y, int z)
  *
  * \brief The array containing the colors for indexed texture formats.
  *
- * If the texture format is not indexed, this array is not used and can be empty.
+ * If the texture format is QImage::Format_Grayscale8 or QImage::Format_Grayscale16, this array
+ * is used as a transfer function: the voxel values are scaled to the range of the array and the
+ * resulting color is interpolated between the two nearest entries. Arrays of other than 256
+ * entries are resampled to 256 entries before they are passed to the graphics hardware.
+ * If the array is empty, a linear ramp from transparent black to opaque white is used.
+ *
+ * For other texture formats, this array is not used and can be empty.
  *
  * Defaults to \c{0}.
  *
@@ -541,6 +560,9 @@ QList<QRgb> QCustom3DVolume::colorTable() const
  * count. The padding bytes should indicate a fully transparent color to avoid
  * rendering artifacts.
  *
+ * While the texture data is taken from a file set with setTextureDataFile(), this property
+ * is \c{0}. Setting this property stops using the file.
+ *
  * Defaults to \c{0}.
  *
  * \sa colorTable, setTextureFormat(), setSubTextureData(), textureDataWidth()
@@ -549,6 +571,7 @@ void QCustom3DVolume::setTextureData(QList<uchar> *data)
 {
     if (dptr()->m_textureData != data)
         delete dptr()->m_textureData;
+    dptr()->releaseTextureDataFile();
 
     // Even if the pointer is same as previously, consider this property changed, as the values
     // can be changed unbeknownst to us via the array pointer.
@@ -562,7 +585,7 @@ void QCustom3DVolume::setTextureData(QList<uchar> *data)
  * Creates a new texture data array from an array of \a images and sets it as
  * textureData for this volume object. The texture dimensions are also set according to image
  * and array dimensions. All of the images in the array must be the same size. If the images are not
- * all in the QImage::Format_Indexed8 format, all texture data will be converted into the
+ * all in the same supported texture format, all texture data will be converted into the
  * QImage::Format_ARGB32 format. If the images are in the
  * QImage::Format_Indexed8 format, the colorTable value
  * for the entire volume will be taken from the first image.
@@ -580,7 +603,7 @@ QList<uchar> *QCustom3DVolume::createTextureData(const QList<QImage *> &images)
         int imageHeight = currentImage->height();
         QImage::Format imageFormat = currentImage->format();
         bool convert = false;
-        if (imageFormat != QImage::Format_Indexed8 && imageFormat != QImage::Format_ARGB32) {
+        if (!QCustom3DVolumePrivate::isSupportedFormat(imageFormat)) {
             convert = true;
             imageFormat = QImage::Format_ARGB32;
         } else {
@@ -602,9 +625,9 @@ QList<uchar> *QCustom3DVolume::createTextureData(const QList<QImage *> &images)
                 }
             }
         }
-        int colorBytes = (imageFormat == QImage::Format_Indexed8) ? 1 : 4;
-        int imageByteWidth = (imageFormat == QImage::Format_Indexed8)
-                ? currentImage->bytesPerLine() : imageWidth;
+        int colorBytes = QCustom3DVolumePrivate::bytesPerVoxel(imageFormat);
+        int imageByteWidth = (imageFormat == QImage::Format_ARGB32)
+                ? imageWidth : currentImage->bytesPerLine() / colorBytes;
         int frameSize = imageByteWidth * imageHeight * colorBytes;
         QList<uchar> *newTextureData = new QList<uchar>;
         newTextureData->resize(frameSize * imageCount);
@@ -642,6 +665,81 @@ QList<uchar> *QCustom3DVolume::textureData() const
     return dptrc()->m_textureData;
 }
 
+/*!
+ * \since 6.5
+ *
+ * Uses the raw voxel data in the file \a fileName, starting at \a offset bytes from the beginning
+ * of the file, as the texture data of this volume object. The file is mapped into memory instead
+ * of being read, so the data is never copied into the textureData array and the volume is not
+ * held in application memory twice.
+ *
+ * \note The whole volume is still uploaded into a single 3D texture, so it must fit into the
+ * graphics memory and within the maximum 3D texture size of the graphics hardware. Volumes
+ * larger than that cannot be shown, as the data is not paged to the graphics hardware on demand.
+ *
+ * The texture dimensions and format must be set before calling this function. The data in the
+ * file must be laid out like the textureData array, including the padding of the x-dimension
+ * lines, so it must contain at least
+ * (\c{textureDataWidth * textureHeight * textureDepth}) bytes after the \a offset.
+ * The file is opened for reading only, so setSubTextureData() cannot be used to modify the data
+ * while the file is in use. The file must not be modified or truncated while it is in use.
+ *
+ * Any previously set textureData array is deleted. Setting the textureData property or calling
+ * this function with an empty \a fileName stops using the file.
+ *
+ * Returns \c true if the file was mapped successfully.
+ *
+ * \sa textureDataFile(), textureData, textureDataWidth()
+ */
+bool QCustom3DVolume::setTextureDataFile(const QString &fileName, qint64 offset)
+{
+    if (fileName.isEmpty()) {
+        setTextureData(0);
+        return true;
+    }
+
+    qsizetype dataSize = qsizetype(textureDataWidth()) * dptr()->m_textureHeight
+            * dptr()->m_textureDepth;
+    QFile *file = new QFile(fileName);
+    if (offset < 0 || !dataSize || !file->open(QIODevice::ReadOnly)
+            || file->size() - offset < dataSize) {
+        qWarning() << __FUNCTION__ << "Texture data file is missing or too small:" << fileName;
+        delete file;
+        return false;
+    }
+    const uchar *mapped = file->map(offset, dataSize);
+    if (!mapped) {
+        qWarning() << __FUNCTION__ << "Failed to map texture data file:" << fileName
+                   << file->errorString();
+        delete file;
+        return false;
+    }
+
+    delete dptr()->m_textureData;
+    dptr()->m_textureData = 0;
+    dptr()->releaseTextureDataFile();
+    dptr()->m_textureDataFile = file;
+    dptr()->m_mappedTextureData = mapped;
+    dptr()->m_mappedTextureDataSize = dataSize;
+    dptr()->m_dirtyBitsVolume.textureDataDirty = true;
+    emit textureDataChanged(0);
+    emit dptr()->needUpdate();
+    return true;
+}
+
+/*!
+ * \since 6.5
+ *
+ * Returns the name of the file the texture data is taken from, or an empty string if the
+ * texture data is not taken from a file.
+ *
+ * \sa setTextureDataFile()
+ */
+QString QCustom3DVolume::textureDataFile() const
+{
+    return dptrc()->m_textureDataFile ? dptrc()->m_textureDataFile->fileName() : QString();
+}
+
 /*!
  * Sets a single 2D subtexture of the 3D texture along the specified
  * \a axis of the volume.
@@ -664,11 +762,13 @@ QList<uchar> *QCustom3DVolume::textureData() const
  */
 void QCustom3DVolume::setSubTextureData(Qt::Axis axis, int index, const uchar *data)
 {
-    if (data) {
+    if (data && !dptr()->m_textureData) {
+        qWarning() << __FUNCTION__ << "Attempted to set invalid subtexture.";
+    } else if (data) {
         int lineSize = textureDataWidth();
         int frameSize = lineSize * dptr()->m_textureHeight;
         int dataSize = dptr()->m_textureData->size();
-        int pixelWidth = (dptr()->m_textureFormat == QImage::Format_Indexed8) ? 1 : 4;
+        int pixelWidth = QCustom3DVolumePrivate::bytesPerVoxel(dptr()->m_textureFormat);
         int targetIndex;
         uchar *dataPtr = dptr()->m_textureData->data();
         bool invalid = (index < 0);
@@ -715,7 +815,16 @@ void QCustom3DVolume::setSubTextureData(Qt::Axis axis, int index, const uchar *d
                 void *subTexPtr = dataPtr + targetIndex;
                 memcpy(subTexPtr, static_cast<const void *>(data), frameSize);
             }
-            dptr()->m_dirtyBitsVolume.textureDataDirty = true;
+            if (axis == Qt::XAxis) {
+                dptr()->markSubTextureDataDirty(index, 0, 0, 1, dptr()->m_textureHeight,
+                                                dptr()->m_textureDepth);
+            } else if (axis == Qt::YAxis) {
+                dptr()->markSubTextureDataDirty(0, index, 0, dptr()->m_textureWidth, 1,
+                                                dptr()->m_textureDepth);
+            } else {
+                dptr()->markSubTextureDataDirty(0, 0, index, dptr()->m_textureWidth,
+                                                dptr()->m_textureHeight, 1);
+            }
             emit textureDataChanged(dptr()->m_textureData);
             emit dptr()->needUpdate();
         }
@@ -777,21 +886,81 @@ void QCustom3DVolume::setSubTextureData(Qt::Axis axis, int index, const QImage &
     }
 }
 
+/*!
+ * \since 6.5
+ *
+ * Sets a box of voxels of the 3D texture. The box starts at the voxel at \a x, \a y, and
+ * \a z, and spans \a width, \a height, and \a depth voxels. The texture \a data must be
+ * in the format specified by the textureFormat property and contain the voxels of the box
+ * tightly packed, ordered similarly to the textureData: lines along the x-axis, followed by
+ * the lines of the next y-coordinate, followed by the next slice along the z-axis.
+ *
+ * Unlike setTextureData(), only the changed part of the texture is uploaded to the graphics
+ * hardware. Multiple sub texture changes made before the next frame is rendered are uploaded
+ * together.
+ *
+ * \sa textureData, setSubTextureData()
+ */
+void QCustom3DVolume::setSubTextureData(int x, int y, int z, int width, int height, int depth,
+                                        const uchar *data)
+{
+    if (!data) {
+        qWarning() << __FUNCTION__ << "Tried to set null data.";
+        return;
+    }
+    if (!dptr()->m_textureData || x < 0 || y < 0 || z < 0 || width <= 0 || height <= 0
+            || depth <= 0 || x + width > dptr()->m_textureWidth
+            || y + height > dptr()->m_textureHeight || z + depth > dptr()->m_textureDepth) {
+        qWarning() << __FUNCTION__ << "Attempted to set invalid subtexture.";
+        return;
+    }
+
+    int lineSize = textureDataWidth();
+    int frameSize = lineSize * dptr()->m_textureHeight;
+    int pixelWidth = QCustom3DVolumePrivate::bytesPerVoxel(dptr()->m_textureFormat);
+    int boxLineSize = width * pixelWidth;
+    if (qsizetype(frameSize) * dptr()->m_textureDepth > dptr()->m_textureData->size()) {
+        qWarning() << __FUNCTION__ << "Attempted to set invalid subtexture.";
+        return;
+    }
+
+    uchar *dataPtr = dptr()->m_textureData->data();
+    const uchar *sourcePtr = data;
+    for (int k = z; k < z + depth; k++) {
+        uchar *targetPtr = dataPtr + (k * frameSize) + (y * lineSize) + (x * pixelWidth);
+        for (int j = 0; j < height; j++) {
+            memcpy(targetPtr, sourcePtr, boxLineSize);
+            targetPtr += lineSize;
+            sourcePtr += boxLineSize;
+        }
+    }
+
+    dptr()->markSubTextureDataDirty(x, y, z, width, height, depth);
+    emit textureDataChanged(dptr()->m_textureData);
+    emit dptr()->needUpdate();
+}
+
 // Note: textureFormat is not a Q_PROPERTY to work around an issue in meta object system that
 // doesn't allow QImage::format to be a property type. Qt 5.2.1 at least has this problem.
 
 /*!
- * Sets the format of the textureData property to \a format. Only two formats
- * are supported currently:
- * QImage::Format_Indexed8 and QImage::Format_ARGB32. If an indexed format is specified, colorTable
- * must also be set.
+ * Sets the format of the textureData property to \a format. The following formats
+ * are supported:
+ * QImage::Format_Indexed8, QImage::Format_ARGB32, QImage::Format_Grayscale8, and
+ * QImage::Format_Grayscale16. If an indexed format is specified, colorTable
+ * must also be set. The grayscale formats store a single value per voxel, which is
+ * mapped to a color through colorTable when rendering. This uses a quarter or half of the
+ * memory of QImage::Format_ARGB32, respectively, and the 16-bit format preserves the precision
+ * of data such as computed tomography scans.
  * Defaults to QImage::Format_ARGB32.
  *
+ * \note The grayscale formats are supported since Qt 6.5.
+ *
  * \sa colorTable, textureData
  */
 void QCustom3DVolume::setTextureFormat(QImage::Format format)
 {
-    if (format == QImage::Format_ARGB32 || format == QImage::Format_Indexed8) {
+    if (QCustom3DVolumePrivate::isSupportedFormat(format)) {
         if (dptr()->m_textureFormat != format) {
             dptr()->m_textureFormat = format;
             dptr()->m_dirtyBitsVolume.textureFormatDirty = true;
@@ -1138,6 +1307,9 @@ QCustom3DVolumePrivate::QCustom3DVolumePrivate(QCustom3DVolume *q) :
     m_sliceIndexZ(-1),
     m_textureFormat(QImage::Format_ARGB32),
     m_textureData(0),
+    m_textureDataFile(0),
+    m_mappedTextureData(0),
+    m_mappedTextureDataSize(0),
     m_alphaMultiplier(1.0f),
     m_preserveOpacity(true),
     m_useHighDefShader(true),
@@ -1167,6 +1339,9 @@ QCustom3DVolumePrivate::QCustom3DVolumePrivate(
       m_textureFormat(textureFormat),
       m_colorTable(colorTable),
       m_textureData(textureData),
+      m_textureDataFile(0),
+      m_mappedTextureData(0),
+      m_mappedTextureDataSize(0),
       m_alphaMultiplier(1.0f),
       m_preserveOpacity(true),
       m_useHighDefShader(true),
@@ -1187,7 +1362,7 @@ QCustom3DVolumePrivate::QCustom3DVolumePrivate(
     if (m_textureDepth < 0)
         m_textureDepth = 0;
 
-    if (m_textureFormat != QImage::Format_Indexed8)
+    if (!isSupportedFormat(m_textureFormat))
         m_textureFormat = QImage::Format_ARGB32;
 
 }
@@ -1195,6 +1370,36 @@ QCustom3DVolumePrivate::QCustom3DVolumePrivate(
 QCustom3DVolumePrivate::~QCustom3DVolumePrivate()
 {
     delete m_textureData;
+    releaseTextureDataFile();
+}
+
+void QCustom3DVolumePrivate::releaseTextureDataFile()
+{
+    // Closing the file also unmaps it
+    delete m_textureDataFile;
+    m_textureDataFile = 0;
+    m_mappedTextureData = 0;
+    m_mappedTextureDataSize = 0;
+}
+
+// Returns the voxel data from either the texture data array or the mapped file, or 0 if there
+// is not enough data for the current texture dimensions.
+const uchar *QCustom3DVolumePrivate::textureBits() const
+{
+    const QCustom3DVolume *volume = static_cast<const QCustom3DVolume *>(q_ptr);
+    qsizetype requiredSize = qsizetype(volume->textureDataWidth()) * m_textureHeight
+            * m_textureDepth;
+    qsizetype dataSize = textureBitsSize();
+    if (!dataSize || dataSize < requiredSize)
+        return 0;
+    return m_mappedTextureData ? m_mappedTextureData : m_textureData->constData();
+}
+
+qsizetype QCustom3DVolumePrivate::textureBitsSize() const
+{
+    if (m_mappedTextureData)
+        return m_mappedTextureDataSize;
+    return m_textureData ? m_textureData->size() : 0;
 }
 
 void QCustom3DVolumePrivate::resetDirtyBits()
@@ -1205,14 +1410,188 @@ void QCustom3DVolumePrivate::resetDirtyBits()
     m_dirtyBitsVolume.slicesDirty = false;
     m_dirtyBitsVolume.colorTableDirty = false;
     m_dirtyBitsVolume.textureDataDirty = false;
+    m_dirtyBitsVolume.subTextureDataDirty = false;
     m_dirtyBitsVolume.textureFormatDirty = false;
     m_dirtyBitsVolume.alphaDirty = false;
     m_dirtyBitsVolume.shaderDirty = false;
+    m_dirtyRegion = QCustomVolumeDirtyRegion();
 }
 
+QList<QRgb> QCustom3DVolumePrivate::renderColorTable() const
+{
+    if (m_colorTable.isEmpty() && usesColorTable(m_textureFormat)
+            && m_textureFormat != QImage::Format_Indexed8) {
+        QList<QRgb> ramp(256);
+        for (int i = 0; i < 256; i++)
+            ramp[i] = qRgba(i, i, i, i);
+        return ramp;
+    }
+    // Single channel values always index the full 256 entries of the table in the shaders, so
+    // shorter or longer tables are resampled to span the whole value range
+    if (m_colorTable.size() != 256 && !m_colorTable.isEmpty()
+            && (m_textureFormat == QImage::Format_Grayscale8
+                || m_textureFormat == QImage::Format_Grayscale16)) {
+        const int lastEntry = m_colorTable.size() - 1;
+        QList<QRgb> resampled(256);
+        for (int i = 0; i < 256; i++) {
+            float position = float(i * lastEntry) / 255.0f;
+            int lower = int(position);
+            int upper = qMin(lower + 1, lastEntry);
+            float fraction = position - float(lower);
+            QRgb lowerColor = m_colorTable.at(lower);
+            QRgb upperColor = m_colorTable.at(upper);
+            resampled[i] = qRgba(
+                        qRound(qRed(lowerColor) + fraction * (qRed(upperColor) - qRed(lowerColor))),
+                        qRound(qGreen(lowerColor)
+                               + fraction * (qGreen(upperColor) - qGreen(lowerColor))),
+                        qRound(qBlue(lowerColor)
+                               + fraction * (qBlue(upperColor) - qBlue(lowerColor))),
+                        qRound(qAlpha(lowerColor)
+                               + fraction * (qAlpha(upperColor) - qAlpha(lowerColor))));
+        }
+        return resampled;
+    }
+    return m_colorTable;
+}
+
+bool QCustom3DVolumePrivate::isSupportedFormat(QImage::Format format)
+{
+    return format == QImage::Format_ARGB32 || usesColorTable(format);
+}
+
+bool QCustom3DVolumePrivate::usesColorTable(QImage::Format format)
+{
+    return format == QImage::Format_Indexed8 || format == QImage::Format_Grayscale8
+            || format == QImage::Format_Grayscale16;
+}
+
+int QCustom3DVolumePrivate::bytesPerVoxel(QImage::Format format)
+{
+    switch (format) {
+    case QImage::Format_Indexed8:
+    case QImage::Format_Grayscale8:
+        return 1;
+    case QImage::Format_Grayscale16:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+void QCustom3DVolumePrivate::markSubTextureDataDirty(int x, int y, int z,
+                                                     int width, int height, int depth)
+{
+    m_dirtyBitsVolume.subTextureDataDirty = true;
+    m_dirtyRegion.unite(x, y, z, width, height, depth);
+}
+
+// Slices of at least this many voxels are extracted in several threads
+static const qint64 parallelSliceThreshold = 256 * 256;
+// Number of slice lines extracted together, so that the lines stay in cache while the
+// voxels for them are gathered frame by frame
+static const int sliceTileLines = 16;
+
+struct SliceExtraction
+{
+    const uchar *source;
+    uchar *target;
+    qsizetype targetLineSize;
+    Qt::Axis axis;
+    int index;
+    int width;
+    int height;
+    int pixelWidth;
+    qsizetype dataWidth;
+    qsizetype frameSize;
+    const uchar *alphaTable; // Alpha values to use for ARGB32 voxels, 0 to keep the alpha as is
+};
+
+static inline void copyVoxel(uchar *target, const uchar *source, int pixelWidth,
+                             const uchar *alphaTable)
+{
+    if (pixelWidth == 4) {
+        quint32 argb;
+        memcpy(&argb, source, 4);
+        if (alphaTable)
+            argb = (argb & 0x00ffffff) | (quint32(alphaTable[argb >> 24]) << 24);
+        memcpy(target, &argb, 4);
+    } else if (pixelWidth == 2) {
+        memcpy(target, source, 2);
+    } else {
+        *target = *source;
+    }
+}
+
+static void extractSliceLines(const SliceExtraction &slice, int firstLine, int lastLine)
+{
+    const int pixelWidth = slice.pixelWidth;
+    if (slice.axis == Qt::XAxis) {
+        // Consecutive slice pixels are a whole frame apart in the volume, so gather a tile of
+        // lines one frame at a time instead of walking through every frame for each line
+        const uchar *base = slice.source + qsizetype(slice.index) * pixelWidth;
+        for (int tile = firstLine; tile < lastLine; tile += sliceTileLines) {
+            const int tileEnd = qMin(tile + sliceTileLines, lastLine);
+            for (int j = 0; j < slice.width; j++) {
+                const uchar *p = base + slice.frameSize * j + slice.dataWidth * tile;
+                uchar *t = slice.target + slice.targetLineSize * tile + j * pixelWidth;
+                for (int i = tile; i < tileEnd; i++) {
+                    copyVoxel(t, p, pixelWidth, slice.alphaTable);
+                    p += slice.dataWidth;
+                    t += slice.targetLineSize;
+                }
+            }
+        }
+        return;
+    }
+
+    // Y and Z slice lines are contiguous in the volume
+    const qsizetype lineSize = qsizetype(slice.width) * pixelWidth;
+    for (int i = firstLine; i < lastLine; i++) {
+        const uchar *p;
+        if (slice.axis == Qt::YAxis) {
+            p = slice.source + slice.dataWidth * slice.index
+                    + slice.frameSize * (slice.height - 1 - i);
+        } else {
+            p = slice.source + slice.frameSize * slice.index + slice.dataWidth * i;
+        }
+        uchar *t = slice.target + slice.targetLineSize * i;
+        if (slice.alphaTable) {
+            for (int j = 0; j < slice.width; j++)
+                copyVoxel(t + j * 4, p + j * 4, 4, slice.alphaTable);
+        } else {
+            memcpy(t, p, lineSize);
+        }
+    }
+}
+
+class SliceExtractionJob : public QRunnable
+{
+public:
+    SliceExtractionJob(const SliceExtraction &slice, int firstLine, int lastLine,
+                       QSemaphore *finished)
+        : m_slice(slice),
+          m_firstLine(firstLine),
+          m_lastLine(lastLine),
+          m_finished(finished)
+    {
+    }
+
+    void run() override
+    {
+        extractSliceLines(m_slice, m_firstLine, m_lastLine);
+        m_finished->release();
+    }
+
+private:
+    SliceExtraction m_slice;
+    int m_firstLine;
+    int m_lastLine;
+    QSemaphore *m_finished;
+};
+
 QImage QCustom3DVolumePrivate::renderSlice(Qt::Axis axis, int index)
 {
-    if (index < 0)
+    if (index < 0 || !textureBits())
         return QImage();
 
     int x;
@@ -1234,53 +1613,57 @@ QImage QCustom3DVolumePrivate::renderSlice(Qt::Axis axis, int index)
         y = m_textureHeight;
     }
 
-    int padding = 0;
-    int pixelWidth = 4;
-    int dataWidth = qptr()->textureDataWidth();
-    if (m_textureFormat == QImage::Format_Indexed8) {
-        padding = x % 4;
-        pixelWidth = 1;
+    // Image lines are aligned the same way as the grayscale texture data lines
+    QImage image(x, y, m_textureFormat);
+    if (image.isNull())
+        return image;
+
+    // Apply the alpha multiplier to ARGB32 voxels while copying them
+    uchar alphaTable[256];
+    bool multiplyAlpha = m_textureFormat == QImage::Format_ARGB32 && m_alphaMultiplier != 1.0f;
+    if (multiplyAlpha) {
+        for (int i = 0; i < 256; i++)
+            alphaTable[i] = static_cast<uchar>(multipliedAlphaValue(i));
     }
-    QList<uchar> data((x + padding) * y * pixelWidth);
-    int frameSize = qptr()->textureDataWidth() * m_textureHeight;
 
-    int dataIndex = 0;
-    if (axis == Qt::XAxis) {
-        for (int i = 0; i < y; i++) {
-            const uchar *p = m_textureData->constData()
-                    + (index * pixelWidth) + (dataWidth * i);
-            for (int j = 0; j < x; j++) {
-                for (int k = 0; k < pixelWidth; k++)
-                    data[dataIndex++] = *(p + k);
-                p += frameSize;
-            }
-        }
-    } else if (axis == Qt::YAxis) {
-        for (int i = y - 1; i >= 0; i--) {
-            const uchar *p = m_textureData->constData() + (index * dataWidth)
-                    + (frameSize * i);
-            for (int j = 0; j < (x * pixelWidth); j++) {
-                data[dataIndex++] = *p;
-                p++;
-            }
-        }
-    } else {
-        for (int i = 0; i < y; i++) {
-            const uchar *p = m_textureData->constData() + (index * frameSize) + (dataWidth * i);
-            for (int j = 0; j < (x * pixelWidth); j++) {
-                data[dataIndex++] = *p;
-                p++;
-            }
-        }
+    SliceExtraction slice;
+    slice.source = textureBits();
+    slice.target = image.bits();
+    slice.targetLineSize = image.bytesPerLine();
+    slice.axis = axis;
+    slice.index = index;
+    slice.width = x;
+    slice.height = y;
+    slice.pixelWidth = bytesPerVoxel(m_textureFormat);
+    slice.dataWidth = qptr()->textureDataWidth();
+    slice.frameSize = slice.dataWidth * m_textureHeight;
+    slice.alphaTable = multiplyAlpha ? alphaTable : 0;
+
+    // Split large slices into bands of lines. Bands that cannot be started right away, for
+    // example because the pool is busy, are extracted in this thread instead of waited for.
+    int bandCount = 1;
+    if (qint64(x) * qint64(y) >= parallelSliceThreshold) {
+        bandCount = qBound(1, QThread::idealThreadCount(),
+                           (y + sliceTileLines - 1) / sliceTileLines);
     }
-
-    if (m_textureFormat != QImage::Format_Indexed8 && m_alphaMultiplier != 1.0f) {
-        for (int i = pixelWidth - 1; i < data.size(); i += pixelWidth)
-            data[i] = static_cast<uchar>(multipliedAlphaValue(data.at(i)));
+    int bandLines = (y + bandCount - 1) / bandCount;
+    bandLines = (bandLines + sliceTileLines - 1) / sliceTileLines * sliceTileLines;
+
+    QSemaphore finished;
+    int startedJobs = 0;
+    for (int firstLine = bandLines; firstLine < y; firstLine += bandLines) {
+        int lastLine = qMin(firstLine + bandLines, y);
+        SliceExtractionJob *job = new SliceExtractionJob(slice, firstLine, lastLine, &finished);
+        if (QThreadPool::globalInstance()->tryStart(job)) {
+            startedJobs++;
+        } else {
+            delete job;
+            extractSliceLines(slice, firstLine, lastLine);
+        }
     }
+    extractSliceLines(slice, 0, qMin(bandLines, y));
+    finished.acquire(startedJobs);
 
-    QImage image(data.constData(), x, y, x * pixelWidth, m_textureFormat);
-    image.bits(); // Call bits() to detach the new image from local data
     if (m_textureFormat == QImage::Format_Indexed8) {
         QList<QRgb> colorTable = m_colorTable;
         if (m_alphaMultiplier != 1.0f) {
@@ -1312,4 +1695,28 @@ QCustom3DVolume *QCustom3DVolumePrivate::qptr()
     return static_cast<QCustom3DVolume *>(q_ptr);
 }
 
+void QCustomVolumeDirtyRegion::unite(int boxX, int boxY, int boxZ,
+                                     int boxWidth, int boxHeight, int boxDepth)
+{
+    if (isEmpty()) {
+        x = boxX;
+        y = boxY;
+        z = boxZ;
+        width = boxWidth;
+        height = boxHeight;
+        depth = boxDepth;
+        return;
+    }
+
+    int right = qMax(x + width, boxX + boxWidth);
+    int bottom = qMax(y + height, boxY + boxHeight);
+    int back = qMax(z + depth, boxZ + boxDepth);
+    x = qMin(x, boxX);
+    y = qMin(y, boxY);
+    z = qMin(z, boxZ);
+    width = right - x;
+    height = bottom - y;
+    depth = back - z;
+}
+
 QT_END_NAMESPACE
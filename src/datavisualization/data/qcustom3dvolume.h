@@ -68,8 +68,12 @@ public:
     void setTextureData(QList<uchar> *data);
     QList<uchar> *createTextureData(const QList<QImage *> &images);
     QList<uchar> *textureData() const;
+    bool setTextureDataFile(const QString &fileName, qint64 offset = 0);
+    QString textureDataFile() const;
     void setSubTextureData(Qt::Axis axis, int index, const uchar *data);
     void setSubTextureData(Qt::Axis axis, int index, const QImage &image);
+    void setSubTextureData(int x, int y, int z, int width, int height, int depth,
+                           const uchar *data);
 
     void setTextureFormat(QImage::Format format);
     QImage::Format textureFormat() const;
@@ -19,11 +19,14 @@
 
 QT_BEGIN_NAMESPACE
 
+class QFile;
+
 struct QCustomVolumeDirtyBitField {
     bool textureDimensionsDirty : 1;
     bool slicesDirty            : 1;
     bool colorTableDirty        : 1;
     bool textureDataDirty       : 1;
+    bool subTextureDataDirty    : 1;
     bool textureFormatDirty     : 1;
     bool alphaDirty             : 1;
     bool shaderDirty            : 1;
@@ -33,6 +36,7 @@ struct QCustomVolumeDirtyBitField {
           slicesDirty(false),
           colorTableDirty(false),
           textureDataDirty(false),
+          subTextureDataDirty(false),
           textureFormatDirty(false),
           alphaDirty(false),
           shaderDirty(false)
@@ -40,7 +44,25 @@ struct QCustomVolumeDirtyBitField {
     }
 };
 
-class QCustom3DVolumePrivate : public QCustom3DItemPrivate
+// Bounding box of the voxels changed by sub texture updates since the last sync
+struct QCustomVolumeDirtyRegion {
+    int x;
+    int y;
+    int z;
+    int width;
+    int height;
+    int depth;
+
+    QCustomVolumeDirtyRegion()
+        : x(0), y(0), z(0), width(0), height(0), depth(0)
+    {
+    }
+
+    bool isEmpty() const { return !width || !height || !depth; }
+    void unite(int boxX, int boxY, int boxZ, int boxWidth, int boxHeight, int boxDepth);
+};
+
+class Q_DATAVISUALIZATION_EXPORT QCustom3DVolumePrivate : public QCustom3DItemPrivate
 {
     Q_OBJECT
 
@@ -53,7 +75,17 @@ public:
     virtual ~QCustom3DVolumePrivate();
 
     void resetDirtyBits();
+    void markSubTextureDataDirty(int x, int y, int z, int width, int height, int depth);
+    QList<QRgb> renderColorTable() const;
+
+    static bool isSupportedFormat(QImage::Format format);
+    static bool usesColorTable(QImage::Format format);
+    static int bytesPerVoxel(QImage::Format format);
     QImage renderSlice(Qt::Axis axis, int index);
+    const uchar *textureBits() const;
+    qsizetype textureBitsSize() const;
+    bool isTextureDataMapped() const { return m_mappedTextureData != 0; }
+    void releaseTextureDataFile();
 
     QCustom3DVolume *qptr();
 
@@ -68,6 +100,9 @@ public:
     QImage::Format m_textureFormat;
     QList<QRgb> m_colorTable;
     QList<uchar> *m_textureData;
+    QFile *m_textureDataFile;
+    const uchar *m_mappedTextureData;
+    qsizetype m_mappedTextureDataSize;
 
     float m_alphaMultiplier;
     bool m_preserveOpacity;
@@ -81,6 +116,7 @@ public:
     QVector3D m_sliceFrameThicknesses;
 
     QCustomVolumeDirtyBitField m_dirtyBitsVolume;
+    QCustomVolumeDirtyRegion m_dirtyRegion;
 
 private:
     int multipliedAlphaValue(int alpha);
@@ -347,6 +347,33 @@ QImage QSurface3DSeries::texture() const
     return dptrc()->m_texture;
 }
 
+/*!
+ * \since 6.5
+ *
+ * Replaces the contents of the surface texture with \a texture.
+ *
+ * Unlike setting the \l texture property, this function is meant for textures
+ * that change often, such as video frames. As long as the image size stays the
+ * same, the existing texture is updated in place and the data is streamed to
+ * the GPU without allocating a new texture. The image is not compared to the
+ * previous one, and textureChanged() is emitted on every call. An empty QImage
+ * clears the texture.
+ *
+ * \sa texture
+ */
+void QSurface3DSeries::updateTexture(const QImage &texture)
+{
+    if (texture.isNull()) {
+        setTexture(texture);
+        return;
+    }
+
+    dptr()->setTexture(texture, true);
+
+    emit textureChanged(texture);
+    dptr()->m_textureFile.clear();
+}
+
 /*!
  * \property QSurface3DSeries::textureFile
  *
@@ -545,11 +572,13 @@ void QSurface3DSeriesPrivate::setDrawMode(QSurface3DSeries::DrawFlags mode)
     }
 }
 
-void QSurface3DSeriesPrivate::setTexture(const QImage &texture)
+void QSurface3DSeriesPrivate::setTexture(const QImage &texture, bool streamed)
 {
     m_texture = texture;
-    if (static_cast<Surface3DController *>(m_controller))
-        static_cast<Surface3DController *>(m_controller)->updateSurfaceTexture(qptr());
+    if (static_cast<Surface3DController *>(m_controller)) {
+        static_cast<Surface3DController *>(m_controller)->updateSurfaceTexture(qptr(),
+                                                                              streamed);
+    }
 }
 
 void QSurface3DSeriesPrivate::setWireframeColor(const QColor &color)
@@ -53,6 +53,7 @@ public:
 
     void setTexture(const QImage &texture);
     QImage texture() const;
+    void updateTexture(const QImage &texture);
     void setTextureFile(const QString &filename);
     QString textureFile() const;
 
@@ -33,7 +33,7 @@ public:
     void setSelectedPoint(const QPoint &position);
     void setFlatShadingEnabled(bool enabled);
     void setDrawMode(QSurface3DSeries::DrawFlags mode);
-    void setTexture(const QImage &texture);
+    void setTexture(const QImage &texture, bool streamed = false);
     void setWireframeColor(const QColor &color);
 
 private:
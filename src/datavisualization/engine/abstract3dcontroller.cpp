@@ -42,6 +42,7 @@ Abstract3DController::Abstract3DController(QRect initialViewport, Q3DScene *scen
     m_isCustomItemDirty(true),
     m_isSeriesVisualsDirty(true),
     m_renderPending(false),
+    m_changedSinceRender(1),
     m_isPolar(false),
     m_radialLabelOffset(1.0f),
     m_measureFps(false),
@@ -61,6 +62,9 @@ Abstract3DController::Abstract3DController(QRect initialViewport, Q3DScene *scen
     defaultTheme->d_ptr->setDefaultTheme(true);
     setActiveTheme(defaultTheme);
 
+    // Until the graph is told the size of its window, the initial viewport is assumed to fill it
+    if (m_scene->d_ptr->windowSize().isEmpty())
+        m_scene->d_ptr->setWindowSize(initialViewport.size());
     m_scene->d_ptr->setViewport(initialViewport);
     m_scene->activeLight()->setAutoPosition(true);
 
@@ -516,6 +520,9 @@ void Abstract3DController::synchDataToRenderer()
 
 void Abstract3DController::render(const GLuint defaultFboHandle)
 {
+    // The lock only keeps the renderer alive while it renders. Data changes never take it, and
+    // the renderer converts data from the snapshots taken in synchDataToRenderer(), so the GUI
+    // thread can change the data while a frame is being rendered.
     QMutexLocker mutexLocker(&m_renderMutex);
 
     // If not initialized, do nothing.
@@ -533,10 +540,30 @@ void Abstract3DController::render(const GLuint defaultFboHandle)
             m_frameTimer.restart();
         }
         // To get meaningful framerate, don't just do render on demand.
-        emitNeedRender();
+        // This does not count as a change to the graph.
+        if (!m_renderPending) {
+            emit needRender();
+            m_renderPending = true;
+        }
+    }
+
+    // Let the renderer reuse what it has cached only when nothing was changed since the
+    // previous frame
+    const bool changed = m_changedSinceRender.fetchAndStoreOrdered(0);
+    if (changed) {
+        m_renderer->invalidateVolumeLayer();
+        m_renderer->invalidateFrameLayer();
     }
 
+    // When measuring, every frame must actually be rendered
+    if (!m_measureFps && m_renderer->drawFrameLayer())
+        return;
+
     m_renderer->render(defaultFboHandle);
+
+    // Only a frame that repeats the previous one is likely to be repeated again
+    if (!changed && !m_measureFps)
+        m_renderer->storeFrameLayer();
 }
 
 void Abstract3DController::mouseDoubleClickEvent(QMouseEvent *event)
@@ -976,7 +1003,11 @@ void Abstract3DController::markSeriesVisualsDirty()
 void Abstract3DController::requestRender(QOpenGLFramebufferObject *fbo)
 {
     QMutexLocker mutexLocker(&m_renderMutex);
+    // Images are always rendered at full quality, from the data synchronized for them
+    m_renderer->setProgressiveVolumeRendering(false);
+    m_renderer->invalidateVolumeLayer();
     m_renderer->render(fbo->handle());
+    m_renderer->setProgressiveVolumeRendering(true);
 }
 
 int Abstract3DController::addCustomItem(QCustom3DItem *item)
@@ -1483,6 +1514,7 @@ void Abstract3DController::startRecordingRemovesAndInserts()
 
 void Abstract3DController::emitNeedRender()
 {
+    m_changedSinceRender.storeRelease(1);
     if (!m_renderPending) {
         emit needRender();
         m_renderPending = true;
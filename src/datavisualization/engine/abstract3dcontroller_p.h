@@ -23,6 +23,7 @@
 #include "q3dscene_p.h"
 #include "qcustom3ditem.h"
 #include <QtGui/QLinearGradient>
+#include <QtCore/QAtomicInt>
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QLocale>
 #include <QtCore/QMutex>
@@ -182,6 +183,7 @@ protected:
     bool m_isCustomItemDirty;
     bool m_isSeriesVisualsDirty;
     bool m_renderPending;
+    QAtomicInt m_changedSinceRender; // Set on the GUI thread, consumed on the render thread
     bool m_isPolar;
     float m_radialLabelOffset;
 
@@ -11,9 +11,12 @@
 #include "qcustom3dlabel_p.h"
 #include "qcustom3dvolume_p.h"
 #include "scatter3drenderer_p.h"
+#include "assetpreparer_p.h"
+#include "meshcache_p.h"
 
 #include <QtCore/qmath.h>
 #include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLExtraFunctions>
 #include <QtCore/QThread>
 
 QT_BEGIN_NAMESPACE
@@ -38,9 +41,13 @@ Abstract3DRenderer::Abstract3DRenderer(Abstract3DController *controller)
       m_cachedOptimizationHint(QAbstract3DGraph::OptimizationDefault),
       m_textureHelper(0),
       m_depthTexture(0),
+      m_shadowMapDirty(true),
+      m_shadowMapYFlipped(false),
+      m_shadowMapReflectionEnabled(false),
       m_cachedScene(new Q3DScene()),
       m_selectionDirty(true),
       m_selectionState(SelectNone),
+      m_assetPreparer(new AssetPreparer()),
       m_devicePixelRatio(1.0f),
       m_selectionLabelDirty(true),
       m_clickResolved(false),
@@ -61,6 +68,27 @@ Abstract3DRenderer::Abstract3DRenderer(Abstract3DController *controller)
       m_cursorPositionShader(0),
       m_cursorPositionFrameBuffer(0),
       m_cursorPositionTexture(0),
+      m_volumeLayerTexture(0),
+      m_volumeLayerFrameBuffer(0),
+      m_volumeLayerDepthBuffer(0),
+      m_volumeLayerSupported(true),
+      m_volumeLayerValid(false),
+      m_progressiveVolumes(true),
+      m_volumeInteraction(false),
+      m_frameLayerTexture(0),
+      m_frameLayerFrameBuffer(0),
+      m_frameLayerSupported(true),
+      m_frameLayerValid(false),
+      m_backgroundLayerFrameBuffer(0),
+      m_backgroundLayerColorBuffer(0),
+      m_backgroundLayerDepthBuffer(0),
+      m_backgroundLayerSupported(true),
+      m_backgroundLayerValid(false),
+      m_targetFrameBuffer(-1),
+      m_targetDepthFormat(0),
+      m_targetHasStencil(false),
+      m_targetHasAlpha(true),
+      m_targetSamples(0),
       m_useOrthoProjection(false),
       m_xFlipped(false),
       m_yFlipped(false),
@@ -96,7 +124,8 @@ Abstract3DRenderer::Abstract3DRenderer(Abstract3DController *controller)
       m_funcs_2_1(0),
 #endif
       m_context(0),
-      m_isOpenGLES(true)
+      m_isOpenGLES(true),
+      m_defaultFboHandle(0)
 
 {
     initializeOpenGLFunctions();
@@ -118,8 +147,12 @@ Abstract3DRenderer::Abstract3DRenderer(Abstract3DController *controller)
     }
 #endif
     QObject::connect(m_drawer, &Drawer::drawerChanged, this, &Abstract3DRenderer::updateTextures);
+    // Whatever the renderer needs another pass for also makes its cached frame stale
     QObject::connect(this, &Abstract3DRenderer::needRender, controller,
-                     &Abstract3DController::needRender, Qt::QueuedConnection);
+                     &Abstract3DController::emitNeedRender, Qt::QueuedConnection);
+    // Emitted from worker threads, hence the direct connection to the queued needRender
+    QObject::connect(m_assetPreparer, &AssetPreparer::assetReady, this,
+                     &Abstract3DRenderer::needRender, Qt::DirectConnection);
     QObject::connect(this, &Abstract3DRenderer::requestShadowQuality, controller,
                      &Abstract3DController::handleRequestShadowQuality, Qt::QueuedConnection);
 }
@@ -145,21 +178,24 @@ Abstract3DRenderer::~Abstract3DRenderer()
     }
     m_renderCacheList.clear();
 
-    foreach (CustomRenderItem *item, m_customRenderCache) {
-        GLuint texture = item->texture();
-        m_textureHelper->deleteTexture(&texture);
-        delete item;
-    }
+    // Delete the preparer first, so that late results are no longer reported
+    delete m_assetPreparer;
+    m_assetPreparer = 0;
+
+    foreach (CustomRenderItem *item, m_customRenderCache)
+        releaseCustomItem(item);
     m_customRenderCache.clear();
 
-    ObjectHelper::releaseObjectHelper(this, m_backgroundObj);
-    ObjectHelper::releaseObjectHelper(this, m_gridLineObj);
-    ObjectHelper::releaseObjectHelper(this, m_labelObj);
-    ObjectHelper::releaseObjectHelper(this, m_positionMapperObj);
+    ObjectHelper::releaseObjectHelper(m_backgroundObj);
+    ObjectHelper::releaseObjectHelper(m_gridLineObj);
+    ObjectHelper::releaseObjectHelper(m_labelObj);
+    ObjectHelper::releaseObjectHelper(m_positionMapperObj);
 
     if (m_textureHelper) {
         m_textureHelper->deleteTexture(&m_depthTexture);
         m_textureHelper->deleteTexture(&m_cursorPositionTexture);
+        m_textureHelper->deleteTexture(&m_volumeLayerTexture);
+        m_textureHelper->deleteTexture(&m_frameLayerTexture);
         delete m_textureHelper;
     }
 
@@ -174,8 +210,28 @@ Abstract3DRenderer::~Abstract3DRenderer()
 
 void Abstract3DRenderer::contextCleanup()
 {
-    if (QOpenGLContext::currentContext())
+    if (QOpenGLContext::currentContext()) {
         m_textureHelper->glDeleteFramebuffers(1, &m_cursorPositionFrameBuffer);
+        m_textureHelper->glDeleteFramebuffers(1, &m_volumeLayerFrameBuffer);
+        m_textureHelper->glDeleteRenderbuffers(1, &m_volumeLayerDepthBuffer);
+        m_textureHelper->glDeleteFramebuffers(1, &m_frameLayerFrameBuffer);
+        m_textureHelper->glDeleteFramebuffers(1, &m_backgroundLayerFrameBuffer);
+        m_textureHelper->glDeleteRenderbuffers(1, &m_backgroundLayerColorBuffer);
+        m_textureHelper->glDeleteRenderbuffers(1, &m_backgroundLayerDepthBuffer);
+    }
+    m_volumeLayerFrameBuffer = 0;
+    m_volumeLayerDepthBuffer = 0;
+    m_volumeLayerSize = QSize();
+    m_volumeLayerValid = false;
+    m_frameLayerFrameBuffer = 0;
+    m_frameLayerSize = QSize();
+    m_frameLayerValid = false;
+    m_backgroundLayerFrameBuffer = 0;
+    m_backgroundLayerColorBuffer = 0;
+    m_backgroundLayerDepthBuffer = 0;
+    m_backgroundLayerSize = QSize();
+    m_backgroundLayerValid = false;
+    m_targetFrameBuffer = -1;
 }
 
 void Abstract3DRenderer::initializeOpenGL()
@@ -199,6 +255,11 @@ void Abstract3DRenderer::initializeOpenGL()
     m_textureHelper = new TextureHelper();
     m_drawer->initializeOpenGL();
 
+    // The offscreen layers copy between framebuffers, which GL 2.1 only has as an extension
+    m_volumeLayerSupported = hasOpenGLFeature(QOpenGLFunctions::FramebufferBlit);
+    m_frameLayerSupported = m_volumeLayerSupported;
+    m_backgroundLayerSupported = m_volumeLayerSupported;
+
     axisCacheForOrientation(QAbstract3DAxis::AxisOrientationX).setDrawer(m_drawer);
     axisCacheForOrientation(QAbstract3DAxis::AxisOrientationY).setDrawer(m_drawer);
     axisCacheForOrientation(QAbstract3DAxis::AxisOrientationZ).setDrawer(m_drawer);
@@ -218,6 +279,10 @@ void Abstract3DRenderer::initializeOpenGL()
 
 void Abstract3DRenderer::render(const GLuint defaultFboHandle)
 {
+    m_defaultFboHandle = defaultFboHandle;
+    updateTargetFormat();
+    updatePreparedAssets();
+
     if (defaultFboHandle) {
         glDepthMask(true);
         glEnable(GL_DEPTH_TEST);
@@ -280,20 +345,24 @@ void Abstract3DRenderer::initVolumeTextureShaders(const QString &vertexShader,
                                                   const QString &fragmentShader,
                                                   const QString &fragmentLowDefShader,
                                                   const QString &sliceShader,
+                                                  const QString &colorShader,
                                                   const QString &sliceFrameVertexShader,
                                                   const QString &sliceFrameShader)
 {
 
     delete m_volumeTextureShader;
     m_volumeTextureShader = new ShaderHelper(this, vertexShader, fragmentShader);
+    m_volumeTextureShader->addFragmentShader(colorShader);
     m_volumeTextureShader->initialize();
 
     delete m_volumeTextureLowDefShader;
     m_volumeTextureLowDefShader = new ShaderHelper(this, vertexShader, fragmentLowDefShader);
+    m_volumeTextureLowDefShader->addFragmentShader(colorShader);
     m_volumeTextureLowDefShader->initialize();
 
     delete m_volumeTextureSliceShader;
     m_volumeTextureSliceShader = new ShaderHelper(this, vertexShader, sliceShader);
+    m_volumeTextureSliceShader->addFragmentShader(colorShader);
     m_volumeTextureSliceShader->initialize();
 
     delete m_volumeSliceFrameShader;
@@ -319,6 +388,13 @@ void Abstract3DRenderer::initCursorPositionShaders(const QString &vertexShader,
 
 void Abstract3DRenderer::initCursorPositionBuffer()
 {
+    // Positions are drawn to the bottom left corner, so a larger buffer can be kept
+    if (m_cursorPositionTexture && !m_primarySubViewport.size().isEmpty()
+            && TextureHelper::framebufferFits(m_cursorPositionBufferSize,
+                                              m_primarySubViewport.size())) {
+        return;
+    }
+
     m_textureHelper->deleteTexture(&m_cursorPositionTexture);
     m_textureHelper->glDeleteFramebuffers(1, &m_cursorPositionFrameBuffer);
     m_cursorPositionFrameBuffer = 0;
@@ -326,13 +402,27 @@ void Abstract3DRenderer::initCursorPositionBuffer()
     if (m_primarySubViewport.size().isEmpty())
         return;
 
+    m_cursorPositionBufferSize = TextureHelper::framebufferBucketSize(m_primarySubViewport.size());
     m_cursorPositionTexture =
-            m_textureHelper->createCursorPositionTexture(m_primarySubViewport.size(),
+            m_textureHelper->createCursorPositionTexture(m_cursorPositionBufferSize,
                                                          m_cursorPositionFrameBuffer);
 }
 
 void Abstract3DRenderer::updateTheme(Q3DTheme *theme)
 {
+    // Background visibility affects which bars cast shadows
+    if (theme->d_ptr->m_dirtyBits.backgroundEnabledDirty)
+        m_shadowMapDirty = true;
+
+    // The stored background and grid are drawn with these
+    const Q3DThemeDirtyBitField &dirtyBits = theme->d_ptr->m_dirtyBits;
+    if (dirtyBits.backgroundEnabledDirty || dirtyBits.backgroundColorDirty
+            || dirtyBits.gridEnabledDirty || dirtyBits.gridLineColorDirty
+            || dirtyBits.lightColorDirty || dirtyBits.lightStrengthDirty
+            || dirtyBits.ambientLightStrengthDirty) {
+        invalidateBackgroundLayer();
+    }
+
     // Synchronize the controller theme with renderer
     bool updateDrawer = theme->d_ptr->sync(*m_cachedTheme->d_ptr);
 
@@ -365,7 +455,12 @@ void Abstract3DRenderer::updateScene(Q3DScene *scene)
                                   logicalGraphPosition.y() * m_devicePixelRatio);
 
     // Synchronize the renderer scene to controller scene
+    QVector3D oldLightPos = m_cachedScene->activeLight()->position();
     scene->d_ptr->sync(*m_cachedScene->d_ptr);
+    if (oldLightPos != m_cachedScene->activeLight()->position()) {
+        m_shadowMapDirty = true;
+        invalidateBackgroundLayer();
+    }
 
     updateCameraViewport();
 
@@ -451,6 +546,7 @@ void Abstract3DRenderer::reInitShaders()
                                  QStringLiteral(":/shaders/fragmentTexture3D"),
                                  QStringLiteral(":/shaders/fragmentTexture3DLowDef"),
                                  QStringLiteral(":/shaders/fragmentTexture3DSlice"),
+                                 QStringLiteral(":/shaders/fragmentTexture3DColor"),
                                  QStringLiteral(":/shaders/vertexPosition"),
                                  QStringLiteral(":/shaders/fragment3DSliceFrames"));
     } else  {
@@ -479,7 +575,9 @@ void Abstract3DRenderer::reInitShaders()
 
 void Abstract3DRenderer::handleShadowQualityChange()
 {
+    invalidateBackgroundLayer();
     reInitShaders();
+    m_shadowMapDirty = true;
 
     if (m_cachedScene->activeLight()->isAutoPosition()
             || m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
@@ -501,23 +599,29 @@ void Abstract3DRenderer::updateSelectionMode(QAbstract3DGraph::SelectionFlags mo
 
 void Abstract3DRenderer::updateAspectRatio(float ratio)
 {
+    invalidateBackgroundLayer();
     m_graphAspectRatio = ratio;
     foreach (SeriesRenderCache *cache, m_renderCacheList)
         cache->setDataDirty(true);
+    m_shadowMapDirty = true;
 }
 
 void Abstract3DRenderer::updateHorizontalAspectRatio(float ratio)
 {
+    invalidateBackgroundLayer();
     m_graphHorizontalAspectRatio = ratio;
     foreach (SeriesRenderCache *cache, m_renderCacheList)
         cache->setDataDirty(true);
+    m_shadowMapDirty = true;
 }
 
 void Abstract3DRenderer::updatePolar(bool enable)
 {
+    invalidateBackgroundLayer();
     m_polarGraph = enable;
     foreach (SeriesRenderCache *cache, m_renderCacheList)
         cache->setDataDirty(true);
+    m_shadowMapDirty = true;
 }
 
 void Abstract3DRenderer::updateRadialLabelOffset(float offset)
@@ -527,7 +631,9 @@ void Abstract3DRenderer::updateRadialLabelOffset(float offset)
 
 void Abstract3DRenderer::updateMargin(float margin)
 {
+    invalidateBackgroundLayer();
     m_requestedMargin = margin;
+    m_shadowMapDirty = true;
 }
 
 void Abstract3DRenderer::updateOptimizationHint(QAbstract3DGraph::OptimizationHints hint)
@@ -535,6 +641,7 @@ void Abstract3DRenderer::updateOptimizationHint(QAbstract3DGraph::OptimizationHi
     m_cachedOptimizationHint = hint;
     foreach (SeriesRenderCache *cache, m_renderCacheList)
         cache->setDataDirty(true);
+    m_shadowMapDirty = true;
 }
 
 void Abstract3DRenderer::handleResize()
@@ -569,6 +676,7 @@ void Abstract3DRenderer::calculateZoomLevel()
 void Abstract3DRenderer::updateAxisType(QAbstract3DAxis::AxisOrientation orientation,
                                         QAbstract3DAxis::AxisType type)
 {
+    invalidateBackgroundLayer();
     axisCacheForOrientation(orientation).setType(type);
 }
 
@@ -581,23 +689,27 @@ void Abstract3DRenderer::updateAxisTitle(QAbstract3DAxis::AxisOrientation orient
 void Abstract3DRenderer::updateAxisLabels(QAbstract3DAxis::AxisOrientation orientation,
                                           const QStringList &labels)
 {
+    invalidateBackgroundLayer();
     axisCacheForOrientation(orientation).setLabels(labels);
 }
 
 void Abstract3DRenderer::updateAxisRange(QAbstract3DAxis::AxisOrientation orientation,
                                          float min, float max)
 {
+    invalidateBackgroundLayer();
     AxisRenderCache &cache = axisCacheForOrientation(orientation);
     cache.setMin(min);
     cache.setMax(max);
 
     foreach (SeriesRenderCache *cache, m_renderCacheList)
         cache->setDataDirty(true);
+    m_shadowMapDirty = true;
 }
 
 void Abstract3DRenderer::updateAxisSegmentCount(QAbstract3DAxis::AxisOrientation orientation,
                                                 int count)
 {
+    invalidateBackgroundLayer();
     AxisRenderCache &cache = axisCacheForOrientation(orientation);
     cache.setSegmentCount(count);
 }
@@ -605,6 +717,7 @@ void Abstract3DRenderer::updateAxisSegmentCount(QAbstract3DAxis::AxisOrientation
 void Abstract3DRenderer::updateAxisSubSegmentCount(QAbstract3DAxis::AxisOrientation orientation,
                                                    int count)
 {
+    invalidateBackgroundLayer();
     AxisRenderCache &cache = axisCacheForOrientation(orientation);
     cache.setSubSegmentCount(count);
 }
@@ -618,14 +731,17 @@ void Abstract3DRenderer::updateAxisLabelFormat(QAbstract3DAxis::AxisOrientation
 void Abstract3DRenderer::updateAxisReversed(QAbstract3DAxis::AxisOrientation orientation,
                                             bool enable)
 {
+    invalidateBackgroundLayer();
     axisCacheForOrientation(orientation).setReversed(enable);
     foreach (SeriesRenderCache *cache, m_renderCacheList)
         cache->setDataDirty(true);
+    m_shadowMapDirty = true;
 }
 
 void Abstract3DRenderer::updateAxisFormatter(QAbstract3DAxis::AxisOrientation orientation,
                                              QValue3DAxisFormatter *formatter)
 {
+    invalidateBackgroundLayer();
     AxisRenderCache &cache = axisCacheForOrientation(orientation);
     if (cache.ctrlFormatter() != formatter) {
         delete cache.formatter();
@@ -637,6 +753,7 @@ void Abstract3DRenderer::updateAxisFormatter(QAbstract3DAxis::AxisOrientation or
 
     foreach (SeriesRenderCache *cache, m_renderCacheList)
         cache->setDataDirty(true);
+    m_shadowMapDirty = true;
 }
 
 void Abstract3DRenderer::updateAxisLabelAutoRotation(QAbstract3DAxis::AxisOrientation orientation,
@@ -681,6 +798,7 @@ void Abstract3DRenderer::fixMeshFileName(QString &fileName, QAbstract3DSeries::M
 
 void Abstract3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesList)
 {
+    invalidateBackgroundLayer();
     foreach (SeriesRenderCache *cache, m_renderCacheList)
         cache->setValid(false);
 
@@ -706,6 +824,8 @@ void Abstract3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesLi
         if (!cache->isValid())
             cleanCache(cache);
     }
+
+    m_shadowMapDirty = true;
 }
 
 void Abstract3DRenderer::updateCustomData(const QList<QCustom3DItem *> &customItems)
@@ -731,14 +851,13 @@ void Abstract3DRenderer::updateCustomData(const QList<QCustom3DItem *> &customIt
     foreach (CustomRenderItem *renderItem, m_customRenderCache) {
         if (!renderItem->isValid()) {
             m_customRenderCache.remove(renderItem->itemPointer());
-            GLuint texture = renderItem->texture();
-            m_textureHelper->deleteTexture(&texture);
-            delete renderItem;
+            releaseCustomItem(renderItem);
         }
     }
 
     m_customItemDrawOrder.clear();
     m_customItemDrawOrder = QList<QCustom3DItem *>(customItems);
+    m_shadowMapDirty = true;
 }
 
 void Abstract3DRenderer::updateCustomItems()
@@ -746,6 +865,7 @@ void Abstract3DRenderer::updateCustomItems()
     // Check all items
     foreach (CustomRenderItem *item, m_customRenderCache)
         updateCustomItem(item);
+    m_shadowMapDirty = true;
 }
 
 SeriesRenderCache *Abstract3DRenderer::createNewCache(QAbstract3DSeries *series)
@@ -1060,38 +1180,35 @@ void Abstract3DRenderer::drawAxisTitleZ(const QVector3D &labelRotation,
 
 void Abstract3DRenderer::loadGridLineMesh()
 {
-    ObjectHelper::resetObjectHelper(this, m_gridLineObj,
+    ObjectHelper::resetObjectHelper(m_gridLineObj,
                                     QStringLiteral(":/defaultMeshes/plane"));
 }
 
 void Abstract3DRenderer::loadLabelMesh()
 {
-    ObjectHelper::resetObjectHelper(this, m_labelObj,
+    ObjectHelper::resetObjectHelper(m_labelObj,
                                     QStringLiteral(":/defaultMeshes/plane"));
 }
 
 void Abstract3DRenderer::loadPositionMapperMesh()
 {
-    ObjectHelper::resetObjectHelper(this, m_positionMapperObj,
+    ObjectHelper::resetObjectHelper(m_positionMapperObj,
                                     QStringLiteral(":/defaultMeshes/barFull"));
 }
 
-void Abstract3DRenderer::generateBaseColorTexture(const QColor &color, GLuint *texture)
+void Abstract3DRenderer::generateBaseColorTexture(const QColor &color, SharedTexture *&texture)
 {
-    m_textureHelper->deleteTexture(texture);
-    *texture = m_textureHelper->createUniformTexture(color);
+    SharedTexture::resetUniformTexture(texture, m_textureHelper, color);
 }
 
 void Abstract3DRenderer::fixGradientAndGenerateTexture(QLinearGradient *gradient,
-                                                       GLuint *gradientTexture)
+                                                       SharedTexture *&gradientTexture)
 {
     // Readjust start/stop to match gradient texture size
     gradient->setStart(qreal(gradientTextureWidth), qreal(gradientTextureHeight));
     gradient->setFinalStop(0.0, 0.0);
 
-    m_textureHelper->deleteTexture(gradientTexture);
-
-    *gradientTexture = m_textureHelper->createGradientTexture(*gradient);
+    SharedTexture::resetGradientTexture(gradientTexture, m_textureHelper, *gradient);
 }
 
 LabelItem &Abstract3DRenderer::selectionLabelItem()
@@ -1162,16 +1279,13 @@ CustomRenderItem *Abstract3DRenderer::addCustomItem(QCustom3DItem *item)
         newItem->setTextureWidth(volumeItem->textureWidth());
         newItem->setTextureHeight(volumeItem->textureHeight());
         newItem->setTextureDepth(volumeItem->textureDepth());
-        if (volumeItem->textureFormat() == QImage::Format_Indexed8)
-            newItem->setColorTable(volumeItem->colorTable());
+        if (QCustom3DVolumePrivate::usesColorTable(volumeItem->textureFormat()))
+            newItem->setColorTable(volumeItem->dptr()->renderColorTable());
         newItem->setTextureFormat(volumeItem->textureFormat());
         newItem->setVolume(true);
         newItem->setBlendNeeded(true);
-        texture = m_textureHelper->create3DTexture(volumeItem->textureData(),
-                                                   volumeItem->textureWidth(),
-                                                   volumeItem->textureHeight(),
-                                                   volumeItem->textureDepth(),
-                                                   volumeItem->textureFormat());
+        texture = createVolumeTexture(volumeItem);
+        updateVolumeOccupancy(newItem, volumeItem, true, QCustomVolumeDirtyRegion());
         newItem->setSliceIndexX(volumeItem->sliceIndexX());
         newItem->setSliceIndexY(volumeItem->sliceIndexY());
         newItem->setSliceIndexZ(volumeItem->sliceIndexZ());
@@ -1272,11 +1386,128 @@ void Abstract3DRenderer::recalculateCustomItemScalingAndPos(CustomRenderItem *it
     item->setTranslation(translation);
 }
 
+void Abstract3DRenderer::updatePreparedAssets()
+{
+    const QList<AssetPreparer::PreparedTexture> textures =
+            m_assetPreparer->takePreparedTextures();
+    foreach (const AssetPreparer::PreparedTexture &prepared, textures) {
+        CustomRenderItem *renderItem = prepared.item;
+        if (prepared.streamed) {
+            renderItem->setTexture(
+                        m_textureHelper->updatePrepared2DTexture(renderItem->texture(),
+                                                                 prepared.image,
+                                                                 renderItem->textureStream(),
+                                                                 true, true, false));
+        } else {
+            GLuint oldTexture = renderItem->texture();
+            m_textureHelper->deleteTexture(&oldTexture);
+            m_textureHelper->deleteTextureStream(renderItem->textureStream());
+            renderItem->setTexture(m_textureHelper->createPrepared2DTexture(prepared.image, true,
+                                                                             true, false));
+            // Lets the first update stream into the new texture
+            renderItem->textureStream().size = prepared.image.size();
+        }
+        renderItem->setBlendNeeded(prepared.blendNeeded);
+    }
+
+    const QList<AssetPreparer::PreparedMesh> meshes = m_assetPreparer->takePreparedMeshes();
+    foreach (const AssetPreparer::PreparedMesh &prepared, meshes)
+        prepared.item->setMesh(prepared.meshFile);
+
+    if (!meshes.isEmpty())
+        m_shadowMapDirty = true;
+    // New assets may occlude the volumes differently
+    if (!textures.isEmpty() || !meshes.isEmpty())
+        m_volumeLayerValid = false;
+}
+
+void Abstract3DRenderer::releaseCustomItem(CustomRenderItem *item)
+{
+    if (m_assetPreparer)
+        m_assetPreparer->cancel(item);
+    GLuint texture = item->texture();
+    m_textureHelper->deleteTexture(&texture);
+    m_textureHelper->deleteTextureStream(item->textureStream());
+    texture = item->occupancyTexture();
+    m_textureHelper->deleteTexture(&texture);
+    delete item;
+}
+
+// Size of the parts in which volume data mapped from a file is uploaded
+static const qsizetype volumeUploadSlabSize = 16 * 1024 * 1024;
+
+GLuint Abstract3DRenderer::createVolumeTexture(QCustom3DVolume *volumeItem)
+{
+    const uchar *bits = volumeItem->dptr()->textureBits();
+    if (!volumeItem->dptr()->isTextureDataMapped() || !bits) {
+        return m_textureHelper->create3DTexture(bits, volumeItem->textureWidth(),
+                                                volumeItem->textureHeight(),
+                                                volumeItem->textureDepth(),
+                                                volumeItem->textureFormat());
+    }
+
+    // Upload mapped data in slabs of frames, so that the file is paged in sequentially and
+    // the driver does not stage a copy of the whole volume. The texture itself still holds it.
+    GLuint texture = m_textureHelper->create3DTexture(0, volumeItem->textureWidth(),
+                                                      volumeItem->textureHeight(),
+                                                      volumeItem->textureDepth(),
+                                                      volumeItem->textureFormat());
+    qsizetype frameSize = qsizetype(volumeItem->textureDataWidth()) * volumeItem->textureHeight();
+    int slabDepth = int(qBound(qsizetype(1), volumeUploadSlabSize / frameSize,
+                               qsizetype(volumeItem->textureDepth())));
+    for (int z = 0; z < volumeItem->textureDepth(); z += slabDepth) {
+        m_textureHelper->update3DTexture(texture, bits, volumeItem->textureWidth(),
+                                         volumeItem->textureHeight(),
+                                         volumeItem->textureDepth(),
+                                         volumeItem->textureFormat(), 0, 0, z,
+                                         volumeItem->textureWidth(),
+                                         volumeItem->textureHeight(),
+                                         qMin(slabDepth, volumeItem->textureDepth() - z));
+    }
+    return texture;
+}
+
+void Abstract3DRenderer::updateVolumeOccupancy(CustomRenderItem *renderItem,
+                                               QCustom3DVolume *volumeItem, bool fullScan,
+                                               const QCustomVolumeDirtyRegion &region)
+{
+    if (fullScan) {
+        renderItem->scanOccupancy(volumeItem->dptr()->textureBits(),
+                                  volumeItem->dptr()->textureBitsSize(),
+                                  volumeItem->textureDataWidth(),
+                                  0, 0, 0, volumeItem->textureWidth(),
+                                  volumeItem->textureHeight(), volumeItem->textureDepth());
+    } else if (!region.isEmpty()) {
+        renderItem->scanOccupancy(volumeItem->dptr()->textureBits(),
+                                  volumeItem->dptr()->textureBitsSize(),
+                                  volumeItem->textureDataWidth(),
+                                  region.x, region.y, region.z,
+                                  region.width, region.height, region.depth);
+    }
+    renderItem->classifyOccupancy();
+
+    // The grid is small, so it is simply recreated
+    GLuint texture = renderItem->occupancyTexture();
+    m_textureHelper->deleteTexture(&texture);
+    texture = m_textureHelper->create3DTexture(renderItem->occupancy().constData(),
+                                               renderItem->brickGridWidth(),
+                                               renderItem->brickGridHeight(),
+                                               renderItem->brickGridDepth(),
+                                               QImage::Format_Grayscale8);
+    renderItem->setOccupancyTexture(texture);
+}
+
 void Abstract3DRenderer::updateCustomItem(CustomRenderItem *renderItem)
 {
     QCustom3DItem *item = renderItem->itemPointer();
     if (item->d_ptr->m_dirtyBits.meshDirty) {
-        renderItem->setMesh(item->meshFile());
+        // Meshes that are not cached yet are loaded in the background, the item keeps its
+        // old mesh until then
+        const QString meshFile = item->meshFile();
+        if (meshFile.isEmpty() || MeshCache::isCached(meshFile))
+            renderItem->setMesh(meshFile);
+        else
+            m_assetPreparer->prepareMesh(renderItem, meshFile);
         item->d_ptr->m_dirtyBits.meshDirty = false;
     }
     if (item->d_ptr->m_dirtyBits.positionDirty) {
@@ -1335,14 +1566,23 @@ void Abstract3DRenderer::updateCustomItem(CustomRenderItem *renderItem)
                 textureImage = item->d_ptr->textureImage();
             }
         } else if (!item->d_ptr->m_isVolumeItem || m_isOpenGLES) {
-            renderItem->setBlendNeeded(textureImage.hasAlphaChannel());
-            GLuint oldTexture = renderItem->texture();
-            m_textureHelper->deleteTexture(&oldTexture);
-            GLuint texture = m_textureHelper->create2DTexture(textureImage, true, true, true);
-            renderItem->setTexture(texture);
+            if (textureImage.isNull()) {
+                m_assetPreparer->cancel(renderItem);
+                GLuint oldTexture = renderItem->texture();
+                m_textureHelper->deleteTexture(&oldTexture);
+                m_textureHelper->deleteTextureStream(renderItem->textureStream());
+                renderItem->setTexture(0);
+                renderItem->setBlendNeeded(false);
+            } else {
+                // The conversion is done in the background, the item keeps its old texture
+                // until the new one is uploaded in updatePreparedAssets()
+                m_assetPreparer->prepareTexture(renderItem, textureImage, m_isOpenGLES,
+                                                item->d_ptr->m_dirtyBits.textureStreamed);
+            }
         }
         item->d_ptr->clearTextureImage();
         item->d_ptr->m_dirtyBits.textureDirty = false;
+        item->d_ptr->m_dirtyBits.textureStreamed = false;
     }
     if (item->d_ptr->m_dirtyBits.visibleDirty) {
         renderItem->setVisible(item->isVisible());
@@ -1360,28 +1600,55 @@ void Abstract3DRenderer::updateCustomItem(CustomRenderItem *renderItem)
         }
     } else if (item->d_ptr->m_isVolumeItem && !m_isOpenGLES) {
         QCustom3DVolume *volumeItem = static_cast<QCustom3DVolume *>(item);
-        if (volumeItem->dptr()->m_dirtyBitsVolume.colorTableDirty) {
-            renderItem->setColorTable(volumeItem->colorTable());
+        bool colorTableChanged = false;
+        if (volumeItem->dptr()->m_dirtyBitsVolume.colorTableDirty
+                || volumeItem->dptr()->m_dirtyBitsVolume.textureFormatDirty) {
+            renderItem->setColorTable(volumeItem->dptr()->renderColorTable());
             volumeItem->dptr()->m_dirtyBitsVolume.colorTableDirty = false;
+            colorTableChanged = true;
         }
         if (volumeItem->dptr()->m_dirtyBitsVolume.textureDimensionsDirty
                 || volumeItem->dptr()->m_dirtyBitsVolume.textureDataDirty
                 || volumeItem->dptr()->m_dirtyBitsVolume.textureFormatDirty) {
             GLuint oldTexture = renderItem->texture();
             m_textureHelper->deleteTexture(&oldTexture);
-            GLuint texture = m_textureHelper->create3DTexture(volumeItem->textureData(),
-                                                              volumeItem->textureWidth(),
-                                                              volumeItem->textureHeight(),
-                                                              volumeItem->textureDepth(),
-                                                              volumeItem->textureFormat());
+            GLuint texture = createVolumeTexture(volumeItem);
             renderItem->setTexture(texture);
             renderItem->setTextureWidth(volumeItem->textureWidth());
             renderItem->setTextureHeight(volumeItem->textureHeight());
             renderItem->setTextureDepth(volumeItem->textureDepth());
             renderItem->setTextureFormat(volumeItem->textureFormat());
+            updateVolumeOccupancy(renderItem, volumeItem, true, QCustomVolumeDirtyRegion());
             volumeItem->dptr()->m_dirtyBitsVolume.textureDimensionsDirty = false;
             volumeItem->dptr()->m_dirtyBitsVolume.textureDataDirty = false;
+            volumeItem->dptr()->m_dirtyBitsVolume.subTextureDataDirty = false;
             volumeItem->dptr()->m_dirtyBitsVolume.textureFormatDirty = false;
+            volumeItem->dptr()->m_dirtyRegion = QCustomVolumeDirtyRegion();
+        } else if (volumeItem->dptr()->m_dirtyBitsVolume.subTextureDataDirty) {
+            // All sub texture changes since the last sync are uploaded as a single box
+            const QCustomVolumeDirtyRegion &region = volumeItem->dptr()->m_dirtyRegion;
+            if (!region.isEmpty()) {
+                m_textureHelper->update3DTexture(renderItem->texture(),
+                                                 volumeItem->dptr()->textureBits(),
+                                                 volumeItem->textureWidth(),
+                                                 volumeItem->textureHeight(),
+                                                 volumeItem->textureDepth(),
+                                                 volumeItem->textureFormat(),
+                                                 region.x, region.y, region.z,
+                                                 region.width, region.height, region.depth);
+            }
+            // Indexed bricks are scanned through the color table, so a table change needs
+            // a full rescan
+            if (colorTableChanged && volumeItem->textureFormat() == QImage::Format_Indexed8)
+                updateVolumeOccupancy(renderItem, volumeItem, true, QCustomVolumeDirtyRegion());
+            else
+                updateVolumeOccupancy(renderItem, volumeItem, false, region);
+            volumeItem->dptr()->m_dirtyBitsVolume.subTextureDataDirty = false;
+            volumeItem->dptr()->m_dirtyRegion = QCustomVolumeDirtyRegion();
+        } else if (colorTableChanged) {
+            updateVolumeOccupancy(renderItem, volumeItem,
+                                  volumeItem->textureFormat() == QImage::Format_Indexed8,
+                                  QCustomVolumeDirtyRegion());
         }
         if (volumeItem->dptr()->m_dirtyBitsVolume.slicesDirty) {
             renderItem->setDrawSlices(volumeItem->drawSlices());
@@ -1411,6 +1678,7 @@ void Abstract3DRenderer::updateCustomItemPositions()
 {
     foreach (CustomRenderItem *renderItem, m_customRenderCache)
         recalculateCustomItemScalingAndPos(renderItem);
+    m_shadowMapDirty = true;
 }
 
 void Abstract3DRenderer::drawCustomItems(RenderingState state,
@@ -1438,8 +1706,17 @@ void Abstract3DRenderer::drawCustomItems(RenderingState state,
 
     // Draw custom items - first regular and then volumes
     bool volumeDetected = false;
+    bool volumeLayerActive = false;
     int loopCount = 0;
     while (loopCount < 2) {
+        if (loopCount == 1 && RenderingNormal == state) {
+            bool cachedLayer = false;
+            volumeLayerActive = beginVolumeLayer(projectionViewMatrix, cachedLayer);
+            if (cachedLayer) {
+                drawVolumeLayer();
+                break;
+            }
+        }
         for (QCustom3DItem *customItem : qAsConst(m_customItemDrawOrder)) {
             CustomRenderItem *item = m_customRenderCache.value(customItem);
             // Check that the render item is visible, and skip drawing if not
@@ -1525,7 +1802,7 @@ void Abstract3DRenderer::drawCustomItems(RenderingState state,
                              || item->sliceIndexY() >= 0
                              || item->sliceIndexZ() >= 0)) {
                         shader = m_volumeTextureSliceShader;
-                    } else if (item->useHighDefShader()) {
+                    } else if (item->useHighDefShader() && !m_volumeInteraction) {
                         shader = m_volumeTextureShader;
                     } else {
                         shader = m_volumeTextureLowDefShader;
@@ -1543,7 +1820,14 @@ void Abstract3DRenderer::drawCustomItems(RenderingState state,
 
                 if (item->isBlendNeeded()) {
                     glEnable(GL_BLEND);
-                    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                    if (volumeLayerActive) {
+                        // Accumulate coverage in the layer alpha, the layer is composited
+                        // as premultiplied color
+                        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
+                                            GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+                    } else {
+                        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                    }
                     if (!item->isVolume() && !m_isOpenGLES)
                         glDisable(GL_CULL_FACE);
                 } else {
@@ -1568,7 +1852,12 @@ void Abstract3DRenderer::drawCustomItems(RenderingState state,
                                       + ((oneVector - cameraPos) * item->minBoundsNormal())
                                       - ((oneVector + cameraPos) * (oneVector - item->maxBoundsNormal())));
                         shader->setUniformValue(shader->cameraPositionRelativeToModel(), cameraPos);
-                        GLint color8Bit = (item->textureFormat() == QImage::Format_Indexed8) ? 1 : 0;
+                        // Single channel formats interpolate between color table entries
+                        GLint color8Bit = 0;
+                        if (item->textureFormat() == QImage::Format_Indexed8)
+                            color8Bit = 1;
+                        else if (QCustom3DVolumePrivate::usesColorTable(item->textureFormat()))
+                            color8Bit = 2;
                         if (color8Bit) {
                             shader->setUniformValueArray(shader->colorIndex(),
                                                          item->colorTable().constData(), 256);
@@ -1606,6 +1895,27 @@ void Abstract3DRenderer::drawCustomItems(RenderingState state,
                             }
                             shader->setUniformValue(shader->textureDimensions(), textureDimensions);
                             shader->setUniformValue(shader->sampleCount(), sampleCount);
+
+                            if (shader == m_volumeTextureShader) {
+                                // Brick size and the mapping from volume to brick grid
+                                // coordinates for empty space skipping
+                                const float brickSize = CustomRenderItem::volumeBrickSize;
+                                shader->setUniformValue(shader->brickDimensions(),
+                                                        textureDimensions * brickSize);
+                                QVector3D occupancyScale(
+                                            float(item->textureWidth())
+                                            / (brickSize * item->brickGridWidth()),
+                                            float(item->textureHeight())
+                                            / (brickSize * item->brickGridHeight()),
+                                            float(item->textureDepth())
+                                            / (brickSize * item->brickGridDepth()));
+                                shader->setUniformValue(shader->occupancyScale(), occupancyScale);
+#if !QT_CONFIG(opengles2)
+                                glActiveTexture(GL_TEXTURE3);
+                                glBindTexture(GL_TEXTURE_3D, item->occupancyTexture());
+                                shader->setUniformValue(shader->occupancy(), 3);
+#endif
+                            }
                         }
                         if (item->drawSliceFrames()) {
                             // Set up the slice frame shader
@@ -1626,6 +1936,12 @@ void Abstract3DRenderer::drawCustomItems(RenderingState state,
                             shader->bind();
                         }
                         m_drawer->drawObject(shader, item->mesh(), 0, 0, item->texture());
+#if !QT_CONFIG(opengles2)
+                        if (shader == m_volumeTextureShader) {
+                            glActiveTexture(GL_TEXTURE3);
+                            glBindTexture(GL_TEXTURE_3D, 0);
+                        }
+#endif
                     } else {
                         shader->setUniformValue(shader->lightS(), m_cachedTheme->lightStrength());
                         m_drawer->drawObject(shader, item->mesh(), item->texture());
@@ -1645,6 +1961,10 @@ void Abstract3DRenderer::drawCustomItems(RenderingState state,
                 m_drawer->drawObject(shader, item->mesh());
             }
         }
+        if (volumeLayerActive) {
+            endVolumeLayer();
+            volumeLayerActive = false;
+        }
         loopCount++;
         if (!volumeDetected)
             loopCount++; // Skip second run if no volumes detected
@@ -1656,6 +1976,348 @@ void Abstract3DRenderer::drawCustomItems(RenderingState state,
     }
 }
 
+// Time without camera movement after which volumes are drawn at full quality again
+static const qint64 volumeInteractionSettleTime = 250;
+
+// Examines the formats of the framebuffer the graph is rendered to, if it is not the one
+// examined before. The layers created for the previous framebuffer are created again.
+void Abstract3DRenderer::updateTargetFormat()
+{
+#if !QT_CONFIG(opengles2)
+    if (m_isOpenGLES || GLint(m_defaultFboHandle) == m_targetFrameBuffer)
+        return;
+
+    m_targetFrameBuffer = m_defaultFboHandle;
+    GLint depthBits = 0;
+    GLint stencilBits = 0;
+    GLint alphaBits = 0;
+    GLint samples = 0;
+    glGetIntegerv(GL_DEPTH_BITS, &depthBits);
+    glGetIntegerv(GL_STENCIL_BITS, &stencilBits);
+    glGetIntegerv(GL_ALPHA_BITS, &alphaBits);
+    glGetIntegerv(GL_SAMPLES, &samples);
+    m_targetHasStencil = stencilBits > 0;
+    if (m_targetHasStencil)
+        m_targetDepthFormat = GL_DEPTH24_STENCIL8;
+    else if (depthBits > 24)
+        m_targetDepthFormat = GL_DEPTH_COMPONENT32;
+    else if (depthBits > 16)
+        m_targetDepthFormat = GL_DEPTH_COMPONENT24;
+    else
+        m_targetDepthFormat = GL_DEPTH_COMPONENT16;
+    m_targetHasAlpha = alphaBits > 0;
+    m_targetSamples = samples;
+
+    m_volumeLayerSize = QSize();
+    m_volumeLayerValid = false;
+    m_frameLayerSize = QSize();
+    m_frameLayerValid = false;
+    m_backgroundLayerSize = QSize();
+    m_backgroundLayerValid = false;
+#endif
+}
+
+// Decides how the volumes of the current frame are drawn. Returns true if they are to be drawn
+// into the volume layer, which is then bound. Sets cachedLayer if the layer already holds the
+// volumes as they would be drawn now, in which case nothing needs to be drawn.
+bool Abstract3DRenderer::beginVolumeLayer(const QMatrix4x4 &projectionViewMatrix,
+                                          bool &cachedLayer)
+{
+    cachedLayer = false;
+    m_volumeInteraction = false;
+#if QT_CONFIG(opengles2)
+    Q_UNUSED(projectionViewMatrix);
+    return false;
+#else
+    if (m_isOpenGLES)
+        return false;
+
+    if (projectionViewMatrix != m_lastVolumeMatrix) {
+        m_lastVolumeMatrix = projectionViewMatrix;
+        m_volumeInteractionTimer.start();
+    }
+    const bool interaction = m_progressiveVolumes && m_volumeInteractionTimer.isValid()
+            && m_volumeInteractionTimer.elapsed() < volumeInteractionSettleTime;
+
+    // Only volumes drawn into the layer are reduced in quality during interaction. Reflections
+    // draw the volumes twice per frame, which a single layer cannot hold.
+    if (!m_volumeLayerSupported || m_reflectionEnabled)
+        return false;
+
+    const QRect &currentViewport = m_primarySubViewport;
+    if (currentViewport.isEmpty())
+        return false;
+
+    if (!interaction && m_volumeLayerValid && m_volumeLayerViewport == currentViewport
+            && m_volumeLayerMatrix == projectionViewMatrix) {
+        cachedLayer = true;
+        return false;
+    }
+
+    // A multisampled depth buffer can only be resolved to a layer of the same size
+    QSize layerSize = currentViewport.size();
+    if (interaction && !m_targetSamples)
+        layerSize = (layerSize / 2).expandedTo(QSize(1, 1));
+
+    bool newLayer = false;
+    if (layerSize != m_volumeLayerSize) {
+        m_textureHelper->deleteTexture(&m_volumeLayerTexture);
+        m_volumeLayerTexture = m_textureHelper->createLayerTexture(layerSize,
+                                                                   m_volumeLayerFrameBuffer,
+                                                                   m_volumeLayerDepthBuffer,
+                                                                   m_targetDepthFormat,
+                                                                   m_targetHasStencil);
+        m_volumeLayerSize = layerSize;
+        glBindFramebuffer(GL_FRAMEBUFFER, m_defaultFboHandle);
+        if (!m_volumeLayerTexture) {
+            m_volumeLayerSupported = false;
+            return false;
+        }
+        newLayer = true;
+    }
+
+    // Copy the depth of the scene drawn so far, so that it still occludes the volumes
+    if (newLayer) {
+        GLenum status = glGetError();
+        while (status)
+            status = glGetError();
+    }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_defaultFboHandle);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_volumeLayerFrameBuffer);
+    QOpenGLExtraFunctions *extraFunctions = m_context->extraFunctions();
+    extraFunctions->glBlitFramebuffer(currentViewport.x(), currentViewport.y(),
+                                      currentViewport.x() + currentViewport.width(),
+                                      currentViewport.y() + currentViewport.height(),
+                                      0, 0, layerSize.width(), layerSize.height(),
+                                      GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    // The copy is only verified once per layer instead of stalling every frame
+    if (newLayer && glGetError() != GL_NO_ERROR) {
+        // The depth formats still do not match, draw volumes directly from now on
+        m_volumeLayerSupported = false;
+        glBindFramebuffer(GL_FRAMEBUFFER, m_defaultFboHandle);
+        return false;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_volumeLayerFrameBuffer);
+    glViewport(0, 0, layerSize.width(), layerSize.height());
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    m_volumeLayerViewport = currentViewport;
+    m_volumeLayerMatrix = projectionViewMatrix;
+    m_volumeInteraction = interaction;
+    // Make sure a full quality frame follows once the camera stops
+    if (m_volumeInteraction)
+        emit needRender();
+    return true;
+#endif
+}
+
+void Abstract3DRenderer::endVolumeLayer()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, m_defaultFboHandle);
+    glViewport(m_volumeLayerViewport.x(), m_volumeLayerViewport.y(),
+               m_volumeLayerViewport.width(), m_volumeLayerViewport.height());
+    // Reduced quality layers are never reused
+    m_volumeLayerValid = !m_volumeInteraction;
+    drawVolumeLayer();
+}
+
+void Abstract3DRenderer::drawVolumeLayer()
+{
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    // The label plane covers the whole viewport with an identity matrix
+    m_labelShader->bind();
+    m_labelShader->setUniformValue(m_labelShader->MVP(), QMatrix4x4());
+    m_labelShader->setUniformValue(m_labelShader->atlasRect(), QVector4D());
+    m_drawer->drawObject(m_labelShader, m_labelObj, m_volumeLayerTexture);
+
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_DEPTH_TEST);
+}
+
+// Copies the background and the grid stored by an earlier frame to the primary subviewport,
+// if they are still drawn the same. Returns false if they need to be drawn.
+bool Abstract3DRenderer::drawBackgroundLayer(const QMatrix4x4 &projectionViewMatrix)
+{
+#if QT_CONFIG(opengles2)
+    Q_UNUSED(projectionViewMatrix);
+    return false;
+#else
+    if (!m_backgroundLayerValid || m_backgroundLayerViewport != m_primarySubViewport
+            || m_backgroundLayerMatrix != projectionViewMatrix) {
+        return false;
+    }
+
+    copyBackgroundLayer(m_backgroundLayerFrameBuffer, m_defaultFboHandle);
+    return true;
+#endif
+}
+
+// Stores the background and the grid just drawn, before anything else is drawn over them
+void Abstract3DRenderer::storeBackgroundLayer(const QMatrix4x4 &projectionViewMatrix)
+{
+#if QT_CONFIG(opengles2)
+    Q_UNUSED(projectionViewMatrix);
+#else
+    m_backgroundLayerValid = false;
+    if (m_isOpenGLES || !m_backgroundLayerSupported || m_primarySubViewport.isEmpty())
+        return;
+
+    // A multisampled framebuffer can only be copied to the same rectangle of a framebuffer with
+    // the same formats, so the layer covers the target from its origin
+    const QSize layerSize(m_primarySubViewport.x() + m_primarySubViewport.width(),
+                          m_primarySubViewport.y() + m_primarySubViewport.height());
+    bool newLayer = false;
+    if (layerSize != m_backgroundLayerSize) {
+        m_backgroundLayerSize = layerSize;
+        bool created = (!m_targetSamples || hasOpenGLFeature(QOpenGLFunctions::FramebufferMultisample))
+                && m_textureHelper->createLayerRenderbuffers(layerSize, m_targetSamples,
+                                                             m_targetHasAlpha,
+                                                             m_targetDepthFormat,
+                                                             m_targetHasStencil,
+                                                             m_backgroundLayerFrameBuffer,
+                                                             m_backgroundLayerColorBuffer,
+                                                             m_backgroundLayerDepthBuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_defaultFboHandle);
+        if (!created) {
+            m_backgroundLayerSupported = false;
+            return;
+        }
+        newLayer = true;
+        GLenum status = glGetError();
+        while (status)
+            status = glGetError();
+    }
+
+    copyBackgroundLayer(m_defaultFboHandle, m_backgroundLayerFrameBuffer);
+    // The copy is only verified once per layer instead of stalling every frame
+    if (newLayer && glGetError() != GL_NO_ERROR) {
+        // The formats do not match the target after all, draw the background every frame
+        m_backgroundLayerSupported = false;
+        return;
+    }
+
+    m_backgroundLayerViewport = m_primarySubViewport;
+    m_backgroundLayerMatrix = projectionViewMatrix;
+    m_backgroundLayerValid = true;
+#endif
+}
+
+void Abstract3DRenderer::copyBackgroundLayer(GLuint readFrameBuffer, GLuint drawFrameBuffer)
+{
+#if QT_CONFIG(opengles2)
+    Q_UNUSED(readFrameBuffer);
+    Q_UNUSED(drawFrameBuffer);
+#else
+    const QRect &rect = m_primarySubViewport;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFrameBuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFrameBuffer);
+    QOpenGLExtraFunctions *extraFunctions = m_context->extraFunctions();
+    extraFunctions->glBlitFramebuffer(rect.x(), rect.y(),
+                                      rect.x() + rect.width(), rect.y() + rect.height(),
+                                      rect.x(), rect.y(),
+                                      rect.x() + rect.width(), rect.y() + rect.height(),
+                                      GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_defaultFboHandle);
+#endif
+}
+
+// Draws the frame stored by an earlier render instead of rendering the graph again, if nothing
+// has invalidated it since. Returns false if the graph needs to be rendered.
+bool Abstract3DRenderer::drawFrameLayer()
+{
+    if (!m_frameLayerValid || m_frameLayerViewport != m_viewport)
+        return false;
+
+    glViewport(m_viewport.x(), m_viewport.y(), m_viewport.width(), m_viewport.height());
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+
+    // The label plane covers the whole viewport with an identity matrix
+    m_labelShader->bind();
+    m_labelShader->setUniformValue(m_labelShader->MVP(), QMatrix4x4());
+    m_labelShader->setUniformValue(m_labelShader->atlasRect(), m_frameLayerRect);
+    m_drawer->drawObject(m_labelShader, m_labelObj, m_frameLayerTexture);
+    m_labelShader->setUniformValue(m_labelShader->atlasRect(), QVector4D());
+
+    glEnable(GL_DEPTH_TEST);
+    return true;
+}
+
+// Copies the frame just rendered into the frame layer, so that it can be drawn again as is
+// until something changes. Only called for frames that repeat the previous one, so animated
+// graphs never pay for the copy.
+void Abstract3DRenderer::storeFrameLayer()
+{
+#if !QT_CONFIG(opengles2)
+    if (m_isOpenGLES || !m_frameLayerSupported || m_viewport.isEmpty())
+        return;
+
+    // A multisampled target can only be resolved to the same rectangle of a buffer with the
+    // same color format. The layer then covers the target from its origin, and has alpha only
+    // if the target has it.
+    QPoint layerOrigin;
+    QSize layerSize = m_viewport.size();
+    if (m_targetSamples) {
+        layerOrigin = m_viewport.topLeft();
+        layerSize = QSize(m_viewport.x() + m_viewport.width(),
+                          m_viewport.y() + m_viewport.height());
+    }
+
+    bool newLayer = false;
+    if (layerSize != m_frameLayerSize) {
+        GLuint noDepthBuffer = 0;
+        m_textureHelper->deleteTexture(&m_frameLayerTexture);
+        m_frameLayerTexture = m_textureHelper->createLayerTexture(layerSize,
+                                                                  m_frameLayerFrameBuffer,
+                                                                  noDepthBuffer, 0, false,
+                                                                  m_targetHasAlpha);
+        m_frameLayerSize = layerSize;
+        if (!m_frameLayerTexture) {
+            m_frameLayerSupported = false;
+            glBindFramebuffer(GL_FRAMEBUFFER, m_defaultFboHandle);
+            return;
+        }
+        newLayer = true;
+        GLenum status = glGetError();
+        while (status)
+            status = glGetError();
+    }
+
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_defaultFboHandle);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_frameLayerFrameBuffer);
+    QOpenGLExtraFunctions *extraFunctions = m_context->extraFunctions();
+    extraFunctions->glBlitFramebuffer(m_viewport.x(), m_viewport.y(),
+                                      m_viewport.x() + m_viewport.width(),
+                                      m_viewport.y() + m_viewport.height(),
+                                      layerOrigin.x(), layerOrigin.y(),
+                                      layerOrigin.x() + m_viewport.width(),
+                                      layerOrigin.y() + m_viewport.height(),
+                                      GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    // The copy is only verified once per layer instead of stalling every time
+    if (newLayer && glGetError() != GL_NO_ERROR)
+        m_frameLayerSupported = false;
+    glBindFramebuffer(GL_FRAMEBUFFER, m_defaultFboHandle);
+
+    m_frameLayerRect = QVector4D(float(layerOrigin.x()) / float(layerSize.width()),
+                                 float(layerOrigin.y()) / float(layerSize.height()),
+                                 1.0f - float(m_viewport.width()) / float(layerSize.width()),
+                                 1.0f - float(m_viewport.height()) / float(layerSize.height()));
+    m_frameLayerViewport = m_viewport;
+    // Frames rendered while volumes are drawn at reduced quality are followed by another one
+    m_frameLayerValid = m_frameLayerSupported && !m_volumeInteraction;
+#endif
+}
+
 void Abstract3DRenderer::drawVolumeSliceFrame(const CustomRenderItem *item, Qt::Axis axis,
                                               const QMatrix4x4 &projectionViewMatrix)
 {
@@ -1815,6 +2477,25 @@ void Abstract3DRenderer::queriedGraphPosition(const QMatrix4x4 &projectionViewMa
     m_graphPositionQueryPending = false;
 }
 
+bool Abstract3DRenderer::shadowMapNeedsUpdate(const QMatrix4x4 &depthProjectionViewMatrix)
+{
+    // The depth texture is kept between frames. It only needs to be rendered again when the
+    // shadow casting geometry or the light has changed. The depth light follows the camera,
+    // so camera movement is caught by the depth matrix comparison.
+    if (!m_shadowMapDirty
+            && m_shadowMapProjectionViewMatrix == depthProjectionViewMatrix
+            && m_shadowMapYFlipped == m_yFlipped
+            && m_shadowMapReflectionEnabled == m_reflectionEnabled) {
+        return false;
+    }
+
+    m_shadowMapDirty = false;
+    m_shadowMapProjectionViewMatrix = depthProjectionViewMatrix;
+    m_shadowMapYFlipped = m_yFlipped;
+    m_shadowMapReflectionEnabled = m_reflectionEnabled;
+    return true;
+}
+
 void Abstract3DRenderer::calculatePolarXZ(const QVector3D &dataPos, float &x, float &z) const
 {
     // x is angular, z is radial
@@ -23,6 +23,7 @@
 #include "axisrendercache_p.h"
 #include "seriesrendercache_p.h"
 #include "customrenderitem_p.h"
+#include <QtCore/QElapsedTimer>
 
 QT_FORWARD_DECLARE_CLASS(QOffscreenSurface)
 
@@ -31,6 +32,9 @@ QT_BEGIN_NAMESPACE
 class TextureHelper;
 class Theme;
 class Drawer;
+class AssetPreparer;
+class QCustom3DVolume;
+struct QCustomVolumeDirtyRegion;
 
 class Abstract3DRenderer : public QObject, protected QOpenGLFunctions
 {
@@ -86,6 +90,7 @@ public:
                                           const QString &fragmentShader,
                                           const QString &fragmentLowDefShader,
                                           const QString &sliceShader,
+                                          const QString &colorShader,
                                           const QString &sliceFrameVertexShader,
                                           const QString &sliceFrameShader);
     virtual void initLabelShaders(const QString &vertexShader, const QString &fragmentShader);
@@ -132,8 +137,9 @@ public:
     virtual QVector3D convertPositionToTranslation(const QVector3D &position,
                                                    bool isAbsolute) = 0;
 
-    void generateBaseColorTexture(const QColor &color, GLuint *texture);
-    void fixGradientAndGenerateTexture(QLinearGradient *gradient, GLuint *gradientTexture);
+    void generateBaseColorTexture(const QColor &color, SharedTexture *&texture);
+    void fixGradientAndGenerateTexture(QLinearGradient *gradient,
+                                       SharedTexture *&gradientTexture);
 
     inline bool isClickQueryResolved() const { return m_clickResolved; }
     inline void clearClickQueryResolved() { m_clickResolved = false; }
@@ -155,6 +161,15 @@ public:
                          const QMatrix4x4 &depthProjectionViewMatrix,
                          GLuint depthTexture, GLfloat shadowQuality, GLfloat reflection = 1.0f);
 
+    // Volumes are drawn at reduced quality while the camera moves, unless disabled
+    inline void setProgressiveVolumeRendering(bool enable) { m_progressiveVolumes = enable; }
+    inline void invalidateVolumeLayer() { m_volumeLayerValid = false; }
+
+    // The previous frame is drawn again as is while nothing in the graph changes
+    bool drawFrameLayer();
+    void storeFrameLayer();
+    inline void invalidateFrameLayer() { m_frameLayerValid = false; }
+
     QVector4D indexToSelectionColor(GLint index);
     void calculatePolarXZ(const QVector3D &dataPos, float &x, float &z) const;
 
@@ -211,11 +226,25 @@ protected:
     void updateCameraViewport();
 
     void recalculateCustomItemScalingAndPos(CustomRenderItem *item);
+    void updatePreparedAssets();
+    void releaseCustomItem(CustomRenderItem *item);
+    GLuint createVolumeTexture(QCustom3DVolume *volumeItem);
+    void updateVolumeOccupancy(CustomRenderItem *renderItem, QCustom3DVolume *volumeItem,
+                               bool fullScan, const QCustomVolumeDirtyRegion &region);
     virtual void getVisibleItemBounds(QVector3D &minBounds, QVector3D &maxBounds) = 0;
     void drawVolumeSliceFrame(const CustomRenderItem *item, Qt::Axis axis,
                               const QMatrix4x4 &projectionViewMatrix);
+    void updateTargetFormat();
+    bool beginVolumeLayer(const QMatrix4x4 &projectionViewMatrix, bool &cachedLayer);
+    void endVolumeLayer();
+    void drawVolumeLayer();
+    bool drawBackgroundLayer(const QMatrix4x4 &projectionViewMatrix);
+    void storeBackgroundLayer(const QMatrix4x4 &projectionViewMatrix);
+    void copyBackgroundLayer(GLuint readFrameBuffer, GLuint drawFrameBuffer);
+    inline void invalidateBackgroundLayer() { m_backgroundLayerValid = false; }
     void queriedGraphPosition(const QMatrix4x4 &projectionViewMatrix, const QVector3D &scaling,
                               GLuint defaultFboHandle);
+    bool shadowMapNeedsUpdate(const QMatrix4x4 &depthProjectionViewMatrix);
 
     bool m_hasNegativeValues;
     Q3DTheme *m_cachedTheme;
@@ -232,6 +261,10 @@ protected:
     AxisRenderCache m_axisCacheZ;
     TextureHelper *m_textureHelper;
     GLuint m_depthTexture;
+    bool m_shadowMapDirty;
+    QMatrix4x4 m_shadowMapProjectionViewMatrix;
+    bool m_shadowMapYFlipped;
+    bool m_shadowMapReflectionEnabled;
 
     Q3DScene *m_cachedScene;
     bool m_selectionDirty;
@@ -240,6 +273,7 @@ protected:
     QHash<QAbstract3DSeries *, SeriesRenderCache *> m_renderCacheList;
     CustomRenderItemArray m_customRenderCache;
     QList<QCustom3DItem *> m_customItemDrawOrder;
+    AssetPreparer *m_assetPreparer;
     QRect m_primarySubViewport;
     QRect m_secondarySubViewport;
     float m_devicePixelRatio;
@@ -267,6 +301,50 @@ protected:
     ShaderHelper *m_cursorPositionShader;
     GLuint m_cursorPositionFrameBuffer;
     GLuint m_cursorPositionTexture;
+    QSize m_cursorPositionBufferSize;
+
+    // Offscreen layer the volumes are drawn into. It is drawn at reduced resolution while the
+    // camera moves, and reused as is while the camera and the graph do not change.
+    GLuint m_volumeLayerTexture;
+    GLuint m_volumeLayerFrameBuffer;
+    GLuint m_volumeLayerDepthBuffer;
+    QSize m_volumeLayerSize;
+    QRect m_volumeLayerViewport;
+    QMatrix4x4 m_volumeLayerMatrix;
+    bool m_volumeLayerSupported;
+    bool m_volumeLayerValid;
+    bool m_progressiveVolumes;
+    bool m_volumeInteraction;
+    QMatrix4x4 m_lastVolumeMatrix;
+    QElapsedTimer m_volumeInteractionTimer;
+
+    // Copy of the last rendered frame
+    GLuint m_frameLayerTexture;
+    GLuint m_frameLayerFrameBuffer;
+    QSize m_frameLayerSize;
+    QRect m_frameLayerViewport;
+    QVector4D m_frameLayerRect; // Part of the layer texture holding the frame
+    bool m_frameLayerSupported;
+    bool m_frameLayerValid;
+
+    // Background and grid as drawn for the current camera, theme and axes. The layer holds
+    // their depth too, so that the rest of the scene can be drawn on top of a copy of it.
+    GLuint m_backgroundLayerFrameBuffer;
+    GLuint m_backgroundLayerColorBuffer;
+    GLuint m_backgroundLayerDepthBuffer;
+    QSize m_backgroundLayerSize;
+    QRect m_backgroundLayerViewport;
+    QMatrix4x4 m_backgroundLayerMatrix;
+    bool m_backgroundLayerSupported;
+    bool m_backgroundLayerValid;
+
+    // Format of the framebuffer the graph is rendered to. Layers copied to and from it must
+    // match it, so it is examined whenever the framebuffer changes.
+    GLint m_targetFrameBuffer;
+    GLenum m_targetDepthFormat;
+    bool m_targetHasStencil;
+    bool m_targetHasAlpha;
+    GLint m_targetSamples;
 
     bool m_useOrthoProjection;
     bool m_xFlipped;
@@ -312,6 +390,7 @@ protected:
 #endif
     QPointer<QOpenGLContext> m_context; // Not owned
     bool m_isOpenGLES;
+    GLuint m_defaultFboHandle; // Target of the frame being rendered
 
 private:
     friend class Abstract3DController;
@@ -61,6 +61,7 @@ void AxisRenderCache::setType(QAbstract3DAxis::AxisType type)
     foreach (LabelItem *label, m_labelItems)
         delete label;
     m_labelItems.clear();
+    m_labelAtlas.clear();
 }
 
 void AxisRenderCache::setTitle(const QString &title)
@@ -83,21 +84,13 @@ void AxisRenderCache::setLabels(const QStringList &labels)
             delete m_labelItems.takeLast();
 
         m_labelItems.reserve(newSize);
+        for (int i = oldSize; i < newSize; i++)
+            m_labelItems.append(new LabelItem);
 
-        int widest = maxLabelWidth(labels);
-
-        for (int i = 0; i < newSize; i++) {
-            if (i >= oldSize)
-                m_labelItems.append(new LabelItem);
-            if (m_drawer) {
-                if (labels.at(i).isEmpty()) {
-                    m_labelItems[i]->clear();
-                } else if (i >= oldSize || labels.at(i) != m_labels.at(i)
-                           || m_labelItems[i]->size().width() != widest) {
-                    m_drawer->generateLabelItem(*m_labelItems[i], labels.at(i), widest);
-                }
-            }
-        }
+        // All labels of the axis share one atlas texture, in which only the changed labels are
+        // replaced as long as they fit into the places of the old ones
+        if (m_drawer)
+            m_drawer->generateLabelAtlas(m_labelAtlas, m_labelItems, labels, maxLabelWidth(labels));
         m_labels = labels;
     }
 }
@@ -151,14 +144,7 @@ void AxisRenderCache::updateTextures()
     else
         m_drawer->generateLabelItem(m_titleItem, m_title);
 
-    int widest = maxLabelWidth(m_labels);
-
-    for (int i = 0; i < m_labels.size(); i++) {
-        if (m_labels.at(i).isEmpty())
-            m_labelItems[i]->clear();
-        else
-            m_drawer->generateLabelItem(*m_labelItems[i], m_labels.at(i), widest);
-    }
+    m_drawer->generateLabelAtlas(m_labelAtlas, m_labelItems, m_labels, maxLabelWidth(m_labels));
 }
 
 void AxisRenderCache::clearLabels()
@@ -166,6 +152,7 @@ void AxisRenderCache::clearLabels()
     m_titleItem.clear();
     for (int i = 0; i < m_labels.size(); i++)
         m_labelItems[i]->clear();
+    m_labelAtlas.clear();
 }
 
 int AxisRenderCache::maxLabelWidth(const QStringList &labels) const
@@ -116,6 +116,7 @@ private:
     Drawer *m_drawer; // Not owned
     LabelItem m_titleItem;
     QList<LabelItem *> m_labelItems;
+    LabelAtlas m_labelAtlas;
     QList<float> m_adjustedGridLinePositions;
     QList<float> m_adjustedLabelPositions;
     bool m_positionsDirty;
@@ -252,28 +252,80 @@ void Bars3DController::handleItemChanged(int rowIndex, int columnIndex)
 {
     QBar3DSeries *series = static_cast<QBarDataProxy *>(sender())->series();
 
-    bool newItem = true;
-    QPoint candidate(rowIndex, columnIndex);
-    foreach (ChangeItem item, m_changedItems) {
-        if (item.point == candidate && item.series == series) {
-            newItem = false;
-            break;
+    // Changed items are tracked in per row bitmaps, so checking for duplicates is cheap
+    QList<QBitArray> &changedColumns = changedItemColumns(series);
+    if (changedColumns.size() <= rowIndex)
+        changedColumns.resize(rowIndex + 1);
+    QBitArray &rowBits = changedColumns[rowIndex];
+    if (rowBits.size() <= columnIndex)
+        rowBits.resize(columnIndex + 1);
+
+    if (!rowBits.testBit(columnIndex)) {
+        rowBits.setBit(columnIndex);
+        m_changeTracker.itemChanged = true;
+
+        if (series == m_selectedBarSeries && m_selectedBar == QPoint(rowIndex, columnIndex))
+            series->d_ptr->markItemLabelDirty();
+        if (series->isVisible())
+            adjustAxisRanges();
+        emitNeedRender();
+    }
+}
+
+void Bars3DController::handleItemsChanged(int startRow, const QList<QBitArray> &changedColumns)
+{
+    QBar3DSeries *series = static_cast<QBarDataProxy *>(sender())->series();
+
+    QList<QBitArray> &allChangedColumns = changedItemColumns(series);
+    int endRow = startRow + changedColumns.size();
+    if (allChangedColumns.size() < endRow)
+        allChangedColumns.resize(endRow);
+
+    bool changed = false;
+    for (int i = 0; i < changedColumns.size(); i++) {
+        const QBitArray &newBits = changedColumns.at(i);
+        if (newBits.count(true) == 0)
+            continue;
+        QBitArray &rowBits = allChangedColumns[startRow + i];
+        if (rowBits.size() < newBits.size())
+            rowBits.resize(newBits.size());
+        if (rowBits.size() > newBits.size()) {
+            QBitArray resizedBits = newBits;
+            resizedBits.resize(rowBits.size());
+            rowBits |= resizedBits;
+        } else {
+            rowBits |= newBits;
         }
+        changed = true;
     }
 
-    if (newItem) {
-        ChangeItem newItem = {series, candidate};
-        m_changedItems.append(newItem);
+    if (changed) {
         m_changeTracker.itemChanged = true;
 
-        if (series == m_selectedBarSeries && m_selectedBar == candidate)
+        int selectedRow = m_selectedBar.x() - startRow;
+        if (series == m_selectedBarSeries && selectedRow >= 0
+                && selectedRow < changedColumns.size()
+                && m_selectedBar.y() < changedColumns.at(selectedRow).size()
+                && changedColumns.at(selectedRow).testBit(m_selectedBar.y())) {
             series->d_ptr->markItemLabelDirty();
+        }
         if (series->isVisible())
             adjustAxisRanges();
         emitNeedRender();
     }
 }
 
+QList<QBitArray> &Bars3DController::changedItemColumns(QBar3DSeries *series)
+{
+    for (int i = 0; i < m_changedItems.size(); i++) {
+        if (m_changedItems.at(i).series == series)
+            return m_changedItems[i].changedColumns;
+    }
+    ChangeItems newItems = {series, QList<QBitArray>()};
+    m_changedItems.append(newItems);
+    return m_changedItems.last().changedColumns;
+}
+
 void Bars3DController::handleDataRowLabelsChanged()
 {
     if (m_axisZ) {
@@ -16,6 +16,7 @@
 
 #include <private/datavisualizationglobal_p.h>
 #include <private/abstract3dcontroller_p.h>
+#include <QtCore/QBitArray>
 
 QT_BEGIN_NAMESPACE
 
@@ -48,9 +49,9 @@ class Q_DATAVISUALIZATION_EXPORT Bars3DController : public Abstract3DController
     Q_OBJECT
 
 public:
-    struct ChangeItem {
+    struct ChangeItems {
         QBar3DSeries *series;
-        QPoint point;
+        QList<QBitArray> changedColumns; // Changed columns of each data row
     };
     struct ChangeRow {
         QBar3DSeries *series;
@@ -59,7 +60,7 @@ public:
 
 private:
     Bars3DChangeBitField m_changeTracker;
-    QList<ChangeItem> m_changedItems;
+    QList<ChangeItems> m_changedItems;
     QList<ChangeRow> m_changedRows;
 
     // Interaction
@@ -137,6 +138,7 @@ public Q_SLOTS:
     void handleRowsRemoved(int startIndex, int count);
     void handleRowsInserted(int startIndex, int count);
     void handleItemChanged(int rowIndex, int columnIndex);
+    void handleItemsChanged(int startRow, const QList<QBitArray> &changedColumns);
     void handleDataRowLabelsChanged();
     void handleDataColumnLabelsChanged();
     void handleRowColorsChanged();
@@ -150,6 +152,7 @@ protected:
 
 private:
     void adjustSelectionPosition(QPoint &pos, const QBar3DSeries *series);
+    QList<QBitArray> &changedItemColumns(QBar3DSeries *series);
 
     Q_DISABLE_COPY(Bars3DController)
 };
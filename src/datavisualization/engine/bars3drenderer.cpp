@@ -10,6 +10,9 @@
 
 #include <QtCore/qmath.h>
 
+#include <algorithm>
+#include <cfloat>
+
 // You can verify that depth buffer drawing works correctly by uncommenting this.
 // You should see the scene from  where the light is
 //#define SHOW_DEPTH_TEXTURE_SCENE
@@ -18,6 +21,60 @@ QT_BEGIN_NAMESPACE
 
 const bool sliceGridLabels = true;
 
+// Orders series so that the ones drawn with the same shader and mesh are adjacent
+static inline QString seriesMeshFile(const BarSeriesRenderCache *cache)
+{
+    return cache->object() ? cache->object()->objectFile() : QString();
+}
+
+// Series sharing a mesh share its object, so ordering by the mesh file keeps them adjacent
+// without the draw order depending on where the objects were allocated
+static bool seriesDrawOrderLessThan(const BarSeriesRenderCache *cache1,
+                                    const BarSeriesRenderCache *cache2)
+{
+    if (cache1->colorStyle() != cache2->colorStyle())
+        return cache1->colorStyle() < cache2->colorStyle();
+    const QString meshFile1 = seriesMeshFile(cache1);
+    const QString meshFile2 = seriesMeshFile(cache2);
+    if (meshFile1 != meshFile2)
+        return meshFile1 < meshFile2;
+    return cache1->visualIndex() < cache2->visualIndex();
+}
+
+// Clips the ray parameter range [tMin, tMax] to the part where start + t * delta is within
+// [rangeMin, rangeMax]. Returns false if nothing remains.
+inline static bool clipRayToRange(GLfloat start, GLfloat delta, GLfloat rangeMin,
+                                  GLfloat rangeMax, GLfloat &tMin, GLfloat &tMax)
+{
+    if (delta == 0.0f)
+        return start >= rangeMin && start <= rangeMax;
+
+    GLfloat t1 = (rangeMin - start) / delta;
+    GLfloat t2 = (rangeMax - start) / delta;
+    if (t1 > t2)
+        qSwap(t1, t2);
+    tMin = qMax(tMin, t1);
+    tMax = qMin(tMax, t2);
+    return tMin <= tMax;
+}
+
+// Returns true if the ray hits a box centered at origin with the given half extents.
+// The ray parameter of the entry point is returned in hit.
+inline static bool rayHitsBox(const QVector3D &origin, const QVector3D &direction,
+                              const QVector3D &extents, GLfloat &hit)
+{
+    GLfloat tMin = -FLT_MAX;
+    GLfloat tMax = FLT_MAX;
+    for (int axis = 0; axis < 3; axis++) {
+        if (!clipRayToRange(origin[axis], direction[axis], -extents[axis], extents[axis],
+                            tMin, tMax)) {
+            return false;
+        }
+    }
+    hit = tMin;
+    return true;
+}
+
 Bars3DRenderer::Bars3DRenderer(Bars3DController *controller)
     : Abstract3DRenderer(controller),
       m_cachedIsSlicingActivated(false),
@@ -26,7 +83,9 @@ Bars3DRenderer::Bars3DRenderer(Bars3DController *controller)
       m_cachedBarSeriesMargin(0.0f, 0.0f),
       m_selectedBar(0),
       m_sliceCache(0),
-      m_sliceTitleItem(0),
+      m_sliceDirty(true),
+      m_sliceLineIndex(-1),
+      m_sliceSeriesCache(0),
       m_updateLabels(false),
       m_barShader(0),
       m_barGradientShader(0),
@@ -65,7 +124,8 @@ Bars3DRenderer::Bars3DRenderer(Bars3DController *controller)
       m_xScaleFactor(1.0f),
       m_zScaleFactor(1.0f),
       m_floorLevel(0.0f),
-      m_actualFloorLevel(0.0f)
+      m_actualFloorLevel(0.0f),
+      m_dataSnapshotsPending(false)
 {
     m_axisCacheY.setScale(2.0f);
     m_axisCacheY.setTranslate(-1.0f);
@@ -162,14 +222,13 @@ void Bars3DRenderer::getVisibleItemBounds(QVector3D &minBounds, QVector3D &maxBo
 
 void Bars3DRenderer::updateData()
 {
+    invalidateBackgroundLayer();
     int minRow = m_axisCacheZ.min();
     int maxRow = m_axisCacheZ.max();
     int minCol = m_axisCacheX.min();
     int maxCol = m_axisCacheX.max();
     int newRows = maxRow - minRow + 1;
     int newColumns = maxCol - minCol + 1;
-    int dataRowCount = 0;
-    int maxDataRowCount = 0;
 
     m_seriesScaleX = 1.0f / float(m_visibleSeriesCount);
     m_seriesStep = 1.0f / float(m_visibleSeriesCount);
@@ -184,7 +243,6 @@ void Bars3DRenderer::updateData()
     if (m_cachedRowCount != newRows || m_cachedColumnCount != newColumns) {
         // Force update for selection related items
         m_sliceCache = 0;
-        m_sliceTitleItem = 0;
 
         m_cachedColumnCount = newColumns;
         m_cachedRowCount = newRows;
@@ -198,39 +256,78 @@ void Bars3DRenderer::updateData()
 
     m_zeroPosition = m_axisCacheY.formatter()->positionAt(m_actualFloorLevel);
 
+    // Only take snapshots of the changed rows here. The rows are implicitly shared, so this is
+    // cheap, and the data can be changed again as soon as the synchronization is done.
+    // Converting the data to render items is left for the next render().
     foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
         BarSeriesRenderCache *cache = static_cast<BarSeriesRenderCache *>(baseCache);
         if (cache->isVisible()) {
-            const QBar3DSeries *currentSeries = cache->series();
+            const BarRenderItemArray &renderArray = cache->renderArray();
+            if (cache->dataDirty() || cache->hasDataSnapshot()
+                    || newRows != renderArray.size()
+                    || newColumns != renderArray.at(0).size()) {
+                takeDataSnapshot(cache);
+                cache->setDataDirty(false);
+            }
+        }
+    }
+
+    m_dataSnapshotsPending = true;
+}
+
+void Bars3DRenderer::takeDataSnapshot(BarSeriesRenderCache *cache)
+{
+    int minRow = m_axisCacheZ.min();
+    int maxRow = m_axisCacheZ.max();
+    QBarDataProxy *dataProxy = cache->series()->dataProxy();
+    int lastRow = qMin(maxRow, dataProxy->rowCount() - 1);
+
+    QList<QBarDataRow> rows;
+    rows.reserve(qMax(0, lastRow - minRow + 1));
+    for (int row = minRow; row <= lastRow; row++) {
+        const QBarDataRow *dataRow = dataProxy->rowAt(row);
+        rows.append(dataRow ? *dataRow : QBarDataRow());
+    }
+    cache->setDataSnapshot(rows, minRow);
+}
+
+void Bars3DRenderer::processDataSnapshots()
+{
+    m_dataSnapshotsPending = false;
+
+    int newRows = m_cachedRowCount;
+    int newColumns = m_cachedColumnCount;
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        BarSeriesRenderCache *cache = static_cast<BarSeriesRenderCache *>(baseCache);
+        if (!cache->hasDataSnapshot())
+            continue;
+        if (cache->isVisible()) {
             BarRenderItemArray &renderArray = cache->renderArray();
-            bool dimensionsChanged = false;
             if (newRows != renderArray.size()
                     || newColumns != renderArray.at(0).size()) {
                 // Destroy old render items and reallocate new array
-                dimensionsChanged = true;
                 renderArray.resize(newRows);
                 for (int i = 0; i < newRows; i++)
                     renderArray[i].resize(newColumns);
                 cache->sliceArray().clear();
             }
 
-            if (cache->dataDirty() || dimensionsChanged) {
-                QBarDataProxy *dataProxy = currentSeries->dataProxy();
-                dataRowCount = dataProxy->rowCount();
-                if (maxDataRowCount < dataRowCount)
-                    maxDataRowCount = qMin(dataRowCount, newRows);
-                int dataRowIndex = minRow;
-                for (int i = 0; i < newRows; i++) {
-                    BarRenderItemRow &renderRow = renderArray[i];
-                    const QBarDataRow *dataRow = 0;
-                    if (dataRowIndex < dataRowCount)
-                        dataRow = dataProxy->rowAt(dataRowIndex);
-                    updateRenderRow(dataRow, renderRow);
-                    dataRowIndex++;
-                }
-                cache->setDataDirty(false);
+            const QList<QBarDataRow> &dataRows = cache->dataSnapshot();
+            int dataRowIndex = int(m_axisCacheZ.min()) - cache->dataSnapshotFirstRow();
+            for (int i = 0; i < newRows; i++) {
+                const QBarDataRow *dataRow = 0;
+                if (dataRowIndex >= 0 && dataRowIndex < dataRows.size())
+                    dataRow = &dataRows.at(dataRowIndex);
+                updateRenderRow(dataRow, renderArray[i]);
+                dataRowIndex++;
             }
+            // The retained slice view holds copies of the items
+            m_sliceDirty = true;
+        } else {
+            cache->setDataDirty(true);
         }
+        // Let the proxy modify its rows again without copying them
+        cache->releaseDataSnapshot();
     }
 
     // Reset selected bar to update selection
@@ -326,6 +423,20 @@ void Bars3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesList)
             m_selectionLabelDirty = true;
         m_selectedSeriesCache = 0;
     }
+
+    // Group visible series by shader and mesh, so that render state changes only when the
+    // group changes while drawing. Each series is still traversed on its own: merging them
+    // into one stream per shader would need instanced drawing, which OpenGL ES2 lacks, and
+    // the bars of one cell differ in color and highlight per series anyway.
+    m_seriesDrawOrder.clear();
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        if (baseCache->isVisible())
+            m_seriesDrawOrder.append(static_cast<BarSeriesRenderCache *>(baseCache));
+    }
+    std::sort(m_seriesDrawOrder.begin(), m_seriesDrawOrder.end(), seriesDrawOrderLessThan);
+
+    // Series visibility and visual order affect the slice view
+    m_sliceDirty = true;
 }
 
 SeriesRenderCache *Bars3DRenderer::createNewCache(QAbstract3DSeries *series)
@@ -354,53 +465,100 @@ void Bars3DRenderer::updateRows(const QList<Bars3DController::ChangeRow> &rows)
             // they can be completely recalculated when they are turned visible.
             if (!cache->isVisible() && !cache->dataDirty())
                 cache->setDataDirty(true);
+            // A snapshot not yet converted is simply taken again, as it is converted as a whole
+            if (cache->hasDataSnapshot())
+                takeDataSnapshot(cache);
         }
-        if (cache->isVisible()) {
+        if (cache->isVisible() && !cache->hasDataSnapshot()) {
             updateRenderRow(dataArray->at(row), cache->renderArray()[row - minRow]);
-            if (m_cachedIsSlicingActivated
-                    && cache == m_selectedSeriesCache
-                    && m_selectedBarPos.x() == row) {
-                m_selectionDirty = true; // Need to update slice view
+            if (m_cachedIsSlicingActivated) {
+                int columnCount = cache->renderArray().at(row - minRow).size();
+                for (int col = 0; col < columnCount; col++)
+                    updateSliceItem(cache, row - minRow, col);
             }
         }
     }
+    m_shadowMapDirty = true;
 }
 
-void Bars3DRenderer::updateItems(const QList<Bars3DController::ChangeItem> &items)
+void Bars3DRenderer::updateItems(const QList<Bars3DController::ChangeItems> &items)
 {
     int minRow = m_axisCacheZ.min();
     int maxRow = m_axisCacheZ.max();
     int minCol = m_axisCacheX.min();
     int maxCol = m_axisCacheX.max();
-    BarSeriesRenderCache *cache = 0;
-    const QBar3DSeries *prevSeries = 0;
-    const QBarDataArray *dataArray = 0;
 
-    foreach (Bars3DController::ChangeItem item, items) {
-        const int row = item.point.x();
-        const int col = item.point.y();
-        if (row < minRow || row > maxRow || col < minCol || col > maxCol)
+    foreach (const Bars3DController::ChangeItems &seriesItems, items) {
+        BarSeriesRenderCache *cache =
+                static_cast<BarSeriesRenderCache *>(m_renderCacheList.value(seriesItems.series));
+        if (!cache)
+            continue;
+        // Invisible series render caches are not updated, but instead just marked dirty, so that
+        // they can be completely recalculated when they are turned visible.
+        if (!cache->isVisible()) {
+            cache->setDataDirty(true);
             continue;
-        QBar3DSeries *currentSeries = item.series;
-        if (currentSeries != prevSeries) {
-            cache = static_cast<BarSeriesRenderCache *>(m_renderCacheList.value(currentSeries));
-            prevSeries = currentSeries;
-            dataArray = item.series->dataProxy()->array();
-            // Invisible series render caches are not updated, but instead just marked dirty, so that
-            // they can be completely recalculated when they are turned visible.
-            if (!cache->isVisible() && !cache->dataDirty())
-                cache->setDataDirty(true);
         }
-        if (cache->isVisible()) {
-            updateRenderItem(dataArray->at(row)->at(col),
-                             cache->renderArray()[row - minRow][col - minCol]);
-            if (m_cachedIsSlicingActivated
-                    && cache == m_selectedSeriesCache
-                    && m_selectedBarPos == QPoint(row, col)) {
-                m_selectionDirty = true; // Need to update slice view
+        // Items are refreshed anyway if the whole series is waiting for an update
+        if (cache->dataDirty())
+            continue;
+        if (cache->hasDataSnapshot()) {
+            takeDataSnapshot(cache);
+            continue;
+        }
+
+        const QBarDataArray *dataArray = seriesItems.series->dataProxy()->array();
+        const QList<QBitArray> &changedColumns = seriesItems.changedColumns;
+        BarRenderItemArray &renderArray = cache->renderArray();
+        int lastRow = qMin(maxRow, int(qMin(changedColumns.size(), dataArray->size())) - 1);
+        for (int row = minRow; row <= lastRow; row++) {
+            const QBitArray &rowBits = changedColumns.at(row);
+            const QBarDataRow *dataRow = dataArray->at(row);
+            int lastCol = qMin(maxCol, int(qMin(rowBits.size(), dataRow->size())) - 1);
+            if (lastCol < minCol)
+                continue;
+            BarRenderItemRow &renderRow = renderArray[row - minRow];
+            for (int col = minCol; col <= lastCol; col++) {
+                if (!rowBits.testBit(col))
+                    continue;
+                updateRenderItem(dataRow->at(col), renderRow[col - minCol]);
+                if (m_cachedIsSlicingActivated)
+                    updateSliceItem(cache, row - minRow, col - minCol);
             }
         }
     }
+    m_shadowMapDirty = true;
+}
+
+void Bars3DRenderer::updateSliceItem(BarSeriesRenderCache *cache, int row, int bar)
+{
+    // Update a single item of the retained slice view in place instead of rebuilding the slice.
+    // Items outside the sliced row or column do not affect it.
+    if (m_sliceDirty
+            || (cache != m_sliceSeriesCache
+                && !m_cachedSelectionMode.testFlag(QAbstract3DGraph::SelectionMultiSeries))) {
+        return;
+    }
+
+    bool rowMode = m_cachedSelectionMode.testFlag(QAbstract3DGraph::SelectionRow);
+    if ((rowMode ? row : bar) != m_sliceLineIndex)
+        return;
+
+    QList<BarRenderSliceItem> &sliceArray = cache->sliceArray();
+    int sliceIndex = rowMode ? bar : row;
+    if (sliceIndex >= sliceArray.size()) {
+        m_sliceDirty = true;
+        return;
+    }
+
+    // Only the height changes, the slice item keeps its position in the slice
+    BarRenderSliceItem &sliceItem = sliceArray[sliceIndex];
+    BarRenderItem item = cache->renderArray().at(row).at(bar);
+    QVector3D translation = sliceItem.translation();
+    translation.setY(item.height());
+    item.setTranslation(translation);
+    item.setPosition(QPoint(row, bar));
+    sliceItem.setItem(item);
 }
 
 void Bars3DRenderer::updateScene(Q3DScene *scene)
@@ -426,6 +584,9 @@ void Bars3DRenderer::updateScene(Q3DScene *scene)
 
 void Bars3DRenderer::render(GLuint defaultFboHandle)
 {
+    if (m_dataSnapshotsPending)
+        processDataSnapshots();
+
     // Handle GL state setup for FBO buffers and clearing of the render surface
     Abstract3DRenderer::render(defaultFboHandle);
 
@@ -793,7 +954,13 @@ void Bars3DRenderer::drawSlicedScene()
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     BarRenderItem *dummyItem(0);
-    const LabelItem &sliceSelectionLabel = *m_sliceTitleItem;
+
+    // Slice title is the label of the sliced row or column
+    const LabelItem *sliceTitleItem = 0;
+    const QList<LabelItem *> &titleLabels = rowMode ? m_axisCacheZ.labelItems()
+                                                    : m_axisCacheX.labelItems();
+    if (m_sliceLineIndex >= 0 && m_sliceLineIndex < titleLabels.size())
+        sliceTitleItem = titleLabels.at(m_sliceLineIndex);
     QVector3D positionComp(0.0f, m_autoScaleAdjustment, 0.0f);
 
     // Draw labels for bars
@@ -890,8 +1057,8 @@ void Bars3DRenderer::drawSlicedScene()
 
     // Draw labels for axes
     if (rowMode) {
-        if (m_sliceTitleItem) {
-            m_drawer->drawLabel(*dummyItem, sliceSelectionLabel, viewMatrix, projectionMatrix,
+        if (sliceTitleItem) {
+            m_drawer->drawLabel(*dummyItem, *sliceTitleItem, viewMatrix, projectionMatrix,
                                 positionComp, identityQuaternion, 0, m_cachedSelectionMode,
                                 m_labelShader, m_labelObj, activeCamera, false, false,
                                 Drawer::LabelTop, Qt::AlignCenter, true);
@@ -906,8 +1073,8 @@ void Bars3DRenderer::drawSlicedScene()
                             m_labelShader,
                             m_labelObj, activeCamera, false, false, Drawer::LabelBottom,
                             Qt::AlignCenter, true);
-        if (m_sliceTitleItem) {
-            m_drawer->drawLabel(*dummyItem, sliceSelectionLabel, viewMatrix, projectionMatrix,
+        if (sliceTitleItem) {
+            m_drawer->drawLabel(*dummyItem, *sliceTitleItem, viewMatrix, projectionMatrix,
                                 positionComp, identityQuaternion, 0, m_cachedSelectionMode,
                                 m_labelShader,
                                 m_labelObj, activeCamera, false, false, Drawer::LabelTop,
@@ -1023,6 +1190,21 @@ void Bars3DRenderer::drawScene(GLuint defaultFboHandle)
     BarRenderItem *selectedBar(0);
 
     if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone && !m_isOpenGLES) {
+        // Get the depth view matrix
+        // It may be possible to hack lightPos here if we want to make some tweaks to shadow
+        QVector3D depthLightPos = activeCamera->d_ptr->calculatePositionRelativeToCamera(
+                    zeroVector, 0.0f, 3.5f / m_autoScaleAdjustment);
+        depthViewMatrix.lookAt(depthLightPos, zeroVector, upVector);
+
+        // Set the depth projection matrix
+        depthProjectionMatrix.perspective(10.0f, viewPortRatio, 3.0f, 100.0f);
+        depthProjectionViewMatrix = depthProjectionMatrix * depthViewMatrix;
+    }
+
+    // The stored background has the shadows of the previous shadow map on it
+    const bool shadowMapUpdated = m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone
+            && !m_isOpenGLES && shadowMapNeedsUpdate(depthProjectionViewMatrix);
+    if (shadowMapUpdated) {
         // Render scene into a depth texture for using with shadow mapping
         // Enable drawing to depth framebuffer
         glBindFramebuffer(GL_FRAMEBUFFER, m_depthFrameBuffer);
@@ -1037,95 +1219,68 @@ void Bars3DRenderer::drawScene(GLuint defaultFboHandle)
                    m_primarySubViewport.width() * m_shadowQualityMultiplier,
                    m_primarySubViewport.height() * m_shadowQualityMultiplier);
 
-        // Get the depth view matrix
-        // It may be possible to hack lightPos here if we want to make some tweaks to shadow
-        QVector3D depthLightPos = activeCamera->d_ptr->calculatePositionRelativeToCamera(
-                    zeroVector, 0.0f, 3.5f / m_autoScaleAdjustment);
-        depthViewMatrix.lookAt(depthLightPos, zeroVector, upVector);
-
-        // Set the depth projection matrix
-        depthProjectionMatrix.perspective(10.0f, viewPortRatio, 3.0f, 100.0f);
-        depthProjectionViewMatrix = depthProjectionMatrix * depthViewMatrix;
-
         // Draw bars to depth buffer
         QVector3D shadowScaler(m_scaleX * m_seriesScaleX * 0.9f, 0.0f,
                                m_scaleZ * m_seriesScaleZ * 0.9f);
-        foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
-            if (baseCache->isVisible()) {
-                BarSeriesRenderCache *cache = static_cast<BarSeriesRenderCache *>(baseCache);
-                float seriesPos = m_seriesStart + m_seriesStep
-                        * (cache->visualIndex() - (cache->visualIndex()
-                                                   * m_cachedBarSeriesMargin.width())) + 0.5f;
-                ObjectHelper *barObj = cache->object();
-                QQuaternion seriesRotation(cache->meshRotation());
-                const BarRenderItemArray &renderArray = cache->renderArray();
-                for (int row = startRow; row != stopRow; row += stepRow) {
-                    const BarRenderItemRow &renderRow = renderArray.at(row);
-                    for (int bar = startBar; bar != stopBar; bar += stepBar) {
-                        const BarRenderItem &item = renderRow.at(bar);
-                        if (!item.value())
-                            continue;
-                        GLfloat shadowOffset = 0.0f;
-                        // Set front face culling for negative valued bars and back face culling
-                        // for positive valued bars to remove peter-panning issues
-                        if (item.height() > 0) {
-                            glCullFace(GL_BACK);
-                            if (m_yFlipped)
-                                shadowOffset = 0.015f;
-                        } else {
-                            glCullFace(GL_FRONT);
-                            if (!m_yFlipped)
-                                shadowOffset = -0.015f;
-                        }
-
-                        if (m_cachedTheme->isBackgroundEnabled() && m_reflectionEnabled
-                                && ((m_yFlipped && item.height() > 0.0)
-                                    || (!m_yFlipped && item.height() < 0.0))) {
-                            continue;
-                        }
-
-                        QMatrix4x4 modelMatrix;
-                        QMatrix4x4 MVPMatrix;
-
-                        colPos = (bar + seriesPos) * (m_cachedBarSpacing.width());
-                        rowPos = (row + 0.5f) * (m_cachedBarSpacing.height());
-
-                        // Draw shadows for bars "on the other side" a bit off ground to avoid
-                        // seeing shadows through the ground
-                        modelMatrix.translate((colPos - m_rowWidth) / m_scaleFactor,
-                                              item.height() + shadowOffset,
-                                              (m_columnDepth - rowPos) / m_scaleFactor);
-                        // Scale the bars down in X and Z to reduce self-shadowing issues
-                        shadowScaler.setY(item.height());
-                        if (!seriesRotation.isIdentity() || !item.rotation().isIdentity())
-                            modelMatrix.rotate(seriesRotation * item.rotation());
-                        modelMatrix.scale(shadowScaler);
+        foreach (BarSeriesRenderCache *cache, m_seriesDrawOrder) {
+            float seriesPos = m_seriesStart + m_seriesStep
+                    * (cache->visualIndex() - (cache->visualIndex()
+                                               * m_cachedBarSeriesMargin.width())) + 0.5f;
+            ObjectHelper *barObj = cache->object();
+            QQuaternion seriesRotation(cache->meshRotation());
+            const BarRenderItemArray &renderArray = cache->renderArray();
+            // All bars of a series share the mesh, so the buffers are bound only once
+            m_drawer->bindObject(m_depthShader, barObj);
+            for (int row = startRow; row != stopRow; row += stepRow) {
+                const BarRenderItemRow &renderRow = renderArray.at(row);
+                for (int bar = startBar; bar != stopBar; bar += stepBar) {
+                    const BarRenderItem &item = renderRow.at(bar);
+                    if (!item.value())
+                        continue;
+                    GLfloat shadowOffset = 0.0f;
+                    // Set front face culling for negative valued bars and back face culling
+                    // for positive valued bars to remove peter-panning issues
+                    if (item.height() > 0) {
+                        glCullFace(GL_BACK);
+                        if (m_yFlipped)
+                            shadowOffset = 0.015f;
+                    } else {
+                        glCullFace(GL_FRONT);
+                        if (!m_yFlipped)
+                            shadowOffset = -0.015f;
+                    }
 
-                        MVPMatrix = depthProjectionViewMatrix * modelMatrix;
+                    if (m_cachedTheme->isBackgroundEnabled() && m_reflectionEnabled
+                            && ((m_yFlipped && item.height() > 0.0)
+                                || (!m_yFlipped && item.height() < 0.0))) {
+                        continue;
+                    }
 
-                        m_depthShader->setUniformValue(m_depthShader->MVP(), MVPMatrix);
+                    QMatrix4x4 modelMatrix;
+                    QMatrix4x4 MVPMatrix;
 
-                        // 1st attribute buffer : vertices
-                        glEnableVertexAttribArray(m_depthShader->posAtt());
-                        glBindBuffer(GL_ARRAY_BUFFER, barObj->vertexBuf());
-                        glVertexAttribPointer(m_depthShader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0,
-                                              (void *)0);
+                    colPos = (bar + seriesPos) * (m_cachedBarSpacing.width());
+                    rowPos = (row + 0.5f) * (m_cachedBarSpacing.height());
 
-                        // Index buffer
-                        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, barObj->elementBuf());
+                    // Draw shadows for bars "on the other side" a bit off ground to avoid
+                    // seeing shadows through the ground
+                    modelMatrix.translate((colPos - m_rowWidth) / m_scaleFactor,
+                                          item.height() + shadowOffset,
+                                          (m_columnDepth - rowPos) / m_scaleFactor);
+                    // Scale the bars down in X and Z to reduce self-shadowing issues
+                    shadowScaler.setY(item.height());
+                    if (!seriesRotation.isIdentity() || !item.rotation().isIdentity())
+                        modelMatrix.rotate(seriesRotation * item.rotation());
+                    modelMatrix.scale(shadowScaler);
 
-                        // Draw the triangles
-                        glDrawElements(GL_TRIANGLES, barObj->indexCount(), GL_UNSIGNED_INT,
-                                       (void *)0);
+                    MVPMatrix = depthProjectionViewMatrix * modelMatrix;
 
-                        // Free buffers
-                        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-                        glBindBuffer(GL_ARRAY_BUFFER, 0);
+                    m_depthShader->setUniformValue(m_depthShader->MVP(), MVPMatrix);
 
-                        glDisableVertexAttribArray(m_depthShader->posAtt());
-                    }
+                    m_drawer->drawBoundObject(barObj);
                 }
             }
+            m_drawer->releaseObject(m_depthShader);
         }
 
         Abstract3DRenderer::drawCustomItems(RenderingDepth, m_depthShader, viewMatrix,
@@ -1156,8 +1311,37 @@ void Bars3DRenderer::drawScene(GLuint defaultFboHandle)
         emit needRender();
     }
 
-    // Skip selection mode drawing if we're slicing or have no selection mode
+    // A bar hit by the ray cast answers the click without the selection pass and its readback,
+    // unless a custom item could be in front of it. Axis labels lie on the walls and the floor
+    // outside the bar grid, so they cannot cover bars. Anything else is resolved by the
+    // selection pass.
+    bool clickResolvedByRayCast = false;
     if (!m_cachedIsSlicingActivated && m_cachedSelectionMode > QAbstract3DGraph::SelectionNone
+            && m_selectionState == SelectOnScene && m_visibleSeriesCount > 0) {
+        bool customItemsVisible = false;
+        foreach (CustomRenderItem *item, m_customRenderCache) {
+            if (item->isVisible()) {
+                customItemsVisible = true;
+                break;
+            }
+        }
+        if (!customItemsVisible) {
+            BarSeriesRenderCache *pickedCache = 0;
+            QPoint pickedBar = pickBar(projectionViewMatrix, &pickedCache);
+            if (pickedCache) {
+                m_clickedPosition = selectionColorToArrayPosition(
+                            QVector4D(0.0f, 0.0f, 0.0f, itemAlpha), pickedBar);
+                m_clickedSeries = pickedCache->series();
+                m_clickResolved = true;
+                clickResolvedByRayCast = true;
+                emit needRender();
+            }
+        }
+    }
+
+    // Skip selection mode drawing if we're slicing or have no selection mode
+    if (!clickResolvedByRayCast && !m_cachedIsSlicingActivated
+            && m_cachedSelectionMode > QAbstract3DGraph::SelectionNone
             && m_selectionState == SelectOnScene
             && (m_visibleSeriesCount > 0 || !m_customRenderCache.isEmpty())
             && m_selectionTexture) {
@@ -1174,56 +1358,54 @@ void Bars3DRenderer::drawScene(GLuint defaultFboHandle)
         glClearColor(1.0f, 1.0f, 1.0f, 1.0f); // Set clear color to white (= selectionSkipColor)
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // Needed for clearing the frame buffer
         glDisable(GL_DITHER); // disable dithering, it may affect colors if enabled
-        foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
-            if (baseCache->isVisible()) {
-                BarSeriesRenderCache *cache = static_cast<BarSeriesRenderCache *>(baseCache);
-                float seriesPos = m_seriesStart + m_seriesStep
-                        * (cache->visualIndex() - (cache->visualIndex()
-                                                   * m_cachedBarSeriesMargin.width())) + 0.5f;
-                ObjectHelper *barObj = cache->object();
-                QQuaternion seriesRotation(cache->meshRotation());
-                const BarRenderItemArray &renderArray = cache->renderArray();
-                for (int row = startRow; row != stopRow; row += stepRow) {
-                    const BarRenderItemRow &renderRow = renderArray.at(row);
-                    for (int bar = startBar; bar != stopBar; bar += stepBar) {
-                        const BarRenderItem &item = renderRow.at(bar);
-                        if (!item.value())
-                            continue;
-
-                        if (item.height() < 0)
-                            glCullFace(GL_FRONT);
-                        else
-                            glCullFace(GL_BACK);
 
-                        QMatrix4x4 modelMatrix;
-                        QMatrix4x4 MVPMatrix;
+        // Bars are drawn with a single color, as they only need to occlude labels and custom
+        // items. The clicked bar itself is resolved by pickBar() without color coding.
+        m_selectionShader->setUniformValue(m_selectionShader->color(),
+                                           QVector4D(0.0f, 0.0f, 0.0f, itemAlpha));
+        foreach (BarSeriesRenderCache *cache, m_seriesDrawOrder) {
+            float seriesPos = m_seriesStart + m_seriesStep
+                    * (cache->visualIndex() - (cache->visualIndex()
+                                               * m_cachedBarSeriesMargin.width())) + 0.5f;
+            ObjectHelper *barObj = cache->object();
+            QQuaternion seriesRotation(cache->meshRotation());
+            const BarRenderItemArray &renderArray = cache->renderArray();
+            m_drawer->bindObject(m_selectionShader, barObj);
+            for (int row = startRow; row != stopRow; row += stepRow) {
+                const BarRenderItemRow &renderRow = renderArray.at(row);
+                for (int bar = startBar; bar != stopBar; bar += stepBar) {
+                    const BarRenderItem &item = renderRow.at(bar);
+                    if (!item.value())
+                        continue;
+
+                    if (item.height() < 0)
+                        glCullFace(GL_FRONT);
+                    else
+                        glCullFace(GL_BACK);
 
-                        colPos = (bar + seriesPos) * (m_cachedBarSpacing.width());
-                        rowPos = (row + 0.5f) * (m_cachedBarSpacing.height());
+                    QMatrix4x4 modelMatrix;
+                    QMatrix4x4 MVPMatrix;
 
-                        modelMatrix.translate((colPos - m_rowWidth) / m_scaleFactor,
-                                              item.height(),
-                                              (m_columnDepth - rowPos) / m_scaleFactor);
-                        if (!seriesRotation.isIdentity() || !item.rotation().isIdentity())
-                            modelMatrix.rotate(seriesRotation * item.rotation());
-                        modelMatrix.scale(QVector3D(m_scaleX * m_seriesScaleX,
-                                                    item.height(),
-                                                    m_scaleZ * m_seriesScaleZ));
+                    colPos = (bar + seriesPos) * (m_cachedBarSpacing.width());
+                    rowPos = (row + 0.5f) * (m_cachedBarSpacing.height());
 
-                        MVPMatrix = projectionViewMatrix * modelMatrix;
+                    modelMatrix.translate((colPos - m_rowWidth) / m_scaleFactor,
+                                          item.height(),
+                                          (m_columnDepth - rowPos) / m_scaleFactor);
+                    if (!seriesRotation.isIdentity() || !item.rotation().isIdentity())
+                        modelMatrix.rotate(seriesRotation * item.rotation());
+                    modelMatrix.scale(QVector3D(m_scaleX * m_seriesScaleX,
+                                                item.height(),
+                                                m_scaleZ * m_seriesScaleZ));
 
-                        QVector4D barColor = QVector4D(GLfloat(row) / 255.0f,
-                                                       GLfloat(bar) / 255.0f,
-                                                       GLfloat(cache->visualIndex()) / 255.0f,
-                                                       itemAlpha);
+                    MVPMatrix = projectionViewMatrix * modelMatrix;
 
-                        m_selectionShader->setUniformValue(m_selectionShader->MVP(), MVPMatrix);
-                        m_selectionShader->setUniformValue(m_selectionShader->color(), barColor);
+                    m_selectionShader->setUniformValue(m_selectionShader->MVP(), MVPMatrix);
 
-                        m_drawer->drawSelectionObject(m_selectionShader, barObj);
-                    }
+                    m_drawer->drawBoundObject(barObj);
                 }
             }
+            m_drawer->releaseObject(m_selectionShader);
         }
         glCullFace(GL_BACK);
         Abstract3DRenderer::drawCustomItems(RenderingSelection, m_selectionShader,
@@ -1237,8 +1419,15 @@ void Bars3DRenderer::drawScene(GLuint defaultFboHandle)
 
         // Read color under cursor
         QVector4D clickedColor = Utils::getSelection(m_inputPosition, m_viewport.height());
-        m_clickedPosition = selectionColorToArrayPosition(clickedColor);
-        m_clickedSeries = selectionColorToSeries(clickedColor);
+        if (clickedColor.w() == itemAlpha) {
+            BarSeriesRenderCache *pickedCache = 0;
+            QPoint pickedBar = pickBar(projectionViewMatrix, &pickedCache);
+            m_clickedPosition = selectionColorToArrayPosition(clickedColor, pickedBar);
+            m_clickedSeries = pickedCache ? pickedCache->series() : 0;
+        } else {
+            m_clickedPosition = selectionColorToArrayPosition(clickedColor);
+            m_clickedSeries = selectionColorToSeries(clickedColor);
+        }
         m_clickResolved = true;
 
         emit needRender();
@@ -1299,15 +1488,23 @@ void Bars3DRenderer::drawScene(GLuint defaultFboHandle)
     // Draw the real scene
     //
     // Draw background
+    bool gridDrawn = false;
     if (m_reflectionEnabled) {
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         drawBackground(backgroundRotation, depthProjectionViewMatrix, projectionViewMatrix,
                        viewMatrix, true);
         glDisable(GL_BLEND);
-    } else {
+    } else if (shadowMapUpdated || !drawBackgroundLayer(projectionViewMatrix)) {
+        // Without reflections nothing is drawn before the background and the grid, so they
+        // are stored for the following frames that only change what is drawn over them
         drawBackground(backgroundRotation, depthProjectionViewMatrix, projectionViewMatrix,
                        viewMatrix);
+        drawGridLines(depthProjectionViewMatrix, projectionViewMatrix, viewMatrix);
+        storeBackgroundLayer(projectionViewMatrix);
+        gridDrawn = true;
+    } else {
+        gridDrawn = true;
     }
 
     // Draw bars
@@ -1317,7 +1514,8 @@ void Bars3DRenderer::drawScene(GLuint defaultFboHandle)
                                       startBar, stopBar, stepBar);
 
     // Draw grid lines
-    drawGridLines(depthProjectionViewMatrix, projectionViewMatrix, viewMatrix);
+    if (!gridDrawn)
+        drawGridLines(depthProjectionViewMatrix, projectionViewMatrix, viewMatrix);
 
     // Draw custom items
     Abstract3DRenderer::drawCustomItems(RenderingNormal, m_customItemShader, viewMatrix,
@@ -1407,9 +1605,15 @@ bool Bars3DRenderer::drawBars(BarRenderItem **selectedBar,
         previousColorStyle = Q3DTheme::ColorStyleRangeGradient;
     }
 
+    // The slice view is retained between frames. It only needs to be rebuilt when the sliced
+    // row or column changes, moving the selection within it only changes the highlight.
+    // Data changes within the slice are applied in place by updateSliceItem().
     int sliceReserveAmount = 0;
-    if (m_selectionDirty && m_cachedIsSlicingActivated) {
-        // Slice doesn't own its items, no need to delete them - just clear
+    int sliceLineIndex = rowMode ? m_visualSelectedBarPos.x() : m_visualSelectedBarPos.y();
+    bool rebuildSlice = m_cachedIsSlicingActivated && reflection == 1.0f
+            && (m_sliceDirty || sliceLineIndex != m_sliceLineIndex
+                || m_selectedSeriesCache != m_sliceSeriesCache);
+    if (rebuildSlice) {
         if (rowMode)
             sliceReserveAmount = m_cachedColumnCount;
         else
@@ -1420,7 +1624,9 @@ bool Bars3DRenderer::drawBars(BarRenderItem **selectedBar,
             m_sliceCache = &m_axisCacheX;
         else
             m_sliceCache = &m_axisCacheZ;
-        m_sliceTitleItem = 0;
+        m_sliceLineIndex = sliceLineIndex;
+        m_sliceSeriesCache = m_selectedSeriesCache;
+        m_sliceDirty = false;
     }
 
     glEnable(GL_POLYGON_OFFSET_FILL);
@@ -1436,241 +1642,257 @@ bool Bars3DRenderer::drawBars(BarRenderItem **selectedBar,
     QVector3D modelScaler(m_scaleX * m_seriesScaleX, 0.0f, m_scaleZ * m_seriesScaleZ);
     bool somethingSelected =
             (m_visualSelectedBarPos != Bars3DController::invalidSelectionPosition());
-    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
-        if (baseCache->isVisible()) {
-            BarSeriesRenderCache *cache = static_cast<BarSeriesRenderCache *>(baseCache);
-            float seriesPos = m_seriesStart + m_seriesStep
-                    * (cache->visualIndex() - (cache->visualIndex()
-                                               * m_cachedBarSeriesMargin.width())) + 0.5f;
-            ObjectHelper *barObj = cache->object();
-            QQuaternion seriesRotation(cache->meshRotation());
-            Q3DTheme::ColorStyle colorStyle = cache->colorStyle();
-            BarRenderItemArray &renderArray = cache->renderArray();
-            bool colorStyleIsUniform = (colorStyle == Q3DTheme::ColorStyleUniform);
-            if (sliceReserveAmount)
-                cache->sliceArray().resize(sliceReserveAmount);
-
-            // Rebind shader if it has changed
-            if (colorStyleIsUniform != (previousColorStyle == Q3DTheme::ColorStyleUniform)) {
-                if (colorStyleIsUniform)
-                    barShader = m_barShader;
-                else
-                    barShader = m_barGradientShader;
-                barShader->bind();
-            }
+    bool drawShadows = m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone
+            && !m_isOpenGLES;
+    foreach (BarSeriesRenderCache *cache, m_seriesDrawOrder) {
+        float seriesPos = m_seriesStart + m_seriesStep
+                * (cache->visualIndex() - (cache->visualIndex()
+                                           * m_cachedBarSeriesMargin.width())) + 0.5f;
+        ObjectHelper *barObj = cache->object();
+        QQuaternion seriesRotation(cache->meshRotation());
+        Q3DTheme::ColorStyle colorStyle = cache->colorStyle();
+        BarRenderItemArray &renderArray = cache->renderArray();
+        bool colorStyleIsUniform = (colorStyle == Q3DTheme::ColorStyleUniform);
+        if (sliceReserveAmount)
+            cache->sliceArray().resize(sliceReserveAmount);
+
+        // Rebind shader if it has changed
+        if (colorStyleIsUniform != (previousColorStyle == Q3DTheme::ColorStyleUniform)) {
+            if (colorStyleIsUniform)
+                barShader = m_barShader;
+            else
+                barShader = m_barGradientShader;
+            barShader->bind();
+        }
 
-            if (colorStyleIsUniform) {
-                baseColor = cache->baseColor();
-            } else if ((previousColorStyle != colorStyle)
-                       && (colorStyle == Q3DTheme::ColorStyleObjectGradient)) {
-                m_barGradientShader->setUniformValue(m_barGradientShader->gradientHeight(), 0.5f);
-            }
+        if (colorStyleIsUniform) {
+            baseColor = cache->baseColor();
+        } else if ((previousColorStyle != colorStyle)
+                   && (colorStyle == Q3DTheme::ColorStyleObjectGradient)) {
+            m_barGradientShader->setUniformValue(m_barGradientShader->gradientHeight(), 0.5f);
+        }
 
-            // Always use base color when no selection mode
-            if (m_cachedSelectionMode == QAbstract3DGraph::SelectionNone) {
-                if (colorStyleIsUniform)
-                    barColor = baseColor;
-                else
-                    gradientTexture = cache->baseGradientTexture();
-            }
+        // Always use base color when no selection mode
+        if (m_cachedSelectionMode == QAbstract3DGraph::SelectionNone) {
+            if (colorStyleIsUniform)
+                barColor = baseColor;
+            else
+                gradientTexture = cache->baseGradientTexture();
+        }
 
-            previousColorStyle = colorStyle;
-            for (int row = startRow; row != stopRow; row += stepRow) {
-                BarRenderItemRow &renderRow = renderArray[row];
-                for (int bar = startBar; bar != stopBar; bar += stepBar) {
-                    BarRenderItem &item = renderRow[bar];
-                    float adjustedHeight = reflection * item.height();
-                    if (adjustedHeight < 0)
-                        glCullFace(GL_FRONT);
-                    else
-                        glCullFace(GL_BACK);
+        previousColorStyle = colorStyle;
 
-                    QMatrix4x4 modelMatrix;
-                    QMatrix4x4 itModelMatrix;
-                    QMatrix4x4 MVPMatrix;
+        // Bars of a series share the mesh and the depth texture, so they are bound once per
+        // series. The gradient texture is only rebound when the highlight state changes it.
+        m_drawer->bindObject(barShader, barObj);
+        if (drawShadows) {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, m_depthTexture);
+            barShader->setUniformValue(barShader->shadow(), 1);
+        }
+        GLuint boundGradientTexture = 0;
+        if (!colorStyleIsUniform)
+            barShader->setUniformValue(barShader->texture(), 0);
+
+        for (int row = startRow; row != stopRow; row += stepRow) {
+            BarRenderItemRow &renderRow = renderArray[row];
+            for (int bar = startBar; bar != stopBar; bar += stepBar) {
+                BarRenderItem &item = renderRow[bar];
+                float adjustedHeight = reflection * item.height();
+                if (adjustedHeight < 0)
+                    glCullFace(GL_FRONT);
+                else
+                    glCullFace(GL_BACK);
 
-                    GLfloat colPos = (bar + seriesPos) * (m_cachedBarSpacing.width());
-                    GLfloat rowPos = (row + 0.5f) * (m_cachedBarSpacing.height());
+                QMatrix4x4 modelMatrix;
+                QMatrix4x4 itModelMatrix;
+                QMatrix4x4 MVPMatrix;
 
-                    modelMatrix.translate((colPos - m_rowWidth) / m_scaleFactor,
-                                          adjustedHeight,
-                                          (m_columnDepth - rowPos) / m_scaleFactor);
-                    modelScaler.setY(adjustedHeight);
-                    if (!seriesRotation.isIdentity() || !item.rotation().isIdentity()) {
-                        QQuaternion totalRotation = seriesRotation * item.rotation();
-                        modelMatrix.rotate(totalRotation);
-                        itModelMatrix.rotate(totalRotation);
-                    }
-                    modelMatrix.scale(modelScaler);
-                    itModelMatrix.scale(modelScaler);
+                GLfloat colPos = (bar + seriesPos) * (m_cachedBarSpacing.width());
+                GLfloat rowPos = (row + 0.5f) * (m_cachedBarSpacing.height());
+
+                modelMatrix.translate((colPos - m_rowWidth) / m_scaleFactor,
+                                      adjustedHeight,
+                                      (m_columnDepth - rowPos) / m_scaleFactor);
+                modelScaler.setY(adjustedHeight);
+                if (!seriesRotation.isIdentity() || !item.rotation().isIdentity()) {
+                    QQuaternion totalRotation = seriesRotation * item.rotation();
+                    modelMatrix.rotate(totalRotation);
+                    itModelMatrix.rotate(totalRotation);
+                }
+                modelMatrix.scale(modelScaler);
+                itModelMatrix.scale(modelScaler);
 #ifdef SHOW_DEPTH_TEXTURE_SCENE
-                    MVPMatrix = depthProjectionViewMatrix * modelMatrix;
+                MVPMatrix = depthProjectionViewMatrix * modelMatrix;
 #else
-                    MVPMatrix = projectionViewMatrix * modelMatrix;
+                MVPMatrix = projectionViewMatrix * modelMatrix;
 #endif
-                    GLfloat lightStrength = m_cachedTheme->lightStrength();
-                    GLfloat shadowLightStrength = adjustedLightStrength;
-
-                    if (m_cachedSelectionMode > QAbstract3DGraph::SelectionNone) {
-                        Bars3DController::SelectionType selectionType =
-                                Bars3DController::SelectionNone;
-                        if (somethingSelected)
-                            selectionType = isSelected(row, bar, cache);
-
-                        switch (selectionType) {
-                        case Bars3DController::SelectionItem: {
-                            if (colorStyleIsUniform)
-                                barColor = cache->singleHighlightColor();
-                            else
-                                gradientTexture = cache->singleHighlightGradientTexture();
-
-                            lightStrength = m_cachedTheme->highlightLightStrength();
-                            shadowLightStrength = adjustedHighlightStrength;
-                            // Insert position data into render item
-                            // We have no ownership, don't delete the previous one
-                            if (!m_cachedIsSlicingActivated
-                                    && m_selectedSeriesCache == cache) {
-                                *selectedBar = &item;
-                                (*selectedBar)->setPosition(QPoint(row, bar));
-                                item.setTranslation(modelMatrix.column(3).toVector3D());
-                                barSelectionFound = true;
-                            }
-                            if (m_selectionDirty && m_cachedIsSlicingActivated) {
-                                QVector3D translation = modelMatrix.column(3).toVector3D();
-                                if (m_cachedSelectionMode & QAbstract3DGraph::SelectionColumn
-                                        && m_visibleSeriesCount > 1) {
-                                    translation.setZ((m_columnDepth
-                                                      - ((row + seriesPos)
-                                                         * (m_cachedBarSpacing.height())))
-                                                     / m_scaleFactor);
-                                }
-                                item.setTranslation(translation);
-                                item.setPosition(QPoint(row, bar));
-                                if (rowMode)
-                                    cache->sliceArray()[bar].setItem(item);
-                                else
-                                    cache->sliceArray()[row].setItem(item);
-                            }
-                            break;
+                GLfloat lightStrength = m_cachedTheme->lightStrength();
+                GLfloat shadowLightStrength = adjustedLightStrength;
+
+                if (m_cachedSelectionMode > QAbstract3DGraph::SelectionNone) {
+                    Bars3DController::SelectionType selectionType =
+                            Bars3DController::SelectionNone;
+                    if (somethingSelected)
+                        selectionType = isSelected(row, bar, cache);
+
+                    switch (selectionType) {
+                    case Bars3DController::SelectionItem: {
+                        if (colorStyleIsUniform)
+                            barColor = cache->singleHighlightColor();
+                        else
+                            gradientTexture = cache->singleHighlightGradientTexture();
+
+                        lightStrength = m_cachedTheme->highlightLightStrength();
+                        shadowLightStrength = adjustedHighlightStrength;
+                        // Insert position data into render item
+                        // We have no ownership, don't delete the previous one
+                        if (!m_cachedIsSlicingActivated
+                                && m_selectedSeriesCache == cache) {
+                            *selectedBar = &item;
+                            (*selectedBar)->setPosition(QPoint(row, bar));
+                            item.setTranslation(modelMatrix.column(3).toVector3D());
+                            barSelectionFound = true;
                         }
-                        case Bars3DController::SelectionRow: {
-                            // Current bar is on the same row as the selected bar
-                            if (colorStyleIsUniform)
-                                barColor = cache->multiHighlightColor();
-                            else
-                                gradientTexture = cache->multiHighlightGradientTexture();
-
-                            lightStrength = m_cachedTheme->highlightLightStrength();
-                            shadowLightStrength = adjustedHighlightStrength;
-                            if (m_cachedIsSlicingActivated) {
-                                item.setTranslation(modelMatrix.column(3).toVector3D());
-                                item.setPosition(QPoint(row, bar));
-                                if (m_selectionDirty) {
-                                    if (!m_sliceTitleItem && m_axisCacheZ.labelItems().size() > row)
-                                        m_sliceTitleItem = m_axisCacheZ.labelItems().at(row);
-                                    cache->sliceArray()[bar].setItem(item);
-                                }
+                        if (rebuildSlice) {
+                            QVector3D translation = modelMatrix.column(3).toVector3D();
+                            if (m_cachedSelectionMode & QAbstract3DGraph::SelectionColumn
+                                    && m_visibleSeriesCount > 1) {
+                                translation.setZ((m_columnDepth
+                                                  - ((row + seriesPos)
+                                                     * (m_cachedBarSpacing.height())))
+                                                 / m_scaleFactor);
                             }
-                            break;
-                        }
-                        case Bars3DController::SelectionColumn: {
-                            // Current bar is on the same column as the selected bar
-                            if (colorStyleIsUniform)
-                                barColor = cache->multiHighlightColor();
+                            item.setTranslation(translation);
+                            item.setPosition(QPoint(row, bar));
+                            if (rowMode)
+                                cache->sliceArray()[bar].setItem(item);
                             else
-                                gradientTexture = cache->multiHighlightGradientTexture();
-
-                            lightStrength = m_cachedTheme->highlightLightStrength();
-                            shadowLightStrength = adjustedHighlightStrength;
-                            if (m_cachedIsSlicingActivated) {
-                                QVector3D translation = modelMatrix.column(3).toVector3D();
-                                if (m_visibleSeriesCount > 1) {
-                                    translation.setZ((m_columnDepth
-                                                      - ((row + seriesPos)
-                                                         * (m_cachedBarSpacing.height())))
-                                                     / m_scaleFactor);
-                                }
-                                item.setTranslation(translation);
-                                item.setPosition(QPoint(row, bar));
-                                if (m_selectionDirty) {
-                                    if (!m_sliceTitleItem && m_axisCacheX.labelItems().size() > bar)
-                                        m_sliceTitleItem = m_axisCacheX.labelItems().at(bar);
-                                    cache->sliceArray()[row].setItem(item);
-                                }
+                                cache->sliceArray()[row].setItem(item);
+                        }
+                        break;
+                    }
+                    case Bars3DController::SelectionRow: {
+                        // Current bar is on the same row as the selected bar
+                        if (colorStyleIsUniform)
+                            barColor = cache->multiHighlightColor();
+                        else
+                            gradientTexture = cache->multiHighlightGradientTexture();
+
+                        lightStrength = m_cachedTheme->highlightLightStrength();
+                        shadowLightStrength = adjustedHighlightStrength;
+                        if (m_cachedIsSlicingActivated) {
+                            item.setTranslation(modelMatrix.column(3).toVector3D());
+                            item.setPosition(QPoint(row, bar));
+                            if (rebuildSlice)
+                                cache->sliceArray()[bar].setItem(item);
+                        }
+                        break;
+                    }
+                    case Bars3DController::SelectionColumn: {
+                        // Current bar is on the same column as the selected bar
+                        if (colorStyleIsUniform)
+                            barColor = cache->multiHighlightColor();
+                        else
+                            gradientTexture = cache->multiHighlightGradientTexture();
+
+                        lightStrength = m_cachedTheme->highlightLightStrength();
+                        shadowLightStrength = adjustedHighlightStrength;
+                        if (m_cachedIsSlicingActivated) {
+                            QVector3D translation = modelMatrix.column(3).toVector3D();
+                            if (m_visibleSeriesCount > 1) {
+                                translation.setZ((m_columnDepth
+                                                  - ((row + seriesPos)
+                                                     * (m_cachedBarSpacing.height())))
+                                                 / m_scaleFactor);
                             }
-                            break;
+                            item.setTranslation(translation);
+                            item.setPosition(QPoint(row, bar));
+                            if (rebuildSlice)
+                                cache->sliceArray()[row].setItem(item);
                         }
-                        case Bars3DController::SelectionNone: {
-                            // Current bar is not selected, nor on a row or column
-                            if (colorStyleIsUniform) {
-                                QList<QColor> rowColors = cache->series()->rowColors();
-                                if (rowColors.size() == 0) {
-                                    barColor = baseColor;
-                                } else {
-                                    int rowColorIndex = row % rowColors.size();
-                                    barColor =  Utils::vectorFromColor(rowColors[rowColorIndex]);
-                                }
+                        break;
+                    }
+                    case Bars3DController::SelectionNone: {
+                        // Current bar is not selected, nor on a row or column
+                        if (colorStyleIsUniform) {
+                            QList<QColor> rowColors = cache->series()->rowColors();
+                            if (rowColors.size() == 0) {
+                                barColor = baseColor;
                             } else {
-                                gradientTexture = cache->baseGradientTexture();
+                                int rowColorIndex = row % rowColors.size();
+                                barColor =  Utils::vectorFromColor(rowColors[rowColorIndex]);
                             }
-                            break;
-                        }
+                        } else {
+                            gradientTexture = cache->baseGradientTexture();
                         }
+                        break;
                     }
+                    }
+                }
 
-                    if (item.height() == 0) {
-                        continue;
-                    } else if ((m_reflectionEnabled
-                                && (reflection == 1.0f
-                                    || (reflection != 1.0f
-                                        && ((m_yFlipped && item.height() < 0.0)
-                                            || (!m_yFlipped && item.height() > 0.0)))))
-                               || !m_reflectionEnabled) {
-                        // Skip drawing of 0-height bars and reflections of bars on the "wrong side"
-                        // Set shader bindings
-                        barShader->setUniformValue(barShader->model(), modelMatrix);
-                        barShader->setUniformValue(barShader->nModel(),
-                                                   itModelMatrix.transposed().inverted());
-                        barShader->setUniformValue(barShader->MVP(), MVPMatrix);
-                        if (colorStyleIsUniform) {
-                            barShader->setUniformValue(barShader->color(), barColor);
-                        } else if (colorStyle == Q3DTheme::ColorStyleRangeGradient) {
-                            barShader->setUniformValue(barShader->gradientHeight(),
-                                                       qAbs(item.height()) / m_gradientFraction);
-                        }
+                if (item.height() == 0) {
+                    continue;
+                } else if ((m_reflectionEnabled
+                            && (reflection == 1.0f
+                                || (reflection != 1.0f
+                                    && ((m_yFlipped && item.height() < 0.0)
+                                        || (!m_yFlipped && item.height() > 0.0)))))
+                           || !m_reflectionEnabled) {
+                    // Skip drawing of 0-height bars and reflections of bars on the "wrong side"
+                    // Set shader bindings
+                    barShader->setUniformValue(barShader->model(), modelMatrix);
+                    barShader->setUniformValue(barShader->nModel(),
+                                               itModelMatrix.transposed().inverted());
+                    barShader->setUniformValue(barShader->MVP(), MVPMatrix);
+                    if (colorStyleIsUniform) {
+                        barShader->setUniformValue(barShader->color(), barColor);
+                    } else if (colorStyle == Q3DTheme::ColorStyleRangeGradient) {
+                        barShader->setUniformValue(barShader->gradientHeight(),
+                                                   qAbs(item.height()) / m_gradientFraction);
+                    }
 
-                        if (((m_reflectionEnabled && reflection == 1.0f
-                             && m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone)
-                                || m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone)
-                             && !m_isOpenGLES) {
-                            // Set shadow shader bindings
-                            QMatrix4x4 depthMVPMatrix = depthProjectionViewMatrix * modelMatrix;
-                            barShader->setUniformValue(barShader->shadowQ(),
-                                                       m_shadowQualityToShader);
-                            barShader->setUniformValue(barShader->depth(), depthMVPMatrix);
-                            barShader->setUniformValue(barShader->lightS(), shadowLightStrength);
-                            barShader->setUniformValue(barShader->lightColor(), lightColor);
-
-                            // Draw the object
-                            m_drawer->drawObject(barShader, barObj, gradientTexture,
-                                                 m_depthTexture);
+                    if (drawShadows) {
+                        // Set shadow shader bindings
+                        QMatrix4x4 depthMVPMatrix = depthProjectionViewMatrix * modelMatrix;
+                        barShader->setUniformValue(barShader->shadowQ(),
+                                                   m_shadowQualityToShader);
+                        barShader->setUniformValue(barShader->depth(), depthMVPMatrix);
+                        barShader->setUniformValue(barShader->lightS(), shadowLightStrength);
+                        barShader->setUniformValue(barShader->lightColor(), lightColor);
+                    } else {
+                        // Set shadowless shader bindings
+                        if (m_reflectionEnabled && reflection != 1.0f
+                                && m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
+                            barShader->setUniformValue(barShader->lightS(),
+                                                       adjustedLightStrength);
                         } else {
-                            // Set shadowless shader bindings
-                            if (m_reflectionEnabled && reflection != 1.0f
-                                    && m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
-                                barShader->setUniformValue(barShader->lightS(),
-                                                           adjustedLightStrength);
-                            } else {
-                                barShader->setUniformValue(barShader->lightS(), lightStrength);
-                            }
-
-                            // Draw the object
-                            m_drawer->drawObject(barShader, barObj, gradientTexture);
+                            barShader->setUniformValue(barShader->lightS(), lightStrength);
                         }
                     }
+
+                    if (!colorStyleIsUniform && gradientTexture != boundGradientTexture) {
+                        glActiveTexture(GL_TEXTURE0);
+                        glBindTexture(GL_TEXTURE_2D, gradientTexture);
+                        boundGradientTexture = gradientTexture;
+                    }
+
+                    // Draw the object
+                    m_drawer->drawBoundObject(barObj);
                 }
             }
         }
+
+        // Release the per-series bindings
+        m_drawer->releaseObject(barShader);
+        if (drawShadows) {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+        if (boundGradientTexture) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
     }
     glDisable(GL_POLYGON_OFFSET_FILL);
 
@@ -2036,6 +2258,8 @@ void Bars3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCamer
 
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        m_drawer->beginLabelBatch(m_primarySubViewport.size());
     }
 
     glEnable(GL_POLYGON_OFFSET_FILL);
@@ -2120,7 +2344,7 @@ void Bars3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCamer
         backLabelTrans.setY(m_axisCacheY.labelPosition(i));
         sideLabelTrans.setY(backLabelTrans.y());
 
-        glPolygonOffset(offsetValue++ / -10.0f, 1.0f);
+        m_drawer->setLabelPolygonOffset(offsetValue++ / -10.0f, 1.0f);
 
         const LabelItem &axisLabelItem = *m_axisCacheY.labelItems().at(i);
 
@@ -2253,7 +2477,7 @@ void Bars3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCamer
         else
             colPos = colPosValue;
 
-        glPolygonOffset(offsetValue++ / -10.0f, 1.0f);
+        m_drawer->setLabelPolygonOffset(offsetValue++ / -10.0f, 1.0f);
 
         QVector3D labelPos = QVector3D(colPos,
                                        labelYAdjustment, // raise a bit over background to avoid depth "glimmering"
@@ -2372,7 +2596,7 @@ void Bars3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCamer
         else
             rowPos = rowPosValue;
 
-        glPolygonOffset(offsetValue++ / -10.0f, 1.0f);
+        m_drawer->setLabelPolygonOffset(offsetValue++ / -10.0f, 1.0f);
 
         QVector3D labelPos = QVector3D((colPos - m_rowWidth) / m_scaleFactor,
                                        labelYAdjustment, // raise a bit over background to avoid depth "glimmering"
@@ -2415,11 +2639,14 @@ void Bars3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCamer
                         shader, m_labelObj, activeCamera,
                         true, false, Drawer::LabelMid, Qt::AlignHCenter, false, drawSelection);
 #endif
+    if (!drawSelection)
+        m_drawer->endLabelBatch();
     glDisable(GL_POLYGON_OFFSET_FILL);
 }
 
 void Bars3DRenderer::updateMultiSeriesScaling(bool uniform)
 {
+    invalidateBackgroundLayer();
     m_keepSeriesUniform = uniform;
 
     // Recalculate scale factors
@@ -2432,6 +2659,7 @@ void Bars3DRenderer::updateMultiSeriesScaling(bool uniform)
 
 void Bars3DRenderer::updateBarSpecs(GLfloat thicknessRatio, const QSizeF &spacing, bool relative)
 {
+    invalidateBackgroundLayer();
     // Convert ratio to QSizeF, as we need it in that format for autoscaling calculations
     m_cachedBarThickness.setWidth(1.0f);
     m_cachedBarThickness.setHeight(1.0f / thicknessRatio);
@@ -2445,16 +2673,13 @@ void Bars3DRenderer::updateBarSpecs(GLfloat thicknessRatio, const QSizeF &spacin
         m_cachedBarSpacing = m_cachedBarThickness * 2 + spacing * 2;
     }
 
-    // Slice mode doesn't update correctly without this
-    if (m_cachedIsSlicingActivated)
-        m_selectionDirty = true;
-
     // Calculate here and at setting sample space
     calculateSceneScalingFactors();
 }
 
 void Bars3DRenderer::updateBarSeriesMargin(const QSizeF &margin)
 {
+    invalidateBackgroundLayer();
     m_cachedBarSeriesMargin = margin;
     calculateSeriesStartPosition();
     calculateSceneScalingFactors();
@@ -2557,7 +2782,7 @@ void Bars3DRenderer::updateShadowQuality(QAbstract3DGraph::ShadowQuality quality
 
 void Bars3DRenderer::loadBackgroundMesh()
 {
-    ObjectHelper::resetObjectHelper(this, m_backgroundObj,
+    ObjectHelper::resetObjectHelper(m_backgroundObj,
                                     QStringLiteral(":/defaultMeshes/backgroundNoFloor"));
 }
 
@@ -2612,6 +2837,9 @@ void Bars3DRenderer::calculateSceneScalingFactors()
     m_scaleYWithBackground = 1.0f + m_vBackgroundMargin;
     m_scaleZWithBackground = m_zScaleFactor + m_hBackgroundMargin;
 
+    // Bar translations in the slice view depend on scaling
+    m_sliceDirty = true;
+
     updateCameraViewport();
     updateCustomItemPositions();
 }
@@ -2687,18 +2915,21 @@ Bars3DController::SelectionType Bars3DRenderer::isSelected(int row, int bar,
     return isSelectedType;
 }
 
-QPoint Bars3DRenderer::selectionColorToArrayPosition(const QVector4D &selectionColor)
+QPoint Bars3DRenderer::selectionColorToArrayPosition(const QVector4D &selectionColor,
+                                                     const QPoint &pickedBar)
 {
     QPoint position = Bars3DController::invalidSelectionPosition();
     m_clickedType = QAbstract3DGraph::ElementNone;
     m_selectedLabelIndex = -1;
     m_selectedCustomItemIndex = -1;
     if (selectionColor.w() == itemAlpha) {
-        // Normal selection item
-        position = QPoint(int(selectionColor.x() + int(m_axisCacheZ.min())),
-                          int(selectionColor.y()) + int(m_axisCacheX.min()));
-        // Pass item clicked info to input handler
-        m_clickedType = QAbstract3DGraph::ElementSeries;
+        // Normal selection item, resolved by pickBar()
+        if (pickedBar != Bars3DController::invalidSelectionPosition()) {
+            position = QPoint(pickedBar.x() + int(m_axisCacheZ.min()),
+                              pickedBar.y() + int(m_axisCacheX.min()));
+            // Pass item clicked info to input handler
+            m_clickedType = QAbstract3DGraph::ElementSeries;
+        }
     } else if (selectionColor.w() == labelRowAlpha) {
         // Row selection
         if (m_cachedSelectionMode.testFlag(QAbstract3DGraph::SelectionRow)) {
@@ -2736,6 +2967,140 @@ QPoint Bars3DRenderer::selectionColorToArrayPosition(const QVector4D &selectionC
     return position;
 }
 
+QPoint Bars3DRenderer::pickBar(const QMatrix4x4 &projectionViewMatrix,
+                               BarSeriesRenderCache **pickedCache)
+{
+    // Casts a ray from the input position through the bar grid and returns the render array
+    // position of the nearest bar hit. Only the cells crossed by the ray are tested, so picking
+    // works for any grid size and needs no color coding of the positions.
+    QPoint pickedBar = Bars3DController::invalidSelectionPosition();
+    *pickedCache = 0;
+
+    if (!m_cachedRowCount || !m_cachedColumnCount || !m_primarySubViewport.width()
+            || !m_primarySubViewport.height()) {
+        return pickedBar;
+    }
+
+    bool invertible = false;
+    QMatrix4x4 inverseMatrix = projectionViewMatrix.inverted(&invertible);
+    if (!invertible)
+        return pickedBar;
+
+    // Use the same pixel that Utils::getSelection() reads from the selection buffer
+    GLfloat ndcX = 2.0f * (GLfloat(m_inputPosition.x()) + 0.5f)
+            / GLfloat(m_primarySubViewport.width()) - 1.0f;
+    GLfloat ndcY = 2.0f * (GLfloat(m_viewport.height() - m_inputPosition.y()) + 0.5f)
+            / GLfloat(m_primarySubViewport.height()) - 1.0f;
+    QVector4D nearPoint = inverseMatrix * QVector4D(ndcX, ndcY, -1.0f, 1.0f);
+    QVector4D farPoint = inverseMatrix * QVector4D(ndcX, ndcY, 1.0f, 1.0f);
+    if (nearPoint.w() == 0.0f || farPoint.w() == 0.0f)
+        return pickedBar;
+    QVector3D rayOrigin = nearPoint.toVector3DAffine();
+    QVector3D rayDirection = farPoint.toVector3DAffine() - rayOrigin;
+
+    QList<BarSeriesRenderCache *> visibleCaches;
+    QList<GLfloat> seriesPositions;
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        if (baseCache->isVisible()) {
+            BarSeriesRenderCache *cache = static_cast<BarSeriesRenderCache *>(baseCache);
+            if (cache->renderArray().size() != m_cachedRowCount)
+                continue;
+            visibleCaches.append(cache);
+            seriesPositions.append(m_seriesStart + m_seriesStep
+                                   * (cache->visualIndex() - (cache->visualIndex()
+                                                              * m_cachedBarSeriesMargin.width()))
+                                   + 0.5f);
+        }
+    }
+    if (visibleCaches.isEmpty())
+        return pickedBar;
+
+    // Express the ray in grid cell coordinates, where u grows with columns and v with rows
+    GLfloat spacingX = m_cachedBarSpacing.width();
+    GLfloat spacingZ = m_cachedBarSpacing.height();
+    GLfloat startU = (rayOrigin.x() * m_scaleFactor + m_rowWidth) / spacingX;
+    GLfloat startV = (m_columnDepth - rayOrigin.z() * m_scaleFactor) / spacingZ;
+    GLfloat deltaU = rayDirection.x() * m_scaleFactor / spacingX;
+    GLfloat deltaV = -rayDirection.z() * m_scaleFactor / spacingZ;
+
+    // Clip the ray to the grid, expanded by one cell to catch bars crossing the grid edges
+    GLfloat tEnter = 0.0f;
+    GLfloat tExit = 1.0f;
+    if (!clipRayToRange(startU, deltaU, -1.0f, GLfloat(m_cachedColumnCount + 1), tEnter, tExit)
+            || !clipRayToRange(startV, deltaV, -1.0f, GLfloat(m_cachedRowCount + 1),
+                               tEnter, tExit)) {
+        return pickedBar;
+    }
+
+    // Walk the crossed cells front to back
+    int cellU = int(qFloor(startU + tEnter * deltaU));
+    int cellV = int(qFloor(startV + tEnter * deltaV));
+    int stepU = (deltaU > 0.0f) ? 1 : -1;
+    int stepV = (deltaV > 0.0f) ? 1 : -1;
+    GLfloat tDeltaU = (deltaU != 0.0f) ? qAbs(1.0f / deltaU) : FLT_MAX;
+    GLfloat tDeltaV = (deltaV != 0.0f) ? qAbs(1.0f / deltaV) : FLT_MAX;
+    GLfloat tNextU = FLT_MAX;
+    GLfloat tNextV = FLT_MAX;
+    if (deltaU != 0.0f)
+        tNextU = (GLfloat(cellU + (stepU > 0 ? 1 : 0)) - startU) / deltaU;
+    if (deltaV != 0.0f)
+        tNextV = (GLfloat(cellV + (stepV > 0 ? 1 : 0)) - startV) / deltaV;
+
+    QVector3D barExtents(m_scaleX * m_seriesScaleX, 0.0f, m_scaleZ * m_seriesScaleZ);
+    GLfloat nearestHit = tExit;
+    GLfloat cellEnter = tEnter;
+    while (cellEnter <= nearestHit) {
+        // Bars may extend slightly over their cell when rotated, so neighbors are tested, too
+        int firstRow = qMax(0, cellV - 1);
+        int lastRow = qMin(m_cachedRowCount - 1, cellV + 1);
+        int firstCol = qMax(0, cellU - 1);
+        int lastCol = qMin(m_cachedColumnCount - 1, cellU + 1);
+        for (int row = firstRow; row <= lastRow; row++) {
+            GLfloat barPosZ = (m_columnDepth - (row + 0.5f) * spacingZ) / m_scaleFactor;
+            for (int col = firstCol; col <= lastCol; col++) {
+                for (int i = 0; i < visibleCaches.size(); i++) {
+                    BarSeriesRenderCache *cache = visibleCaches.at(i);
+                    const BarRenderItem &item = cache->renderArray().at(row).at(col);
+                    if (!item.value() || !item.height())
+                        continue;
+
+                    QVector3D barCenter(((col + seriesPositions.at(i)) * spacingX - m_rowWidth)
+                                        / m_scaleFactor, item.height(), barPosZ);
+                    QVector3D localOrigin = rayOrigin - barCenter;
+                    QVector3D localDirection = rayDirection;
+                    QQuaternion totalRotation = cache->meshRotation() * item.rotation();
+                    if (!totalRotation.isIdentity()) {
+                        QQuaternion inverseRotation = totalRotation.conjugated();
+                        localOrigin = inverseRotation.rotatedVector(localOrigin);
+                        localDirection = inverseRotation.rotatedVector(localDirection);
+                    }
+                    barExtents.setY(qAbs(item.height()));
+
+                    GLfloat hit = 0.0f;
+                    if (rayHitsBox(localOrigin, localDirection, barExtents, hit)
+                            && hit >= tEnter && hit < nearestHit) {
+                        nearestHit = hit;
+                        pickedBar = QPoint(row, col);
+                        *pickedCache = cache;
+                    }
+                }
+            }
+        }
+
+        if (tNextU < tNextV) {
+            cellEnter = tNextU;
+            tNextU += tDeltaU;
+            cellU += stepU;
+        } else {
+            cellEnter = tNextV;
+            tNextV += tDeltaV;
+            cellV += stepV;
+        }
+    }
+
+    return pickedBar;
+}
+
 QBar3DSeries *Bars3DRenderer::selectionColorToSeries(const QVector4D &selectionColor)
 {
     if (selectionColor == selectionSkipColor) {
@@ -2753,6 +3118,7 @@ QBar3DSeries *Bars3DRenderer::selectionColorToSeries(const QVector4D &selectionC
 
 void Bars3DRenderer::updateSlicingActive(bool isSlicing)
 {
+    invalidateBackgroundLayer();
     if (isSlicing == m_cachedIsSlicingActivated)
         return;
 
@@ -2766,6 +3132,13 @@ void Bars3DRenderer::updateSlicingActive(bool isSlicing)
 
     updateDepthBuffer(); // Re-init depth buffer as well
     m_selectionDirty = true;
+    m_sliceDirty = true;
+}
+
+void Bars3DRenderer::updateSelectionMode(QAbstract3DGraph::SelectionFlags mode)
+{
+    Abstract3DRenderer::updateSelectionMode(mode);
+    m_sliceDirty = true;
 }
 
 void Bars3DRenderer::initShaders(const QString &vertexShader, const QString &fragmentShader)
@@ -2795,12 +3168,20 @@ void Bars3DRenderer::initSelectionShader()
 
 void Bars3DRenderer::initSelectionBuffer()
 {
-    m_textureHelper->deleteTexture(&m_selectionTexture);
+    if (m_cachedIsSlicingActivated || m_primarySubViewport.size().isEmpty()) {
+        m_textureHelper->deleteTexture(&m_selectionTexture);
+        return;
+    }
 
-    if (m_cachedIsSlicingActivated || m_primarySubViewport.size().isEmpty())
+    // Selection is drawn to the bottom left corner, so a larger buffer can be kept
+    if (m_selectionTexture
+            && TextureHelper::framebufferFits(m_selectionBufferSize, m_primarySubViewport.size())) {
         return;
+    }
 
-    m_selectionTexture = m_textureHelper->createSelectionTexture(m_primarySubViewport.size(),
+    m_textureHelper->deleteTexture(&m_selectionTexture);
+    m_selectionBufferSize = TextureHelper::framebufferBucketSize(m_primarySubViewport.size());
+    m_selectionTexture = m_textureHelper->createSelectionTexture(m_selectionBufferSize,
                                                                  m_selectionFrameBuffer,
                                                                  m_selectionDepthBuffer);
 }
@@ -2818,6 +3199,8 @@ void Bars3DRenderer::initDepthShader()
 
 void Bars3DRenderer::updateDepthBuffer()
 {
+    m_shadowMapDirty = true;
+
     if (!m_isOpenGLES) {
         m_textureHelper->deleteTexture(&m_depthTexture);
 
@@ -2871,6 +3254,7 @@ void Bars3DRenderer::updateAspectRatio(float ratio)
 
 void Bars3DRenderer::updateFloorLevel(float level)
 {
+    invalidateBackgroundLayer();
     foreach (SeriesRenderCache *cache, m_renderCacheList)
         cache->setDataDirty(true);
     m_floorLevel = level;
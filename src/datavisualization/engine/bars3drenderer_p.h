@@ -47,7 +47,10 @@ private:
     // Internal state
     BarRenderItem *m_selectedBar; // points to renderitem array
     AxisRenderCache *m_sliceCache; // not owned
-    const LabelItem *m_sliceTitleItem; // not owned
+    bool m_sliceDirty;
+    int m_sliceLineIndex; // visual row or column shown in slice view
+    BarSeriesRenderCache *m_sliceSeriesCache; // not owned
+    QList<BarSeriesRenderCache *> m_seriesDrawOrder; // visible series, grouped by render state
     bool m_updateLabels;
     ShaderHelper *m_barShader;
     ShaderHelper *m_barGradientShader;
@@ -56,6 +59,7 @@ private:
     ShaderHelper *m_backgroundShader;
     GLuint m_bgrTexture;
     GLuint m_selectionTexture;
+    QSize m_selectionBufferSize;
     GLuint m_depthFrameBuffer;
     GLuint m_selectionFrameBuffer;
     GLuint m_selectionDepthBuffer;
@@ -89,6 +93,7 @@ private:
     float m_zScaleFactor;
     float m_floorLevel;
     float m_actualFloorLevel;
+    bool m_dataSnapshotsPending;
 
 public:
     explicit Bars3DRenderer(Bars3DController *controller);
@@ -98,8 +103,9 @@ public:
     void updateSeries(const QList<QAbstract3DSeries *> &seriesList) override;
     SeriesRenderCache *createNewCache(QAbstract3DSeries *series) override;
     void updateRows(const QList<Bars3DController::ChangeRow> &rows);
-    void updateItems(const QList<Bars3DController::ChangeItem> &items);
+    void updateItems(const QList<Bars3DController::ChangeItems> &items);
     void updateScene(Q3DScene *scene) override;
+    void updateSelectionMode(QAbstract3DGraph::SelectionFlags mode) override;
     void render(GLuint defaultFboHandle = 0) override;
 
     QVector3D convertPositionToTranslation(const QVector3D &position, bool isAbsolute) override;
@@ -165,11 +171,17 @@ private:
     void calculateSeriesStartPosition();
     Abstract3DController::SelectionType isSelected(int row, int bar,
                                                    const BarSeriesRenderCache *cache);
-    QPoint selectionColorToArrayPosition(const QVector4D &selectionColor);
+    QPoint selectionColorToArrayPosition(const QVector4D &selectionColor,
+                                         const QPoint &pickedBar
+                                         = Bars3DController::invalidSelectionPosition());
+    QPoint pickBar(const QMatrix4x4 &projectionViewMatrix, BarSeriesRenderCache **pickedCache);
     QBar3DSeries *selectionColorToSeries(const QVector4D &selectionColor);
 
+    void takeDataSnapshot(BarSeriesRenderCache *cache);
+    void processDataSnapshots();
     inline void updateRenderRow(const QBarDataRow *dataRow, BarRenderItemRow &renderRow);
     inline void updateRenderItem(const QBarDataItem &dataItem, BarRenderItem &renderItem);
+    void updateSliceItem(BarSeriesRenderCache *cache, int row, int bar);
 
     Q_DISABLE_COPY(Bars3DRenderer)
 };
@@ -8,7 +8,9 @@ QT_BEGIN_NAMESPACE
 BarSeriesRenderCache::BarSeriesRenderCache(QAbstract3DSeries *series,
                                            Abstract3DRenderer *renderer)
     : SeriesRenderCache(series, renderer),
-      m_visualIndex(-1)
+      m_visualIndex(-1),
+      m_dataSnapshotFirstRow(0),
+      m_hasDataSnapshot(false)
 {
 }
 
@@ -20,6 +22,7 @@ void BarSeriesRenderCache::cleanup(TextureHelper *texHelper)
 {
     m_renderArray.clear();
     m_sliceArray.clear();
+    releaseDataSnapshot();
 
     SeriesRenderCache::cleanup(texHelper);
 }
@@ -34,11 +34,29 @@ public:
     inline QList<BarRenderSliceItem> &sliceArray() { return m_sliceArray; }
     inline void setVisualIndex(int index) { m_visualIndex = index; }
     inline int visualIndex() {return m_visualIndex; }
+    inline void setDataSnapshot(const QList<QBarDataRow> &rows, int firstRow)
+    {
+        m_dataSnapshot = rows;
+        m_dataSnapshotFirstRow = firstRow;
+        m_hasDataSnapshot = true;
+    }
+    inline const QList<QBarDataRow> &dataSnapshot() const { return m_dataSnapshot; }
+    inline int dataSnapshotFirstRow() const { return m_dataSnapshotFirstRow; }
+    inline bool hasDataSnapshot() const { return m_hasDataSnapshot; }
+    inline void releaseDataSnapshot()
+    {
+        m_dataSnapshot.clear();
+        m_hasDataSnapshot = false;
+    }
 
 protected:
     BarRenderItemArray m_renderArray;
     QList<BarRenderSliceItem> m_sliceArray;
     int m_visualIndex; // order of the series is relevant
+    // Proxy rows shared at synchronization, converted to the render array at the next render
+    QList<QBarDataRow> m_dataSnapshot;
+    int m_dataSnapshotFirstRow; // proxy row index of the first snapshot row
+    bool m_hasDataSnapshot;
 };
 
 QT_END_NAMESPACE
@@ -5,11 +5,13 @@
 #include "shaderhelper_p.h"
 #include "surfaceobject_p.h"
 #include "utils_p.h"
+#include "labelimagecache_p.h"
 #include "texturehelper_p.h"
 #include "abstract3drenderer_p.h"
 #include "scatterpointbufferhelper_p.h"
 
 #include <QtGui/QMatrix4x4>
+#include <QtGui/QPainter>
 #include <QtCore/qmath.h>
 
 // Resources need to be explicitly initialized when building as static library
@@ -35,12 +37,31 @@ const GLfloat line_data[] = {
     1.0f, 0.0f, 0.0f,
 };
 
+// Corners of the label plane mesh, in the same triangle order as the mesh
+const GLfloat label_corners[] = {
+    -1.0f, 1.0f,
+    -1.0f, -1.0f,
+    1.0f, 1.0f,
+    -1.0f, -1.0f,
+    1.0f, -1.0f,
+    1.0f, 1.0f
+};
+const int labelBatchVertexSize = 5; // x, y, z, u, v
+// Smallest resolvable difference of a 24-bit depth buffer, the unit of glPolygonOffset
+const GLfloat labelDepthResolution = 1.0f / 16777216.0f;
+
 Drawer::Drawer(Q3DTheme *theme)
     : m_theme(theme),
       m_textureHelper(0),
       m_pointbuffer(0),
       m_linebuffer(0),
-      m_scaledFontSize(0.0f)
+      m_scaledFontSize(0.0f),
+      m_labelBatchActive(false),
+      m_labelBatchShader(0),
+      m_labelBatchTexture(0),
+      m_labelBatchOffsetFactor(0.0f),
+      m_labelBatchOffsetUnits(0.0f),
+      m_labelBatchBuffer(0)
 {
 }
 
@@ -50,6 +71,7 @@ Drawer::~Drawer()
     if (QOpenGLContext::currentContext()) {
         glDeleteBuffers(1, &m_pointbuffer);
         glDeleteBuffers(1, &m_linebuffer);
+        glDeleteBuffers(1, &m_labelBatchBuffer);
     }
 }
 
@@ -169,6 +191,46 @@ void Drawer::drawSelectionObject(ShaderHelper *shader, AbstractObjectHelper *obj
     glDisableVertexAttribArray(shader->posAtt());
 }
 
+void Drawer::bindObject(ShaderHelper *shader, AbstractObjectHelper *object)
+{
+    // Binds the buffers of the object once, so that several instances of it can be drawn
+    // with drawBoundObject(). Textures are left for the caller to bind.
+    glEnableVertexAttribArray(shader->posAtt());
+    glBindBuffer(GL_ARRAY_BUFFER, object->vertexBuf());
+    glVertexAttribPointer(shader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void *)0);
+
+    if (shader->normalAtt() >= 0) {
+        glEnableVertexAttribArray(shader->normalAtt());
+        glBindBuffer(GL_ARRAY_BUFFER, object->normalBuf());
+        glVertexAttribPointer(shader->normalAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void *)0);
+    }
+
+    if (shader->uvAtt() >= 0) {
+        glEnableVertexAttribArray(shader->uvAtt());
+        glBindBuffer(GL_ARRAY_BUFFER, object->uvBuf());
+        glVertexAttribPointer(shader->uvAtt(), 2, GL_FLOAT, GL_FALSE, 0, (void *)0);
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->elementBuf());
+}
+
+void Drawer::drawBoundObject(AbstractObjectHelper *object)
+{
+    glDrawElements(GL_TRIANGLES, object->indexCount(), GL_UNSIGNED_INT, (void *)0);
+}
+
+void Drawer::releaseObject(ShaderHelper *shader)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    if (shader->uvAtt() >= 0)
+        glDisableVertexAttribArray(shader->uvAtt());
+    if (shader->normalAtt() >= 0)
+        glDisableVertexAttribArray(shader->normalAtt());
+    glDisableVertexAttribArray(shader->posAtt());
+}
+
 void Drawer::drawSurfaceGrid(ShaderHelper *shader, SurfaceObject *object)
 {
     // Get grid line color
@@ -387,6 +449,41 @@ void Drawer::drawLabel(const AbstractRenderItem &item, const LabelItem &labelIte
                                 m_scaledFontSize,
                                 0.0f));
 
+    if (m_labelBatchActive && !isSelecting) {
+        // Transform the label quad here and draw it later together with the other labels
+        // that use the same texture
+        QMatrix4x4 projectionViewMatrix = projectionmatrix * viewmatrix;
+        if (m_labelBatchShader != shader || m_labelBatchTexture != labelItem.textureId()
+                || m_labelBatchProjectionView != projectionViewMatrix) {
+            flushLabelBatch();
+            m_labelBatchShader = shader;
+            m_labelBatchTexture = labelItem.textureId();
+            m_labelBatchProjectionView = projectionViewMatrix;
+            m_labelBatchInverseProjectionView = projectionViewMatrix.inverted();
+        }
+
+        QVector3D corners[6];
+        for (int i = 0; i < 6; i++) {
+            corners[i] = modelMatrix.map(QVector3D(label_corners[2 * i],
+                                                   label_corners[2 * i + 1], 0.0f));
+        }
+        if (m_labelBatchOffsetFactor != 0.0f || m_labelBatchOffsetUnits != 0.0f)
+            offsetLabelDepth(corners);
+
+        const QRectF &uvRect = labelItem.uvRect();
+        for (int i = 0; i < 12; i += 2) {
+            const QVector3D &corner = corners[i / 2];
+            m_labelBatchVertices.append(corner.x());
+            m_labelBatchVertices.append(corner.y());
+            m_labelBatchVertices.append(corner.z());
+            m_labelBatchVertices.append(uvRect.x() + (label_corners[i] + 1.0f) / 2.0f
+                                        * uvRect.width());
+            m_labelBatchVertices.append(uvRect.y() + (label_corners[i + 1] + 1.0f) / 2.0f
+                                        * uvRect.height());
+        }
+        return;
+    }
+
     MVPMatrix = projectionmatrix * viewmatrix * modelMatrix;
 
     shader->setUniformValue(shader->MVP(), MVPMatrix);
@@ -395,11 +492,120 @@ void Drawer::drawLabel(const AbstractRenderItem &item, const LabelItem &labelIte
         // Draw the selection object
         drawSelectionObject(shader, object);
     } else {
+        // Labels in an atlas sample only their own part of the shared texture.
+        // The uniform is reset afterwards, as other users of the shader expect whole textures.
+        const QRectF &uvRect = labelItem.uvRect();
+        QVector4D atlasRect(uvRect.x(), uvRect.y(), 1.0f - uvRect.width(),
+                            1.0f - uvRect.height());
+        bool inAtlas = !atlasRect.isNull();
+        if (inAtlas)
+            shader->setUniformValue(shader->atlasRect(), atlasRect);
+
         // Draw the object
         drawObject(shader, object, labelItem.textureId());
+
+        if (inAtlas)
+            shader->setUniformValue(shader->atlasRect(), QVector4D());
     }
 }
 
+void Drawer::beginLabelBatch(const QSize &viewportSize)
+{
+    // Labels drawn with drawLabel() are collected until endLabelBatch(). Labels sharing a
+    // texture atlas are then drawn with a single draw call. Selection buffer labels are
+    // not batched, as each of them needs its own color.
+    m_labelBatchActive = true;
+    m_labelBatchViewportSize = viewportSize.expandedTo(QSize(1, 1));
+    m_labelBatchOffsetFactor = 0.0f;
+    m_labelBatchOffsetUnits = 0.0f;
+}
+
+// Labels set their own polygon offset so that overlapping labels are drawn in order. Batched
+// labels are drawn together, so their offset is applied to the vertices instead.
+void Drawer::setLabelPolygonOffset(GLfloat factor, GLfloat units)
+{
+    if (m_labelBatchActive) {
+        m_labelBatchOffsetFactor = factor;
+        m_labelBatchOffsetUnits = units;
+    } else {
+        glPolygonOffset(factor, units);
+    }
+}
+
+// Moves the corners of a label quad in depth by the amount glPolygonOffset would, keeping
+// their position on screen
+void Drawer::offsetLabelDepth(QVector3D *corners)
+{
+    QVector3D ndcCorners[6];
+    for (int i = 0; i < 6; i++)
+        ndcCorners[i] = m_labelBatchProjectionView.map(corners[i]);
+
+    // The slope term uses the largest depth slope of the quad in window coordinates
+    QVector3D normal = QVector3D::crossProduct(ndcCorners[1] - ndcCorners[0],
+                                               ndcCorners[2] - ndcCorners[0]);
+    GLfloat slope = 0.0f;
+    if (!qFuzzyIsNull(normal.z())) {
+        slope = qMax(qAbs(normal.x() / normal.z()) / m_labelBatchViewportSize.width(),
+                     qAbs(normal.y() / normal.z()) / m_labelBatchViewportSize.height());
+    }
+    // Window depth spans half of the normalized device depth range
+    GLfloat offset = 2.0f * (m_labelBatchOffsetFactor * slope
+                             + m_labelBatchOffsetUnits * labelDepthResolution);
+
+    for (int i = 0; i < 6; i++) {
+        ndcCorners[i].setZ(ndcCorners[i].z() + offset);
+        corners[i] = m_labelBatchInverseProjectionView.map(ndcCorners[i]);
+    }
+}
+
+void Drawer::endLabelBatch()
+{
+    flushLabelBatch();
+    m_labelBatchActive = false;
+    m_labelBatchShader = 0;
+    m_labelBatchTexture = 0;
+}
+
+void Drawer::flushLabelBatch()
+{
+    if (m_labelBatchVertices.isEmpty())
+        return;
+
+    ShaderHelper *shader = m_labelBatchShader;
+    GLsizei stride = labelBatchVertexSize * sizeof(GLfloat);
+
+    if (!m_labelBatchBuffer)
+        glGenBuffers(1, &m_labelBatchBuffer);
+
+    // Vertices are already in world space and include their depth offset
+    shader->bind();
+    shader->setUniformValue(shader->MVP(), m_labelBatchProjectionView);
+    glPolygonOffset(0.0f, 0.0f);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_labelBatchTexture);
+    shader->setUniformValue(shader->texture(), 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_labelBatchBuffer);
+    glBufferData(GL_ARRAY_BUFFER, m_labelBatchVertices.size() * sizeof(GLfloat),
+                 m_labelBatchVertices.constData(), GL_DYNAMIC_DRAW);
+
+    glEnableVertexAttribArray(shader->posAtt());
+    glVertexAttribPointer(shader->posAtt(), 3, GL_FLOAT, GL_FALSE, stride, (void *)0);
+    glEnableVertexAttribArray(shader->uvAtt());
+    glVertexAttribPointer(shader->uvAtt(), 2, GL_FLOAT, GL_FALSE, stride,
+                          (void *)(3 * sizeof(GLfloat)));
+
+    glDrawArrays(GL_TRIANGLES, 0, m_labelBatchVertices.size() / labelBatchVertexSize);
+
+    glDisableVertexAttribArray(shader->uvAtt());
+    glDisableVertexAttribArray(shader->posAtt());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_labelBatchVertices.clear();
+}
+
 void Drawer::generateSelectionLabelTexture(Abstract3DRenderer *renderer)
 {
     LabelItem &labelItem = renderer->selectionLabelItem();
@@ -415,13 +621,13 @@ void Drawer::generateLabelItem(LabelItem &item, const QString &text, int widestL
     if (!text.isEmpty()) {
         // Create labels
         // Print label into a QImage using QPainter
-        QImage label = Utils::printTextToImage(m_theme->font(),
-                                               text,
-                                               m_theme->labelBackgroundColor(),
-                                               m_theme->labelTextColor(),
-                                               m_theme->isLabelBackgroundEnabled(),
-                                               m_theme->isLabelBorderEnabled(),
-                                               widestLabel);
+        QImage label = LabelImageCache::labelImage(m_theme->font(),
+                                                   text,
+                                                   m_theme->labelBackgroundColor(),
+                                                   m_theme->labelTextColor(),
+                                                   m_theme->isLabelBackgroundEnabled(),
+                                                   m_theme->isLabelBorderEnabled(),
+                                                   widestLabel);
 
         // Set label size
         item.setSize(label.size());
@@ -430,4 +636,89 @@ void Drawer::generateLabelItem(LabelItem &item, const QString &text, int widestL
     }
 }
 
+void Drawer::generateLabelAtlas(LabelAtlas &atlas, const QList<LabelItem *> &items,
+                                const QStringList &texts, int widestLabel)
+{
+    initializeOpenGL();
+
+    QList<QImage> labels;
+    labels.reserve(texts.size());
+    foreach (const QString &text, texts) {
+        if (text.isEmpty()) {
+            labels.append(QImage());
+        } else {
+            labels.append(LabelImageCache::labelImage(m_theme->font(),
+                                                      text,
+                                                      m_theme->labelBackgroundColor(),
+                                                      m_theme->labelTextColor(),
+                                                      m_theme->isLabelBackgroundEnabled(),
+                                                      m_theme->isLabelBorderEnabled(),
+                                                      widestLabel));
+        }
+    }
+
+    // Changed labels that fit into the places of the old ones are replaced in the texture
+    QList<int> changedLabels;
+    if (atlas.findChangedImages(labels, changedLabels)) {
+        const GLuint atlasTexture = atlas.textureId();
+        foreach (int i, changedLabels) {
+            const QImage &label = labels.at(i);
+            if (label.isNull()) {
+                items[i]->clear();
+                continue;
+            }
+            // Clear the rest of the place, in case the label got smaller
+            const QRect &slot = atlas.slot(i);
+            QImage slotImage = label;
+            if (label.size() != slot.size()) {
+                slotImage = QImage(slot.size(), QImage::Format_ARGB32);
+                slotImage.fill(Qt::transparent);
+                QPainter painter(&slotImage);
+                painter.setCompositionMode(QPainter::CompositionMode_Source);
+                painter.drawImage(0, 0, label);
+            }
+            m_textureHelper->update2DSubTexture(atlasTexture, slotImage, slot.topLeft(),
+                                                atlas.size().height());
+            items[i]->setAtlasEntry(atlasTexture, label.size(),
+                                    LabelAtlas::uvRect(QRect(slot.topLeft(), label.size()),
+                                                       atlas.size()));
+        }
+        if (!changedLabels.isEmpty()) {
+            glBindTexture(GL_TEXTURE_2D, atlasTexture);
+            glGenerateMipmap(GL_TEXTURE_2D);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+        atlas.replaceImages(labels);
+        return;
+    }
+
+    QList<QRect> rects;
+    QImage atlasImage = LabelAtlas::packImages(labels, rects);
+    if (atlasImage.isNull()) {
+        // Labels do not fit into a single texture, give each label its own texture instead
+        atlas.clear();
+        for (int i = 0; i < labels.size(); i++) {
+            items[i]->clear();
+            if (!labels.at(i).isNull()) {
+                items[i]->setSize(labels.at(i).size());
+                items[i]->setTextureId(m_textureHelper->create2DTexture(labels.at(i), true, true));
+            }
+        }
+        return;
+    }
+
+    atlas.setTextureId(m_textureHelper->create2DTexture(atlasImage, true, true));
+    // The smallest mip levels would bleed the labels into each other through the padding
+    m_textureHelper->limitMipLevels(atlas.textureId(), LabelAtlas::maxMipLevel());
+    atlas.setContents(labels, rects, atlasImage.size());
+    for (int i = 0; i < labels.size(); i++) {
+        if (labels.at(i).isNull()) {
+            items[i]->clear();
+        } else {
+            items[i]->setAtlasEntry(atlas.textureId(), labels.at(i).size(),
+                                    LabelAtlas::uvRect(rects.at(i), atlasImage.size()));
+        }
+    }
+}
+
 QT_END_NAMESPACE
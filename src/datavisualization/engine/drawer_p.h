@@ -16,10 +16,12 @@
 
 #include <private/datavisualizationglobal_p.h>
 #include <private/labelitem_p.h>
+#include <private/labelatlas_p.h>
 #include <private/abstractrenderitem_p.h>
 
 #include <QtDataVisualization/q3dbars.h>
 #include <QtDataVisualization/q3dtheme.h>
+#include <QtGui/QMatrix4x4>
 
 QT_BEGIN_NAMESPACE
 
@@ -63,6 +65,9 @@ public:
     void drawObject(ShaderHelper *shader, AbstractObjectHelper *object, GLuint textureId = 0,
                     GLuint depthTextureId = 0, GLuint textureId3D = 0);
     void drawSelectionObject(ShaderHelper *shader, AbstractObjectHelper *object);
+    void bindObject(ShaderHelper *shader, AbstractObjectHelper *object);
+    void drawBoundObject(AbstractObjectHelper *object);
+    void releaseObject(ShaderHelper *shader);
     void drawSurfaceGrid(ShaderHelper *shader, SurfaceObject *object);
     void drawPoint(ShaderHelper *shader);
     void drawPoints(ShaderHelper *shader, ScatterPointBufferHelper *object, GLuint textureId);
@@ -76,18 +81,39 @@ public:
                    Qt::Alignment alignment = Qt::AlignCenter, bool isSlicing = false,
                    bool isSelecting = false);
 
+    void beginLabelBatch(const QSize &viewportSize);
+    void endLabelBatch();
+    void setLabelPolygonOffset(GLfloat factor, GLfloat units);
+
     void generateSelectionLabelTexture(Abstract3DRenderer *item);
     void generateLabelItem(LabelItem &item, const QString &text, int widestLabel = 0);
+    void generateLabelAtlas(LabelAtlas &atlas, const QList<LabelItem *> &items,
+                            const QStringList &texts, int widestLabel = 0);
 
 Q_SIGNALS:
     void drawerChanged();
 
 private:
+    void flushLabelBatch();
+    void offsetLabelDepth(QVector3D *corners);
+
     Q3DTheme *m_theme;
     TextureHelper *m_textureHelper;
     GLuint m_pointbuffer;
     GLuint m_linebuffer;
     GLfloat m_scaledFontSize;
+
+    // Label quads collected between beginLabelBatch() and endLabelBatch()
+    bool m_labelBatchActive;
+    ShaderHelper *m_labelBatchShader;
+    GLuint m_labelBatchTexture;
+    QMatrix4x4 m_labelBatchProjectionView;
+    QMatrix4x4 m_labelBatchInverseProjectionView;
+    QSize m_labelBatchViewportSize;
+    GLfloat m_labelBatchOffsetFactor;
+    GLfloat m_labelBatchOffsetUnits;
+    QList<GLfloat> m_labelBatchVertices;
+    GLuint m_labelBatchBuffer;
 };
 
 QT_END_NAMESPACE
@@ -172,6 +172,10 @@ QAbstract3DGraph::QAbstract3DGraph(QAbstract3DGraphPrivate *d, const QSurfaceFor
     create();
 
     d_ptr->m_context->setFormat(requestedFormat());
+    // Join the global share group when the application enables it, so that graphs can share
+    // their mesh buffers
+    if (QOpenGLContext::globalShareContext())
+        d_ptr->m_context->setShareContext(QOpenGLContext::globalShareContext());
     d_ptr->m_context->create();
     bool makeSuccess = d_ptr->m_context->makeCurrent(this);
 
@@ -54,7 +54,8 @@ Scatter3DRenderer::Scatter3DRenderer(Scatter3DController *controller)
       m_havePointSeries(false),
       m_haveMeshSeries(false),
       m_haveUniformColorMeshSeries(false),
-      m_haveGradientMeshSeries(false)
+      m_haveGradientMeshSeries(false),
+      m_dataSnapshotsPending(false)
 {
     initializeOpenGL();
 }
@@ -161,16 +162,41 @@ void Scatter3DRenderer::updateData()
     calculateSceneScalingFactors();
     int totalDataSize = 0;
 
+    // Only take snapshots of the changed data here. The proxy arrays are implicitly shared, so
+    // this is cheap, and the data can be changed again as soon as the synchronization is done.
+    // Converting the data to render items is left for the next render().
     foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
         ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
         if (cache->isVisible()) {
-            const QScatter3DSeries *currentSeries = cache->series();
-            ScatterRenderItemArray &renderArray = cache->renderArray();
-            QScatterDataProxy *dataProxy = currentSeries->dataProxy();
-            const QScatterDataArray &dataArray = *dataProxy->array();
-            int dataSize = dataArray.size();
-            totalDataSize += dataSize;
+            const QScatterDataArray &dataArray = *cache->series()->dataProxy()->array();
+            totalDataSize += dataArray.size();
             if (cache->dataDirty()) {
+                cache->setDataSnapshot(dataArray);
+                cache->setDataDirty(false);
+            }
+        }
+    }
+
+    if (totalDataSize) {
+        m_dotSizeScale = GLfloat(qBound(defaultMinSize,
+                                        2.0f / float(qSqrt(qreal(totalDataSize))),
+                                        defaultMaxSize));
+    }
+
+    m_dataSnapshotsPending = true;
+}
+
+void Scatter3DRenderer::processDataSnapshots()
+{
+    m_dataSnapshotsPending = false;
+
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
+        if (cache->hasDataSnapshot()) {
+            if (cache->isVisible()) {
+                ScatterRenderItemArray &renderArray = cache->renderArray();
+                const QScatterDataArray &dataArray = cache->dataSnapshot();
+                int dataSize = dataArray.size();
                 if (dataSize != renderArray.size())
                     renderArray.resize(dataSize);
 
@@ -179,18 +205,14 @@ void Scatter3DRenderer::updateData()
 
                 if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic))
                     cache->setStaticBufferDirty(true);
-
-                cache->setDataDirty(false);
+            } else {
+                cache->setDataDirty(true);
             }
+            // Let the proxy modify its array again without copying it
+            cache->releaseDataSnapshot();
         }
     }
 
-    if (totalDataSize) {
-        m_dotSizeScale = GLfloat(qBound(defaultMinSize,
-                                        2.0f / float(qSqrt(qreal(totalDataSize))),
-                                        defaultMaxSize));
-    }
-
     if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic)) {
         foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
             ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
@@ -345,8 +367,11 @@ void Scatter3DRenderer::updateItems(const QList<Scatter3DController::ChangeItem>
             // they can be completely recalculated when they are turned visible.
             if (!cache->isVisible() && !cache->dataDirty())
                 cache->setDataDirty(true);
+            // A snapshot not yet converted is simply replaced, as it will be converted as a whole
+            if (cache->hasDataSnapshot())
+                cache->setDataSnapshot(*dataArray);
         }
-        if (cache->isVisible()) {
+        if (cache->isVisible() && !cache->hasDataSnapshot()) {
             const int index = item.index;
             if (index >= cache->renderArray().size())
                 continue; // Items removed from array for same render
@@ -443,6 +468,9 @@ void Scatter3DRenderer::resetClickedStatus()
 
 void Scatter3DRenderer::render(GLuint defaultFboHandle)
 {
+    if (m_dataSnapshotsPending)
+        processDataSnapshots();
+
     // Handle GL state setup for FBO buffers and clearing of the render surface
     Abstract3DRenderer::render(defaultFboHandle);
 
@@ -1640,6 +1668,8 @@ void Scatter3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCa
 
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        m_drawer->beginLabelBatch(m_primarySubViewport.size());
     }
 
     glEnable(GL_POLYGON_OFFSET_FILL);
@@ -1745,7 +1775,7 @@ void Scatter3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCa
         }
         float offsetValue = 0.0f;
         for (int label = startIndex; label != endIndex; label = label + indexStep) {
-            glPolygonOffset(offsetValue++ / -10.0f, 1.0f);
+            m_drawer->setLabelPolygonOffset(offsetValue++ / -10.0f, 1.0f);
             const LabelItem &axisLabelItem = *m_axisCacheZ.labelItems().at(label);
             // Draw the label here
             if (m_polarGraph) {
@@ -1915,7 +1945,7 @@ void Scatter3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCa
         }
 
         for (int label = startIndex; label != endIndex; label = label + indexStep) {
-            glPolygonOffset(offsetValue++ / -10.0f, 1.0f);
+            m_drawer->setLabelPolygonOffset(offsetValue++ / -10.0f, 1.0f);
             // Draw the label here
             if (m_polarGraph) {
                 // Calculate angular position
@@ -2068,7 +2098,7 @@ void Scatter3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCa
             const LabelItem &axisLabelItem = *m_axisCacheY.labelItems().at(label);
             float labelYTrans = m_axisCacheY.labelPosition(label);
 
-            glPolygonOffset(offsetValue++ / -10.0f, 1.0f);
+            m_drawer->setLabelPolygonOffset(offsetValue++ / -10.0f, 1.0f);
 
             if (drawSelection) {
                 QVector4D labelColor = QVector4D(0.0f, 0.0f, label / 255.0f,
@@ -2117,6 +2147,8 @@ void Scatter3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCa
                            shader);
         }
     }
+    if (!drawSelection)
+        m_drawer->endLabelBatch();
     glDisable(GL_POLYGON_OFFSET_FILL);
 }
 
@@ -2136,12 +2168,17 @@ void Scatter3DRenderer::updateSelectedItem(int index, QScatter3DSeries *series)
     }
 
     if (m_selectedSeriesCache) {
-        const ScatterRenderItemArray &renderArray = m_selectedSeriesCache->renderArray();
-        if (index < renderArray.size() && index >= 0) {
+        // The render array is updated from a pending snapshot only at the next render, which
+        // also updates the selection again
+        const bool snapshotPending = m_selectedSeriesCache->hasDataSnapshot();
+        const int itemCount = snapshotPending ? m_selectedSeriesCache->dataSnapshot().size()
+                                              : m_selectedSeriesCache->renderArray().size();
+        if (index < itemCount && index >= 0) {
             m_selectedItemIndex = index;
 
             if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic)
-                    && m_selectedSeriesCache->mesh() == QAbstract3DSeries::MeshPoint) {
+                    && m_selectedSeriesCache->mesh() == QAbstract3DSeries::MeshPoint
+                    && !snapshotPending) {
                 m_selectedSeriesCache->bufferPoints()->pushPoint(m_selectedItemIndex);
                 m_oldSelectedSeriesCache = m_selectedSeriesCache;
             }
@@ -2191,7 +2228,7 @@ void Scatter3DRenderer::updateShadowQuality(QAbstract3DGraph::ShadowQuality qual
 
 void Scatter3DRenderer::loadBackgroundMesh()
 {
-    ObjectHelper::resetObjectHelper(this, m_backgroundObj,
+    ObjectHelper::resetObjectHelper(m_backgroundObj,
                                     QStringLiteral(":/defaultMeshes/background"));
 }
 
@@ -2336,12 +2373,20 @@ void Scatter3DRenderer::initSelectionShader()
 
 void Scatter3DRenderer::initSelectionBuffer()
 {
-    m_textureHelper->deleteTexture(&m_selectionTexture);
+    if (m_primarySubViewport.size().isEmpty()) {
+        m_textureHelper->deleteTexture(&m_selectionTexture);
+        return;
+    }
 
-    if (m_primarySubViewport.size().isEmpty())
+    // Selection is drawn to the bottom left corner, so a larger buffer can be kept
+    if (m_selectionTexture
+            && TextureHelper::framebufferFits(m_selectionBufferSize, m_primarySubViewport.size())) {
         return;
+    }
 
-    m_selectionTexture = m_textureHelper->createSelectionTexture(m_primarySubViewport.size(),
+    m_textureHelper->deleteTexture(&m_selectionTexture);
+    m_selectionBufferSize = TextureHelper::framebufferBucketSize(m_primarySubViewport.size());
+    m_selectionTexture = m_textureHelper->createSelectionTexture(m_selectionBufferSize,
                                                                  m_selectionFrameBuffer,
                                                                  m_selectionDepthBuffer);
 }
@@ -47,6 +47,7 @@ private:
     ShaderHelper *m_staticGradientPointShader;
     GLuint m_bgrTexture;
     GLuint m_selectionTexture;
+    QSize m_selectionBufferSize;
     GLuint m_depthFrameBuffer;
     GLuint m_selectionFrameBuffer;
     GLuint m_selectionDepthBuffer;
@@ -66,6 +67,7 @@ private:
     bool m_haveMeshSeries;
     bool m_haveUniformColorMeshSeries;
     bool m_haveGradientMeshSeries;
+    bool m_dataSnapshotsPending;
 
 public:
     explicit Scatter3DRenderer(Scatter3DController *controller);
@@ -124,6 +126,7 @@ private:
     void initPointShader();
     void calculateTranslation(ScatterRenderItem &item);
     void calculateSceneScalingFactors();
+    void processDataSnapshots();
 
     void selectionColorToSeriesAndIndex(const QVector4D &color, int &index,
                                         QAbstract3DSeries *&series);
@@ -52,6 +52,18 @@ public:
     inline QList<int> &bufferIndices() { return m_bufferIndices; }
     inline void setVisibilityChanged(bool changed) { m_visibilityChanged = changed; }
     inline bool visibilityChanged() const { return m_visibilityChanged; }
+    inline void setDataSnapshot(const QScatterDataArray &data)
+    {
+        m_dataSnapshot = data;
+        m_hasDataSnapshot = true;
+    }
+    inline const QScatterDataArray &dataSnapshot() const { return m_dataSnapshot; }
+    inline bool hasDataSnapshot() const { return m_hasDataSnapshot; }
+    inline void releaseDataSnapshot()
+    {
+        m_dataSnapshot = QScatterDataArray();
+        m_hasDataSnapshot = false;
+    }
 
 protected:
     ScatterRenderItemArray m_renderArray;
@@ -65,6 +77,9 @@ protected:
     QList<int> m_updateIndices; // Used as temporary cache during item updates
     QList<int> m_bufferIndices; // Cache for mapping renderarray to mesh buffer
     bool m_visibilityChanged; // Used to detect if full buffer change needed
+    // Proxy data shared at synchronization, converted to the render array at the next render
+    QScatterDataArray m_dataSnapshot;
+    bool m_hasDataSnapshot;
 };
 
 QT_END_NAMESPACE
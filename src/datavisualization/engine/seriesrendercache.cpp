@@ -93,7 +93,7 @@ void SeriesRenderCache::populate(bool newSeries)
             m_renderer->fixMeshFileName(meshFileName, m_mesh);
         }
 
-        ObjectHelper::resetObjectHelper(m_renderer, m_object, meshFileName);
+        ObjectHelper::resetObjectHelper(m_object, meshFileName);
     }
 
     if (newSeries || changeTracker.meshRotationChanged) {
@@ -113,14 +113,14 @@ void SeriesRenderCache::populate(bool newSeries)
     if (newSeries || changeTracker.baseColorChanged) {
         m_baseColor = Utils::vectorFromColor(m_series->baseColor());
         if (m_series->type() == QAbstract3DSeries::SeriesTypeSurface)
-            m_renderer->generateBaseColorTexture(m_series->baseColor(), &m_baseUniformTexture);
+            m_renderer->generateBaseColorTexture(m_series->baseColor(), m_baseUniformTexture);
         changeTracker.baseColorChanged = false;
     }
 
     if (newSeries || changeTracker.baseGradientChanged) {
         QLinearGradient gradient = m_series->baseGradient();
         m_gradientImage = Utils::getGradientImage(gradient);
-        m_renderer->fixGradientAndGenerateTexture(&gradient, &m_baseGradientTexture);
+        m_renderer->fixGradientAndGenerateTexture(&gradient, m_baseGradientTexture);
         changeTracker.baseGradientChanged = false;
     }
 
@@ -131,7 +131,7 @@ void SeriesRenderCache::populate(bool newSeries)
 
     if (newSeries || changeTracker.singleHighlightGradientChanged) {
         QLinearGradient gradient = m_series->singleHighlightGradient();
-        m_renderer->fixGradientAndGenerateTexture(&gradient, &m_singleHighlightGradientTexture);
+        m_renderer->fixGradientAndGenerateTexture(&gradient, m_singleHighlightGradientTexture);
         changeTracker.singleHighlightGradientChanged = false;
     }
 
@@ -142,7 +142,7 @@ void SeriesRenderCache::populate(bool newSeries)
 
     if (newSeries || changeTracker.multiHighlightGradientChanged) {
         QLinearGradient gradient = m_series->multiHighlightGradient();
-        m_renderer->fixGradientAndGenerateTexture(&gradient, &m_multiHighlightGradientTexture);
+        m_renderer->fixGradientAndGenerateTexture(&gradient, m_multiHighlightGradientTexture);
         changeTracker.multiHighlightGradientChanged = false;
     }
 
@@ -171,13 +171,11 @@ void SeriesRenderCache::populate(bool newSeries)
 
 void SeriesRenderCache::cleanup(TextureHelper *texHelper)
 {
-    ObjectHelper::releaseObjectHelper(m_renderer, m_object);
-    if (QOpenGLContext::currentContext()) {
-        texHelper->deleteTexture(&m_baseUniformTexture);
-        texHelper->deleteTexture(&m_baseGradientTexture);
-        texHelper->deleteTexture(&m_singleHighlightGradientTexture);
-        texHelper->deleteTexture(&m_multiHighlightGradientTexture);
-    }
+    ObjectHelper::releaseObjectHelper(m_object);
+    SharedTexture::releaseSharedTexture(m_baseUniformTexture, texHelper);
+    SharedTexture::releaseSharedTexture(m_baseGradientTexture, texHelper);
+    SharedTexture::releaseSharedTexture(m_singleHighlightGradientTexture, texHelper);
+    SharedTexture::releaseSharedTexture(m_multiHighlightGradientTexture, texHelper);
 }
 
 QT_END_NAMESPACE
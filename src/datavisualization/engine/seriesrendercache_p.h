@@ -16,6 +16,7 @@
 
 #include "datavisualizationglobal_p.h"
 #include "qabstract3dseries_p.h"
+#include "sharedtexture_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -42,13 +43,25 @@ public:
     inline ObjectHelper *object() const { return m_object; }
     inline const Q3DTheme::ColorStyle &colorStyle() const { return m_colorStyle; }
     inline const QVector4D &baseColor() const { return m_baseColor; }
-    inline const GLuint &baseUniformTexture() const { return m_baseUniformTexture; }
-    inline const GLuint &baseGradientTexture() const { return m_baseGradientTexture; }
+    inline GLuint baseUniformTexture() const
+    {
+        return SharedTexture::textureId(m_baseUniformTexture);
+    }
+    inline GLuint baseGradientTexture() const
+    {
+        return SharedTexture::textureId(m_baseGradientTexture);
+    }
     inline const QImage &gradientImage() const { return m_gradientImage; }
     inline const QVector4D &singleHighlightColor() const { return m_singleHighlightColor; }
-    inline const GLuint &singleHighlightGradientTexture() const { return m_singleHighlightGradientTexture; }
+    inline GLuint singleHighlightGradientTexture() const
+    {
+        return SharedTexture::textureId(m_singleHighlightGradientTexture);
+    }
     inline const QVector4D &multiHighlightColor() const { return m_multiHighlightColor; }
-    inline const GLuint &multiHighlightGradientTexture() const { return m_multiHighlightGradientTexture; }
+    inline GLuint multiHighlightGradientTexture() const
+    {
+        return SharedTexture::textureId(m_multiHighlightGradientTexture);
+    }
     inline const QString &name() const { return m_name; }
     inline const QString &itemLabel() const { return m_itemLabel; }
     inline void setValid(bool valid) { m_valid = valid; }
@@ -67,13 +80,13 @@ protected:
 
     Q3DTheme::ColorStyle m_colorStyle;
     QVector4D m_baseColor;
-    GLuint m_baseUniformTexture;
-    GLuint m_baseGradientTexture;
+    SharedTexture *m_baseUniformTexture; // Shared reference
+    SharedTexture *m_baseGradientTexture; // Shared reference
     QImage m_gradientImage;
     QVector4D m_singleHighlightColor;
-    GLuint m_singleHighlightGradientTexture;
+    SharedTexture *m_singleHighlightGradientTexture; // Shared reference
     QVector4D m_multiHighlightColor;
-    GLuint m_multiHighlightGradientTexture;
+    SharedTexture *m_multiHighlightGradientTexture; // Shared reference
 
     QString m_name;
     QString m_itemLabel;
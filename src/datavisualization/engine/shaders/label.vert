@@ -1,4 +1,6 @@
 uniform highp mat4 MVP;
+// Offset and (1 - size) of the label within a texture atlas, zero maps to the whole texture
+uniform highp vec4 atlasRect;
 
 attribute highp vec3 vertexPosition_mdl;
 attribute highp vec2 vertexUV;
@@ -7,5 +9,5 @@ varying highp vec2 UV;
 
 void main() {
     gl_Position = MVP * vec4(vertexPosition_mdl, 1.0);
-    UV = vertexUV;
+    UV = atlasRect.xy + vertexUV * (vec2(1.0) - atlasRect.zw);
 }
@@ -4,19 +4,26 @@ varying highp vec3 pos;
 varying highp vec3 rayDir;
 
 uniform highp sampler3D textureSampler;
-uniform highp vec4 colorIndex[256];
-uniform highp int color8Bit;
 uniform highp vec3 textureDimensions;
 uniform highp int sampleCount; // This is the maximum sample count
 uniform highp float alphaMultiplier;
 uniform highp int preserveOpacity;
 uniform highp vec3 minBounds;
 uniform highp vec3 maxBounds;
+// Coarse occupancy grid of the volume, zero for bricks without any visible texels
+uniform highp sampler3D occupancySampler;
+uniform highp vec3 occupancyScale;
+uniform highp vec3 brickDimensions;
 
 // Ray traveling straight through a single 'alpha thickness' applies 100% of the encountered alpha.
 // Rays traveling shorter distances apply a fraction. This is used to normalize the alpha over
 // entire volume, regardless of texture dimensions
 const highp float alphaThicknesses = 32.0;
+// Remaining transparency that is no longer visible, the ray is terminated below this
+const highp float opacityThreshold = 1.0 / 256.0;
+
+// Defined in texture3dcolor.frag
+highp vec4 lookupColor(highp vec4 texel);
 
 void main() {
     vec3 rayStart = pos;
@@ -67,38 +74,50 @@ void main() {
     highp float extraAlphaMultiplier = fullDist * alphaThicknesses * alphaMultiplier;
 
     // nextEdges vector indicates the next edges of the texel boundaries along each axis that
-    // the ray is about to cross. The first edges are offset by a fraction of a texel to
+    // the ray is about to cross. The edges are offset by a fraction of a texel to
     // avoid artifacts from rounding errors later.
-    highp vec3 nextEdges = vec3(floor(curPos.x / textureDimensions.x) * textureDimensions.x,
-                                floor(curPos.y / textureDimensions.y) * textureDimensions.y,
-                                floor(curPos.z / textureDimensions.z) * textureDimensions.z);
-
     highp vec3 textureSteps = textureDimensions;
     highp vec3 textureOffset = textureDimensions * 0.001;
+    highp vec3 edgeOffsets = -textureOffset;
+    highp vec3 brickEdgeOffsets = -textureOffset;
     if (ray.x > 0) {
-        nextEdges.x += textureDimensions.x + textureOffset.x;
+        edgeOffsets.x += textureDimensions.x + textureOffset.x * 2.0;
+        brickEdgeOffsets.x += brickDimensions.x + textureOffset.x * 2.0;
     } else {
-        nextEdges.x -= textureOffset.x;
         textureSteps.x = -textureDimensions.x;
     }
     if (ray.y > 0) {
-        nextEdges.y += textureDimensions.y + textureOffset.y;
+        edgeOffsets.y += textureDimensions.y + textureOffset.y * 2.0;
+        brickEdgeOffsets.y += brickDimensions.y + textureOffset.y * 2.0;
     } else {
-        nextEdges.y -= textureOffset.y;
         textureSteps.y = -textureDimensions.y;
     }
     if (ray.z > 0) {
-        nextEdges.z += textureDimensions.z + textureOffset.z;
+        edgeOffsets.z += textureDimensions.z + textureOffset.z * 2.0;
+        brickEdgeOffsets.z += brickDimensions.z + textureOffset.z * 2.0;
     } else {
-        nextEdges.z -= textureOffset.z;
         textureSteps.z = -textureDimensions.z;
     }
+    highp vec3 nextEdges = floor(curPos / textureDimensions) * textureDimensions + edgeOffsets;
 
     // Raytrace into volume, need to sample pixels along the eye ray until we hit opacity 1
     for (int i = 0; i < sampleCount; i++) {
+        // Jump over bricks that contain only fully transparent texels
+        if (texture3D(occupancySampler, curPos * occupancyScale).r == 0.0) {
+            highp vec3 brickEdges = floor(curPos / brickDimensions) * brickDimensions
+                    + brickEdgeOffsets;
+            highp vec3 brickDelta = abs(brickEdges - curPos) * invAbsRay;
+            highp float skipSize = min(brickDelta.x, min(brickDelta.y, brickDelta.z));
+            curPos += skipSize * ray;
+            curLen += skipSize;
+            if (curLen >= 1.0)
+                break;
+            nextEdges = floor(curPos / textureDimensions) * textureDimensions + edgeOffsets;
+            continue;
+        }
+
         curColor = texture3D(textureSampler, curPos);
-        if (color8Bit != 0)
-            curColor = colorIndex[int(curColor.r * 255.0)];
+        curColor = lookupColor(curColor);
 
         // Find which dimension has least to go to figure out the next step distance
         highp vec3 delta = abs(nextEdges - curPos);
@@ -139,8 +158,13 @@ void main() {
             destColor.rgb += curRgb;
         }
 
-        if (curLen >= 1.0 || totalOpacity <= 0.0)
+        if (curLen >= 1.0)
+            break;
+        // Early ray termination, anything behind this point would not be visible
+        if (totalOpacity <= opacityThreshold) {
+            totalOpacity = 0.0;
             break;
+        }
     }
 
     if (totalOpacity == 1.0)
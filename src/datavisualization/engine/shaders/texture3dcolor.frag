@@ -0,0 +1,19 @@
+#version 120
+
+uniform highp vec4 colorIndex[256];
+uniform highp int color8Bit;
+
+// Linked into all volume shaders.
+// color8Bit is 1 for indexed textures and 2 for single channel textures, whose values are
+// mapped through the color table, interpolating between the adjacent entries
+highp vec4 lookupColor(highp vec4 texel) {
+    if (color8Bit == 1)
+        return colorIndex[int(texel.r * 255.0)];
+    if (color8Bit == 2) {
+        highp float index = texel.r * 255.0;
+        highp float lower = floor(index);
+        return mix(colorIndex[int(lower)], colorIndex[int(min(lower + 1.0, 255.0))],
+                   index - lower);
+    }
+    return texel;
+}
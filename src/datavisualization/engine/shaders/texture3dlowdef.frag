@@ -4,8 +4,6 @@ varying highp vec3 pos;
 varying highp vec3 rayDir;
 
 uniform highp sampler3D textureSampler;
-uniform highp vec4 colorIndex[256];
-uniform highp int color8Bit;
 uniform highp vec3 textureDimensions;
 uniform highp int sampleCount; // This is the maximum sample count
 uniform highp float alphaMultiplier;
@@ -19,6 +17,9 @@ uniform highp vec3 maxBounds;
 const highp float alphaThicknesses = 32.0;
 const highp float SQRT3 = 1.73205081;
 
+// Defined in texture3dcolor.frag
+highp vec4 lookupColor(highp vec4 texel);
+
 void main() {
     vec3 rayStart = pos;
     highp vec3 startBounds = minBounds;
@@ -70,8 +71,7 @@ void main() {
     // Raytrace into volume, need to sample pixels along the eye ray until we hit opacity 1
     for (int i = 0; i < sampleCount; i++) {
         curColor = texture3D(textureSampler, curPos);
-        if (color8Bit != 0)
-            curColor = colorIndex[int(curColor.r * 255.0)];
+        curColor = lookupColor(curColor);
 
         if (curColor.a >= 0.0) {
             if (curColor.a == 1.0 && (preserveOpacity == 1 || alphaMultiplier >= 1.0))
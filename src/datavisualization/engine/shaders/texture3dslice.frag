@@ -5,8 +5,6 @@ varying highp vec3 rayDir;
 
 uniform highp sampler3D textureSampler;
 uniform highp vec3 volumeSliceIndices;
-uniform highp vec4 colorIndex[256];
-uniform highp int color8Bit;
 uniform highp float alphaMultiplier;
 uniform highp int preserveOpacity;
 uniform highp vec3 minBounds;
@@ -16,6 +14,9 @@ const highp vec3 xPlaneNormal = vec3(1.0, 0, 0);
 const highp vec3 yPlaneNormal = vec3(0, 1.0, 0);
 const highp vec3 zPlaneNormal = vec3(0, 0, 1.0);
 
+// Defined in texture3dcolor.frag
+highp vec4 lookupColor(highp vec4 texel);
+
 void main() {
     // Find out where ray intersects the slice planes
     vec3 normRayDir = normalize(rayDir);
@@ -87,8 +88,7 @@ void main() {
                 && clamp(texelVec.z, maxBounds.z, minBounds.z) == texelVec.z) {
             texelVec = 0.5 * (texelVec + 1.0);
             curColor = texture3D(textureSampler, texelVec);
-            if (color8Bit != 0)
-                curColor = colorIndex[int(curColor.r * 255.0)];
+            curColor = lookupColor(curColor);
 
             if (curColor.a > 0.0) {
                 curAlpha = curColor.a;
@@ -107,8 +107,7 @@ void main() {
                     && clamp(texelVec.z, maxBounds.z, minBounds.z) == texelVec.z) {
                 texelVec = 0.5 * (texelVec + 1.0);
                 curColor = texture3D(textureSampler, texelVec);
-                if (color8Bit != 0)
-                    curColor = colorIndex[int(curColor.r * 255.0)];
+                curColor = lookupColor(curColor);
                 if (curColor.a > 0.0) {
                     if (curColor.a == 1.0 && preserveOpacity != 0)
                         curAlpha = 1.0;
@@ -127,8 +126,7 @@ void main() {
                     texelVec = 0.5 * (texelVec + 1.0);
                     curColor = texture3D(textureSampler, texelVec);
                     if (curColor.a > 0.0) {
-                        if (color8Bit != 0)
-                            curColor = colorIndex[int(curColor.r * 255.0)];
+                        curColor = lookupColor(curColor);
                         if (curColor.a == 1.0 && preserveOpacity != 0)
                             curAlpha = 1.0;
                         else
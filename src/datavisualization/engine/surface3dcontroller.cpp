@@ -77,9 +77,10 @@ void Surface3DController::synchDataToRenderer()
     }
 
     if (m_changeTracker.surfaceTextureChanged) {
-        m_renderer->updateSurfaceTextures(m_changedTextures);
+        m_renderer->updateSurfaceTextures(m_changedTextures, m_fullTextureChanges);
         m_changeTracker.surfaceTextureChanged = false;
         m_changedTextures.clear();
+        m_fullTextureChanges.clear();
     }
 }
 
@@ -454,13 +455,17 @@ void Surface3DController::handleRowsRemoved(int startIndex, int count)
     emitNeedRender();
 }
 
-void Surface3DController::updateSurfaceTexture(QSurface3DSeries *series)
+void Surface3DController::updateSurfaceTexture(QSurface3DSeries *series, bool streamed)
 {
     m_changeTracker.surfaceTextureChanged = true;
 
     if (!m_changedTextures.contains(series))
         m_changedTextures.append(series);
 
+    // Only updates can reuse the texture, a full change since the last sync recreates it
+    if (!streamed)
+        m_fullTextureChanges.insert(series);
+
     emitNeedRender();
 }
 
@@ -17,6 +17,8 @@
 #include <private/abstract3dcontroller_p.h>
 #include <private/datavisualizationglobal_p.h>
 
+#include <QtCore/QSet>
+
 QT_BEGIN_NAMESPACE
 
 class Surface3DRenderer;
@@ -64,6 +66,7 @@ private:
     QList<ChangeRow> m_changedRows;
     bool m_flipHorizontalGrid;
     QList<QSurface3DSeries *> m_changedTextures;
+    QSet<QSurface3DSeries *> m_fullTextureChanges;
 
 public:
     explicit Surface3DController(QRect rect, Q3DScene *scene = 0);
@@ -95,7 +98,7 @@ public:
     void setFlipHorizontalGrid(bool flip);
     bool flipHorizontalGrid() const;
 
-    void updateSurfaceTexture(QSurface3DSeries *series);
+    void updateSurfaceTexture(QSurface3DSeries *series, bool streamed = false);
 
 public Q_SLOTS:
     void handleArrayReset();
@@ -50,7 +50,8 @@ Surface3DRenderer::Surface3DRenderer(Surface3DController *controller)
       m_selectedSeries(0),
       m_clickedPosition(Surface3DController::invalidSelectionPosition()),
       m_selectionTexturesDirty(false),
-      m_noShadowTexture(0)
+      m_noShadowTexture(0),
+      m_dataSnapshotsPending(false)
 {
     // Check if flat feature is supported
     ShaderHelper tester(this, QStringLiteral(":/shaders/vertexSurfaceFlat"),
@@ -173,13 +174,32 @@ void Surface3DRenderer::getVisibleItemBounds(QVector3D &minBounds, QVector3D &ma
 void Surface3DRenderer::updateData()
 {
     calculateSceneScalingFactors();
+    m_shadowMapDirty = true;
 
+    // Only take snapshots of the changed data here. The row copies share their items with the
+    // proxy, so this is cheap, and the data can be changed again as soon as the synchronization
+    // is done. Sampling the data and building the surface is left for the next render().
     foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
         SurfaceSeriesRenderCache *cache = static_cast<SurfaceSeriesRenderCache *>(baseCache);
         if (cache->isVisible() && cache->dataDirty()) {
-            const QSurface3DSeries *currentSeries = cache->series();
-            QSurfaceDataProxy *dataProxy = currentSeries->dataProxy();
-            const QSurfaceDataArray &array = *dataProxy->array();
+            cache->setDataSnapshot(*cache->series()->dataProxy()->array());
+            cache->setDataDirty(false);
+        }
+    }
+
+    m_dataSnapshotsPending = true;
+}
+
+void Surface3DRenderer::processDataSnapshots()
+{
+    m_dataSnapshotsPending = false;
+
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        SurfaceSeriesRenderCache *cache = static_cast<SurfaceSeriesRenderCache *>(baseCache);
+        if (!cache->hasDataSnapshot())
+            continue;
+        if (cache->isVisible()) {
+            const QSurfaceDataArray &array = cache->dataSnapshot();
             QSurfaceDataArray &dataArray = cache->dataArray();
             QRect sampleSpace;
 
@@ -214,13 +234,16 @@ void Surface3DRenderer::updateData()
                 }
 
                 checkFlatSupport(cache);
-                updateObjects(cache, dimensionsChanged);
+                updateObjects(cache, dimensionsChanged, array);
                 cache->setFlatStatusDirty(false);
             } else {
                 cache->surfaceObject()->clear();
             }
-            cache->setDataDirty(false);
+        } else {
+            cache->setDataDirty(true);
         }
+        // Let the proxy modify its rows again without copying them
+        cache->releaseDataSnapshot();
     }
 
     if (m_selectionTexturesDirty && m_cachedSelectionMode > QAbstract3DGraph::SelectionNone)
@@ -245,9 +268,11 @@ void Surface3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesLis
             noSelection = false;
         }
 
-        if (cache->isFlatStatusDirty() && cache->sampleSpace().width()) {
+        // A pending snapshot rebuilds the surface with the new shading anyway
+        if (cache->isFlatStatusDirty() && cache->sampleSpace().width()
+                && !cache->hasDataSnapshot()) {
             checkFlatSupport(cache);
-            updateObjects(cache, true);
+            updateObjects(cache, true, *cache->series()->dataProxy()->array());
             cache->setFlatStatusDirty(false);
         }
     }
@@ -279,33 +304,56 @@ void Surface3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesLis
     }
 }
 
-void Surface3DRenderer::updateSurfaceTextures(QList<QSurface3DSeries *> seriesList)
+void Surface3DRenderer::updateSurfaceTextures(QList<QSurface3DSeries *> seriesList,
+                                              const QSet<QSurface3DSeries *> &recreatedList)
 {
     foreach (QSurface3DSeries *series, seriesList) {
         SurfaceSeriesRenderCache *cache =
                 static_cast<SurfaceSeriesRenderCache *>(m_renderCacheList.value(series));
         if (cache) {
-            GLuint oldTexture = cache->surfaceTexture();
-            m_textureHelper->deleteTexture(&oldTexture);
-            cache->setSurfaceTexture(0);
+            const GLuint oldTexture = cache->surfaceTexture();
+            GLuint texId = oldTexture;
+            if (recreatedList.contains(series)) {
+                m_textureHelper->deleteTexture(&texId);
+                m_textureHelper->deleteTextureStream(cache->surfaceTextureStream());
+                texId = 0;
+                if (!series->texture().isNull()) {
+                    const QImage preparedImage =
+                            TextureHelper::prepare2DTextureImage(series->texture(),
+                                                                 m_isOpenGLES);
+                    texId = m_textureHelper->createPrepared2DTexture(preparedImage,
+                                                                     true, true, true);
+                    // Lets the first update stream into the new texture
+                    cache->surfaceTextureStream().size = preparedImage.size();
+                }
+            } else {
+                // Changed only with QSurface3DSeries::updateTexture(), so the old texture
+                // is reused if it has the same size
+                texId = m_textureHelper->update2DTexture(texId, series->texture(),
+                                                         cache->surfaceTextureStream(),
+                                                         true, true, true, true);
+            }
+            cache->setSurfaceTexture(texId);
+            if (!texId)
+                continue;
+
+            glBindTexture(GL_TEXTURE_2D, texId);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glBindTexture(GL_TEXTURE_2D, 0);
+
+            // Updates of an existing texture keep the UVs. The UVs of a pending snapshot are
+            // set when it is converted.
+            if ((oldTexture && !recreatedList.contains(series)) || cache->hasDataSnapshot())
+                continue;
 
             const QSurface3DSeries *currentSeries = cache->series();
             QSurfaceDataProxy *dataProxy = currentSeries->dataProxy();
             const QSurfaceDataArray &array = *dataProxy->array();
 
-            if (!series->texture().isNull()) {
-                GLuint texId = m_textureHelper->create2DTexture(series->texture(),
-                                                                true, true, true, true);
-                glBindTexture(GL_TEXTURE_2D, texId);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-                glBindTexture(GL_TEXTURE_2D, 0);
-                cache->setSurfaceTexture(texId);
-
-                if (cache->isFlatShadingEnabled())
-                    cache->surfaceObject()->coarseUVs(array, cache->dataArray());
-                else
-                    cache->surfaceObject()->smoothUVs(array, cache->dataArray());
-            }
+            if (cache->isFlatShadingEnabled())
+                cache->surfaceObject()->coarseUVs(array, cache->dataArray());
+            else
+                cache->surfaceObject()->smoothUVs(array, cache->dataArray());
         }
     }
 }
@@ -324,9 +372,18 @@ void Surface3DRenderer::cleanCache(SeriesRenderCache *cache)
 
 void Surface3DRenderer::updateRows(const QList<Surface3DController::ChangeRow> &rows)
 {
+    QSet<SurfaceSeriesRenderCache *> retakenSnapshots;
     foreach (Surface3DController::ChangeRow item, rows) {
         SurfaceSeriesRenderCache *cache =
                 static_cast<SurfaceSeriesRenderCache *>(m_renderCacheList.value(item.series));
+        // A snapshot not yet converted is simply taken again, as it is converted as a whole
+        if (cache && cache->hasDataSnapshot()) {
+            if (!retakenSnapshots.contains(cache)) {
+                cache->setDataSnapshot(*item.series->dataProxy()->array());
+                retakenSnapshots.insert(cache);
+            }
+            continue;
+        }
         QSurfaceDataArray &dstArray = cache->dataArray();
         const QRect &sampleSpace = cache->sampleSpace();
 
@@ -360,14 +417,23 @@ void Surface3DRenderer::updateRows(const QList<Surface3DController::ChangeRow> &
         }
     }
 
+    m_shadowMapDirty = true;
     updateSelectedPoint(m_selectedPoint, m_selectedSeries);
 }
 
 void Surface3DRenderer::updateItems(const QList<Surface3DController::ChangeItem> &points)
 {
+    QSet<SurfaceSeriesRenderCache *> retakenSnapshots;
     foreach (Surface3DController::ChangeItem item, points) {
         SurfaceSeriesRenderCache *cache =
                 static_cast<SurfaceSeriesRenderCache *>(m_renderCacheList.value(item.series));
+        if (cache && cache->hasDataSnapshot()) {
+            if (!retakenSnapshots.contains(cache)) {
+                cache->setDataSnapshot(*item.series->dataProxy()->array());
+                retakenSnapshots.insert(cache);
+            }
+            continue;
+        }
         QSurfaceDataArray &dstArray = cache->dataArray();
         const QRect &sampleSpace = cache->sampleSpace();
 
@@ -402,6 +468,7 @@ void Surface3DRenderer::updateItems(const QList<Surface3DController::ChangeItem>
 
     }
 
+    m_shadowMapDirty = true;
     updateSelectedPoint(m_selectedPoint, m_selectedSeries);
 }
 
@@ -727,6 +794,9 @@ void Surface3DRenderer::updateScene(Q3DScene *scene)
 
 void Surface3DRenderer::render(GLuint defaultFboHandle)
 {
+    if (m_dataSnapshotsPending)
+        processDataSnapshots();
+
     // Handle GL state setup for FBO buffers and clearing of the render surface
     Abstract3DRenderer::render(defaultFboHandle);
 
@@ -1160,6 +1230,21 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
     GLfloat adjustedLightStrength = m_cachedTheme->lightStrength() / 10.0f;
     if (!m_isOpenGLES && m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone &&
             (!m_renderCacheList.isEmpty() || !m_customRenderCache.isEmpty())) {
+        // Get the depth view matrix
+        // It may be possible to hack lightPos here if we want to make some tweaks to shadow
+        QVector3D depthLightPos = activeCamera->d_ptr->calculatePositionRelativeToCamera(
+                    zeroVector, 0.0f, 4.0f / m_autoScaleAdjustment);
+        depthViewMatrix.lookAt(depthLightPos, zeroVector, upVector);
+
+        // Set the depth projection matrix
+        depthProjectionMatrix.perspective(10.0f, (GLfloat)m_primarySubViewport.width()
+                                          / (GLfloat)m_primarySubViewport.height(), 3.0f, 100.0f);
+        depthProjectionViewMatrix = depthProjectionMatrix * depthViewMatrix;
+    }
+
+    if (!m_isOpenGLES && m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone &&
+            (!m_renderCacheList.isEmpty() || !m_customRenderCache.isEmpty())
+            && shadowMapNeedsUpdate(depthProjectionViewMatrix)) {
         // Render scene into a depth texture for using with shadow mapping
         // Enable drawing to depth framebuffer
         glBindFramebuffer(GL_FRAMEBUFFER, m_depthFrameBuffer);
@@ -1177,17 +1262,6 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
                    m_primarySubViewport.width() * m_shadowQualityMultiplier,
                    m_primarySubViewport.height() * m_shadowQualityMultiplier);
 
-        // Get the depth view matrix
-        // It may be possible to hack lightPos here if we want to make some tweaks to shadow
-        QVector3D depthLightPos = activeCamera->d_ptr->calculatePositionRelativeToCamera(
-                    zeroVector, 0.0f, 4.0f / m_autoScaleAdjustment);
-        depthViewMatrix.lookAt(depthLightPos, zeroVector, upVector);
-
-        // Set the depth projection matrix
-        depthProjectionMatrix.perspective(10.0f, (GLfloat)m_primarySubViewport.width()
-                                          / (GLfloat)m_primarySubViewport.height(), 3.0f, 100.0f);
-        depthProjectionViewMatrix = depthProjectionMatrix * depthViewMatrix;
-
         // Surface is not closed, so don't cull anything
         glDisable(GL_CULL_FACE);
 
@@ -1923,6 +1997,8 @@ void Surface3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCa
 
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        m_drawer->beginLabelBatch(m_primarySubViewport.size());
     }
 
     glEnable(GL_POLYGON_OFFSET_FILL);
@@ -2034,7 +2110,7 @@ void Surface3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCa
         }
         float offsetValue = 0.0f;
         for (int label = startIndex; label != endIndex; label = label + indexStep) {
-            glPolygonOffset(offsetValue++ / -10.0f, 1.0f);
+            m_drawer->setLabelPolygonOffset(offsetValue++ / -10.0f, 1.0f);
             const LabelItem &axisLabelItem = *m_axisCacheZ.labelItems().at(label);
             // Draw the label here
             if (m_polarGraph) {
@@ -2208,7 +2284,7 @@ void Surface3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCa
         }
 
         for (int label = startIndex; label != endIndex; label = label + indexStep) {
-            glPolygonOffset(offsetValue++ / -10.0f, 1.0f);
+            m_drawer->setLabelPolygonOffset(offsetValue++ / -10.0f, 1.0f);
             // Draw the label here
             if (m_polarGraph) {
                 // Calculate angular position
@@ -2360,7 +2436,7 @@ void Surface3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCa
             const LabelItem &axisLabelItem = *m_axisCacheY.labelItems().at(label);
             float labelYTrans = m_axisCacheY.labelPosition(label);
 
-            glPolygonOffset(offsetValue++ / -10.0f, 1.0f);
+            m_drawer->setLabelPolygonOffset(offsetValue++ / -10.0f, 1.0f);
 
             if (drawSelection) {
                 QVector4D labelColor = QVector4D(0.0f, 0.0f, label / 255.0f,
@@ -2411,6 +2487,8 @@ void Surface3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCa
                            shader);
         }
     }
+    if (!drawSelection)
+        m_drawer->endLabelBatch();
     glDisable(GL_POLYGON_OFFSET_FILL);
 
     if (!drawSelection)
@@ -2493,10 +2571,17 @@ void Surface3DRenderer::createSelectionTexture(SurfaceSeriesRenderCache *cache,
 
 void Surface3DRenderer::initSelectionBuffer()
 {
+    // Selection is drawn to the bottom left corner, so a larger buffer can be kept
+    if (m_selectionResultTexture
+            && TextureHelper::framebufferFits(m_selectionBufferSize, m_primarySubViewport.size())) {
+        return;
+    }
+
     // Create the result selection texture and buffers
     m_textureHelper->deleteTexture(&m_selectionResultTexture);
 
-    m_selectionResultTexture = m_textureHelper->createSelectionTexture(m_primarySubViewport.size(),
+    m_selectionBufferSize = TextureHelper::framebufferBucketSize(m_primarySubViewport.size());
+    m_selectionResultTexture = m_textureHelper->createSelectionTexture(m_selectionBufferSize,
                                                                        m_selectionFrameBuffer,
                                                                        m_selectionDepthBuffer);
 }
@@ -2592,15 +2677,12 @@ void Surface3DRenderer::checkFlatSupport(SurfaceSeriesRenderCache *cache)
     }
 }
 
-void Surface3DRenderer::updateObjects(SurfaceSeriesRenderCache *cache, bool dimensionChanged)
+void Surface3DRenderer::updateObjects(SurfaceSeriesRenderCache *cache, bool dimensionChanged,
+                                      const QSurfaceDataArray &array)
 {
     QSurfaceDataArray &dataArray = cache->dataArray();
     const QRect &sampleSpace = cache->sampleSpace();
 
-    const QSurface3DSeries *currentSeries = cache->series();
-    QSurfaceDataProxy *dataProxy = currentSeries->dataProxy();
-    const QSurfaceDataArray &array = *dataProxy->array();
-
     if (cache->isFlatShadingEnabled()) {
         cache->surfaceObject()->setUpData(dataArray, sampleSpace, dimensionChanged, m_polarGraph);
         if (cache->surfaceTexture())
@@ -2633,7 +2715,7 @@ void Surface3DRenderer::resetClickedStatus()
 
 void Surface3DRenderer::loadBackgroundMesh()
 {
-    ObjectHelper::resetObjectHelper(this, m_backgroundObj,
+    ObjectHelper::resetObjectHelper(m_backgroundObj,
                                     QStringLiteral(":/defaultMeshes/background"));
 }
 
@@ -2973,6 +3055,8 @@ void Surface3DRenderer::initDepthShader()
 
 void Surface3DRenderer::updateDepthBuffer()
 {
+    m_shadowMapDirty = true;
+
     if (!m_isOpenGLES) {
         m_textureHelper->deleteTexture(&m_depthTexture);
 
@@ -50,6 +50,7 @@ private:
     GLuint m_selectionFrameBuffer;
     GLuint m_selectionDepthBuffer;
     GLuint m_selectionResultTexture;
+    QSize m_selectionBufferSize;
     GLfloat m_shadowQualityToShader;
     bool m_flatSupported;
     bool m_selectionActive;
@@ -61,6 +62,7 @@ private:
     bool m_selectionTexturesDirty;
     GLuint m_noShadowTexture;
     bool m_flipHorizontalGrid;
+    bool m_dataSnapshotsPending;
 
 public:
     explicit Surface3DRenderer(Surface3DController *controller);
@@ -68,7 +70,8 @@ public:
 
     void updateData() override;
     void updateSeries(const QList<QAbstract3DSeries *> &seriesList) override;
-    void updateSurfaceTextures(QList<QSurface3DSeries *> seriesList);
+    void updateSurfaceTextures(QList<QSurface3DSeries *> seriesList,
+                               const QSet<QSurface3DSeries *> &recreatedList);
     SeriesRenderCache *createNewCache(QAbstract3DSeries *series) override;
     void cleanCache(SeriesRenderCache *cache) override;
     void updateSelectionMode(QAbstract3DGraph::SelectionFlags mode) override;
@@ -100,7 +103,9 @@ Q_SIGNALS:
 
 private:
     void checkFlatSupport(SurfaceSeriesRenderCache *cache);
-    void updateObjects(SurfaceSeriesRenderCache *cache, bool dimensionChanged);
+    void updateObjects(SurfaceSeriesRenderCache *cache, bool dimensionChanged,
+                       const QSurfaceDataArray &array);
+    void processDataSnapshots();
     void updateSliceDataModel(const QPoint &point);
     QPoint mapCoordsToSampleSpace(SurfaceSeriesRenderCache *cache, const QPointF &coords);
     void findMatchingRow(float z, int &sample, int direction, QSurfaceDataArray &dataArray);
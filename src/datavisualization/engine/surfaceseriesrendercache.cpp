@@ -25,12 +25,14 @@ SurfaceSeriesRenderCache::SurfaceSeriesRenderCache(QAbstract3DSeries *series,
       m_mainSelectionPointer(0),
       m_slicePointerActive(false),
       m_mainPointerActive(false),
-      m_surfaceTexture(0)
+      m_surfaceTexture(0),
+      m_hasDataSnapshot(false)
 {
 }
 
 SurfaceSeriesRenderCache::~SurfaceSeriesRenderCache()
 {
+    releaseDataSnapshot();
 }
 
 void SurfaceSeriesRenderCache::populate(bool newSeries)
@@ -55,6 +57,7 @@ void SurfaceSeriesRenderCache::cleanup(TextureHelper *texHelper)
     if (QOpenGLContext::currentContext()) {
         texHelper->deleteTexture(&m_selectionTexture);
         texHelper->deleteTexture(&m_surfaceTexture);
+        texHelper->deleteTextureStream(m_surfaceTextureStream);
     }
 
     delete m_surfaceObj;
@@ -70,7 +73,26 @@ void SurfaceSeriesRenderCache::cleanup(TextureHelper *texHelper)
     delete m_sliceSelectionPointer;
     delete m_mainSelectionPointer;
 
+    releaseDataSnapshot();
+
     SeriesRenderCache::cleanup(texHelper);
 }
 
+void SurfaceSeriesRenderCache::setDataSnapshot(const QSurfaceDataArray &array)
+{
+    releaseDataSnapshot();
+    m_dataSnapshot.reserve(array.size());
+    foreach (const QSurfaceDataRow *row, array)
+        m_dataSnapshot.append(new QSurfaceDataRow(*row));
+    m_hasDataSnapshot = true;
+}
+
+void SurfaceSeriesRenderCache::releaseDataSnapshot()
+{
+    for (int i = 0; i < m_dataSnapshot.size(); i++)
+        delete m_dataSnapshot.at(i);
+    m_dataSnapshot.clear();
+    m_hasDataSnapshot = false;
+}
+
 QT_END_NAMESPACE
@@ -19,6 +19,7 @@
 #include "qsurface3dseries_p.h"
 #include "surfaceobject_p.h"
 #include "selectionpointer_p.h"
+#include "texturehelper_p.h"
 
 #include <QtGui/QMatrix4x4>
 
@@ -72,6 +73,11 @@ public:
     inline bool mainPointerActive() const { return m_mainPointerActive; }
     inline void setSurfaceTexture(GLuint texture) { m_surfaceTexture = texture; }
     inline GLuint surfaceTexture() const { return m_surfaceTexture; }
+    inline TextureStream &surfaceTextureStream() { return m_surfaceTextureStream; }
+    void setDataSnapshot(const QSurfaceDataArray &array);
+    inline const QSurfaceDataArray &dataSnapshot() const { return m_dataSnapshot; }
+    inline bool hasDataSnapshot() const { return m_hasDataSnapshot; }
+    void releaseDataSnapshot();
 
 protected:
     bool m_surfaceVisible;
@@ -93,6 +99,11 @@ protected:
     bool m_slicePointerActive;
     bool m_mainPointerActive;
     GLuint m_surfaceTexture;
+    TextureStream m_surfaceTextureStream;
+    // Copies of the proxy rows taken at synchronization, converted at the next render. The row
+    // copies share their items with the proxy rows until either is modified.
+    QSurfaceDataArray m_dataSnapshot;
+    bool m_hasDataSnapshot;
 };
 
 QT_END_NAMESPACE
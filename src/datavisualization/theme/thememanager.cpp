@@ -112,7 +112,7 @@ void ThemeManager::connectThemeSignals()
             m_controller, &Abstract3DController::handleThemeTypeChanged);
 
     connect(m_activeTheme->d_ptr.data(), &Q3DThemePrivate::needRender,
-            m_controller, &Abstract3DController::needRender);
+            m_controller, &Abstract3DController::emitNeedRender);
 }
 
 void ThemeManager::setPredefinedPropertiesToTheme(Q3DTheme *theme, Q3DTheme::Theme type)
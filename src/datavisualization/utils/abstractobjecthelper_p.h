@@ -18,7 +18,7 @@
 
 QT_BEGIN_NAMESPACE
 
-class AbstractObjectHelper: protected QOpenGLFunctions
+class Q_DATAVISUALIZATION_EXPORT AbstractObjectHelper: protected QOpenGLFunctions
 {
 protected:
     AbstractObjectHelper();
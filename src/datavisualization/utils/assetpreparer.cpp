@@ -0,0 +1,196 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "assetpreparer_p.h"
+#include "meshcache_p.h"
+#include "texturehelper_p.h"
+
+#include <QtCore/QMutexLocker>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+
+QT_BEGIN_NAMESPACE
+
+// Shared between the preparer and its jobs, so that jobs finishing after the preparer has
+// been deleted have somewhere to go
+struct AssetPreparerState
+{
+    AssetPreparerState()
+        : owner(0),
+          serial(0)
+    {
+    }
+
+    QMutex mutex;
+    AssetPreparer *owner;
+    quint64 serial;
+    QHash<CustomRenderItem *, quint64> pendingTextures;
+    QHash<CustomRenderItem *, quint64> pendingMeshes;
+    QList<AssetPreparer::PreparedTexture> preparedTextures;
+    QList<AssetPreparer::PreparedMesh> preparedMeshes;
+};
+
+class TexturePreparationJob : public QRunnable
+{
+public:
+    TexturePreparationJob(const QSharedPointer<AssetPreparerState> &state,
+                          CustomRenderItem *item, quint64 serial, const QImage &image,
+                          bool isOpenGLES, bool streamed)
+        : m_state(state),
+          m_item(item),
+          m_serial(serial),
+          m_image(image),
+          m_isOpenGLES(isOpenGLES),
+          m_streamed(streamed)
+    {
+    }
+
+    void run() override
+    {
+        AssetPreparer::PreparedTexture prepared;
+        prepared.item = m_item;
+        prepared.blendNeeded = m_image.hasAlphaChannel();
+        prepared.streamed = m_streamed;
+        // Same preparation as TextureHelper::create2DTexture() does for custom item textures
+        prepared.image = TextureHelper::prepare2DTextureImage(m_image, m_isOpenGLES, true, true);
+        m_image = QImage();
+
+        QMutexLocker locker(&m_state->mutex);
+        if (m_state->pendingTextures.value(m_item) != m_serial)
+            return; // Cancelled or superseded by a newer request
+        m_state->pendingTextures.remove(m_item);
+        m_state->preparedTextures.append(prepared);
+        if (m_state->owner)
+            emit m_state->owner->assetReady();
+    }
+
+private:
+    QSharedPointer<AssetPreparerState> m_state;
+    CustomRenderItem *m_item;
+    quint64 m_serial;
+    QImage m_image;
+    bool m_isOpenGLES;
+    bool m_streamed;
+};
+
+class MeshPreparationJob : public QRunnable
+{
+public:
+    MeshPreparationJob(const QSharedPointer<AssetPreparerState> &state, CustomRenderItem *item,
+                       quint64 serial, const QString &meshFile)
+        : m_state(state),
+          m_item(item),
+          m_serial(serial),
+          m_meshFile(meshFile)
+    {
+    }
+
+    void run() override
+    {
+        // Loading the mesh into the process wide cache is the expensive part, the renderer
+        // then only needs to create the buffers from the cached data
+        MeshCache::preload(m_meshFile);
+
+        QMutexLocker locker(&m_state->mutex);
+        if (m_state->pendingMeshes.value(m_item) != m_serial)
+            return; // Cancelled or superseded by a newer request
+        m_state->pendingMeshes.remove(m_item);
+        AssetPreparer::PreparedMesh prepared;
+        prepared.item = m_item;
+        prepared.meshFile = m_meshFile;
+        m_state->preparedMeshes.append(prepared);
+        if (m_state->owner)
+            emit m_state->owner->assetReady();
+    }
+
+private:
+    QSharedPointer<AssetPreparerState> m_state;
+    CustomRenderItem *m_item;
+    quint64 m_serial;
+    QString m_meshFile;
+};
+
+AssetPreparer::AssetPreparer(QObject *parent)
+    : QObject(parent),
+      m_state(new AssetPreparerState)
+{
+    m_state->owner = this;
+}
+
+AssetPreparer::~AssetPreparer()
+{
+    // Jobs still running will find no owner and no pending requests, so they just finish
+    QMutexLocker locker(&m_state->mutex);
+    m_state->owner = 0;
+    m_state->pendingTextures.clear();
+    m_state->pendingMeshes.clear();
+    m_state->preparedTextures.clear();
+    m_state->preparedMeshes.clear();
+}
+
+void AssetPreparer::prepareTexture(CustomRenderItem *item, const QImage &image, bool isOpenGLES,
+                                   bool streamed)
+{
+    quint64 serial;
+    {
+        QMutexLocker locker(&m_state->mutex);
+        serial = ++m_state->serial;
+        m_state->pendingTextures.insert(item, serial);
+        // Drop any earlier result that has not been taken yet
+        for (int i = m_state->preparedTextures.size() - 1; i >= 0; i--) {
+            if (m_state->preparedTextures.at(i).item == item)
+                m_state->preparedTextures.removeAt(i);
+        }
+    }
+    QThreadPool::globalInstance()->start(new TexturePreparationJob(m_state, item, serial, image,
+                                                                   isOpenGLES, streamed));
+}
+
+void AssetPreparer::prepareMesh(CustomRenderItem *item, const QString &meshFile)
+{
+    quint64 serial;
+    {
+        QMutexLocker locker(&m_state->mutex);
+        serial = ++m_state->serial;
+        m_state->pendingMeshes.insert(item, serial);
+        for (int i = m_state->preparedMeshes.size() - 1; i >= 0; i--) {
+            if (m_state->preparedMeshes.at(i).item == item)
+                m_state->preparedMeshes.removeAt(i);
+        }
+    }
+    QThreadPool::globalInstance()->start(new MeshPreparationJob(m_state, item, serial,
+                                                                meshFile));
+}
+
+void AssetPreparer::cancel(CustomRenderItem *item)
+{
+    QMutexLocker locker(&m_state->mutex);
+    m_state->pendingTextures.remove(item);
+    m_state->pendingMeshes.remove(item);
+    for (int i = m_state->preparedTextures.size() - 1; i >= 0; i--) {
+        if (m_state->preparedTextures.at(i).item == item)
+            m_state->preparedTextures.removeAt(i);
+    }
+    for (int i = m_state->preparedMeshes.size() - 1; i >= 0; i--) {
+        if (m_state->preparedMeshes.at(i).item == item)
+            m_state->preparedMeshes.removeAt(i);
+    }
+}
+
+QList<AssetPreparer::PreparedTexture> AssetPreparer::takePreparedTextures()
+{
+    QMutexLocker locker(&m_state->mutex);
+    QList<PreparedTexture> prepared = m_state->preparedTextures;
+    m_state->preparedTextures.clear();
+    return prepared;
+}
+
+QList<AssetPreparer::PreparedMesh> AssetPreparer::takePreparedMeshes()
+{
+    QMutexLocker locker(&m_state->mutex);
+    QList<PreparedMesh> prepared = m_state->preparedMeshes;
+    m_state->preparedMeshes.clear();
+    return prepared;
+}
+
+QT_END_NAMESPACE
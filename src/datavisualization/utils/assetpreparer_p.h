@@ -0,0 +1,71 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef ASSETPREPARER_P_H
+#define ASSETPREPARER_P_H
+
+#include "datavisualizationglobal_p.h"
+#include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
+#include <QtGui/QImage>
+
+QT_BEGIN_NAMESPACE
+
+class CustomRenderItem;
+struct AssetPreparerState;
+
+// Prepares custom item assets on worker threads. The CPU side work (texture scaling and
+// format conversion, mesh parsing and indexing) is done in the global thread pool, and the
+// renderer picks up the finished results with takePreparedTextures() and
+// takePreparedMeshes() on its own thread, where it does the actual upload. Until then the
+// item keeps drawing its previous texture or mesh. Only the latest request for each item is
+// delivered, older results are dropped.
+class AssetPreparer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct PreparedTexture {
+        CustomRenderItem *item;
+        QImage image;
+        bool blendNeeded;
+        bool streamed;
+    };
+
+    struct PreparedMesh {
+        CustomRenderItem *item;
+        QString meshFile;
+    };
+
+    explicit AssetPreparer(QObject *parent = 0);
+    ~AssetPreparer();
+
+    void prepareTexture(CustomRenderItem *item, const QImage &image, bool isOpenGLES,
+                        bool streamed = false);
+    void prepareMesh(CustomRenderItem *item, const QString &meshFile);
+    void cancel(CustomRenderItem *item);
+
+    QList<PreparedTexture> takePreparedTextures();
+    QList<PreparedMesh> takePreparedMeshes();
+
+Q_SIGNALS:
+    // Emitted from a worker thread when a result is ready to be taken
+    void assetReady();
+
+private:
+    QSharedPointer<AssetPreparerState> m_state;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -0,0 +1,75 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "contextgroupcache_p.h"
+#include "objecthelper_p.h"
+#include "sharedtexture_p.h"
+
+#include <QtCore/QMutex>
+#include <QtGui/QOpenGLContext>
+
+QT_BEGIN_NAMESPACE
+
+static QHash<const QObject *, ContextGroupCache *> cacheTable;
+static QMutex cacheMutex;
+
+ContextGroupCache::ContextGroupCache(QOpenGLContextGroup *group)
+    : m_group(group)
+{
+}
+
+QMutex *ContextGroupCache::mutex()
+{
+    return &cacheMutex;
+}
+
+ContextGroupCache *ContextGroupCache::current()
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    QOpenGLContextGroup *contextGroup = context ? context->shareGroup() : 0;
+    if (!contextGroup)
+        return 0;
+
+    ContextGroupCache *cache = cacheTable.value(contextGroup, 0);
+    if (!cache) {
+        cache = new ContextGroupCache(contextGroup);
+        cacheTable.insert(contextGroup, cache);
+        // The group is its own receiver, so the handler cannot outlive it
+        QObject::connect(contextGroup, &QObject::destroyed, contextGroup,
+                         &ContextGroupCache::handleContextGroupDestroyed);
+    }
+    return cache;
+}
+
+void ContextGroupCache::finishUpload()
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (context && m_group->shares().size() > 1)
+        context->functions()->glFinish();
+}
+
+// The resources die with the last context of the group. Objects and textures still referenced
+// by renderers forget them, so that deleting them later does not delete resources of another
+// context that happen to have the same names.
+void ContextGroupCache::handleContextGroupDestroyed(QObject *group)
+{
+    QMutexLocker locker(&cacheMutex);
+    ContextGroupCache *cache = cacheTable.take(group);
+    if (!cache)
+        return;
+
+    foreach (ObjectHelper *obj, cache->m_objects) {
+        obj->m_vertexbuffer = 0;
+        obj->m_uvbuffer = 0;
+        obj->m_normalbuffer = 0;
+        obj->m_elementbuffer = 0;
+        obj->m_cache = 0;
+    }
+    foreach (SharedTexture *texture, cache->m_textures) {
+        texture->m_textureId = 0;
+        texture->m_cache = 0;
+    }
+    delete cache;
+}
+
+QT_END_NAMESPACE
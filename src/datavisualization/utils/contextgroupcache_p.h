@@ -0,0 +1,55 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef CONTEXTGROUPCACHE_P_H
+#define CONTEXTGROUPCACHE_P_H
+
+#include "datavisualizationglobal_p.h"
+#include <QtCore/QHash>
+
+QT_BEGIN_NAMESPACE
+
+class QMutex;
+class QOpenGLContextGroup;
+class ObjectHelper;
+class SharedTexture;
+
+// The meshes and textures shared by all renderers whose contexts share resources, for example
+// all graphs in the same Qt Quick window. Graphs in different windows may render in different
+// threads and still share a group, so the tables must only be used with mutex() locked.
+// The tables of a group live as long as the group.
+class ContextGroupCache
+{
+public:
+    static QMutex *mutex();
+    // Returns the tables of the group of the current context, or 0 if there is no context
+    static ContextGroupCache *current();
+
+    // Contexts of other threads may use new resources right away, so they must be complete
+    void finishUpload();
+
+    inline QHash<QString, ObjectHelper *> &objects() { return m_objects; }
+    inline QHash<QString, SharedTexture *> &textures() { return m_textures; }
+
+private:
+    ContextGroupCache(QOpenGLContextGroup *group);
+    static void handleContextGroupDestroyed(QObject *group);
+
+    QOpenGLContextGroup *m_group;
+    QHash<QString, ObjectHelper *> m_objects;
+    QHash<QString, SharedTexture *> m_textures;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -0,0 +1,135 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "labelimagecache_p.h"
+#include "utils_p.h"
+
+#include <QtCore/QCache>
+#include <QtCore/QMutexLocker>
+#include <QtGui/QFont>
+
+QT_BEGIN_NAMESPACE
+
+// Widest label widths are rounded up to this step, so that small changes in the widest
+// label of an axis do not invalidate all of its labels
+const int labelWidthStep = 16;
+const int defaultMaxCost = 32 * 1024; // in kilobytes
+
+struct LabelImageKey
+{
+    QString text;
+    QFont font;
+    QRgb bgrColor;
+    QRgb txtColor;
+    bool labelBackground;
+    bool borders;
+    int maxLabelWidth;
+
+    bool operator==(const LabelImageKey &other) const
+    {
+        return text == other.text && font == other.font && bgrColor == other.bgrColor
+                && txtColor == other.txtColor && labelBackground == other.labelBackground
+                && borders == other.borders && maxLabelWidth == other.maxLabelWidth;
+    }
+};
+
+static size_t qHash(const LabelImageKey &key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.text, key.font, key.bgrColor, key.txtColor,
+                      key.labelBackground, key.borders, key.maxLabelWidth);
+}
+
+struct LabelImageCacheData
+{
+    LabelImageCacheData()
+        : cache(defaultMaxCost),
+          hits(0),
+          misses(0)
+    {
+    }
+
+    QMutex mutex;
+    QCache<LabelImageKey, QImage> cache;
+    int hits;
+    int misses;
+};
+
+Q_GLOBAL_STATIC(LabelImageCacheData, cacheData)
+
+QImage LabelImageCache::labelImage(const QFont &font, const QString &text,
+                                   const QColor &bgrColor, const QColor &txtColor,
+                                   bool labelBackground, bool borders, int maxLabelWidth)
+{
+    // The widest label width only affects the image when it is used by printTextToImage
+    if (!labelBackground && !Utils::isOpenGLES())
+        maxLabelWidth = 0;
+    else if (maxLabelWidth)
+        maxLabelWidth = ((maxLabelWidth + labelWidthStep - 1) / labelWidthStep) * labelWidthStep;
+
+    LabelImageKey key;
+    key.text = text;
+    key.font = font;
+    key.bgrColor = bgrColor.rgba();
+    key.txtColor = txtColor.rgba();
+    key.labelBackground = labelBackground;
+    key.borders = borders;
+    key.maxLabelWidth = maxLabelWidth;
+
+    LabelImageCacheData *data = cacheData();
+    {
+        QMutexLocker locker(&data->mutex);
+        if (QImage *image = data->cache.object(key)) {
+            data->hits++;
+            return *image;
+        }
+        data->misses++;
+    }
+
+    // Paint outside the lock, so that other threads are not blocked by it
+    QImage image = Utils::printTextToImage(font, text, bgrColor, txtColor, labelBackground,
+                                           borders, maxLabelWidth);
+    if (!image.isNull()) {
+        QMutexLocker locker(&data->mutex);
+        data->cache.insert(key, new QImage(image), qMax(1, int(image.sizeInBytes() / 1024)));
+    }
+    return image;
+}
+
+void LabelImageCache::setMaxCost(int kiloBytes)
+{
+    LabelImageCacheData *data = cacheData();
+    QMutexLocker locker(&data->mutex);
+    data->cache.setMaxCost(kiloBytes);
+}
+
+int LabelImageCache::maxCost()
+{
+    LabelImageCacheData *data = cacheData();
+    QMutexLocker locker(&data->mutex);
+    return data->cache.maxCost();
+}
+
+int LabelImageCache::hitCount()
+{
+    LabelImageCacheData *data = cacheData();
+    QMutexLocker locker(&data->mutex);
+    return data->hits;
+}
+
+int LabelImageCache::missCount()
+{
+    LabelImageCacheData *data = cacheData();
+    QMutexLocker locker(&data->mutex);
+    return data->misses;
+}
+
+void LabelImageCache::clear()
+{
+    LabelImageCacheData *data = cacheData();
+    QMutexLocker locker(&data->mutex);
+    data->cache.clear();
+    data->hits = 0;
+    data->misses = 0;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,46 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef LABELIMAGECACHE_P_H
+#define LABELIMAGECACHE_P_H
+
+#include "datavisualizationglobal_p.h"
+#include <QtGui/QImage>
+
+QT_BEGIN_NAMESPACE
+
+// Process wide least recently used cache of rendered label images. Painting the label text
+// is the expensive part of label generation, so labels with identical text and style are
+// only painted once, regardless of which graph, axis or custom label asks for them.
+// The images are not tied to any OpenGL context, so each renderer still uploads its own
+// textures from them.
+class Q_DATAVISUALIZATION_EXPORT LabelImageCache
+{
+public:
+    static QImage labelImage(const QFont &font, const QString &text, const QColor &bgrColor,
+                             const QColor &txtColor, bool labelBackground, bool borders = false,
+                             int maxLabelWidth = 0);
+
+    // Memory budget of the cached images. The least recently used images are evicted to
+    // stay within it.
+    static void setMaxCost(int kiloBytes);
+    static int maxCost();
+    // Number of labelImage() calls answered from the cache and painted, since the last clear()
+    static int hitCount();
+    static int missCount();
+    static void clear();
+};
+
+QT_END_NAMESPACE
+
+#endif
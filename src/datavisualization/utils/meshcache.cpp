@@ -0,0 +1,151 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "meshcache_p.h"
+#include "meshloader_p.h"
+#include "vertexindexer_p.h"
+
+#include <QtCore/QCache>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+
+QT_BEGIN_NAMESPACE
+
+const int defaultMaxCost = 64 * 1024; // in kilobytes
+
+struct MeshCacheKey
+{
+    QString objectFile;
+    QDateTime lastModified;
+    qint64 size;
+
+    bool operator==(const MeshCacheKey &other) const
+    {
+        return objectFile == other.objectFile && lastModified == other.lastModified
+                && size == other.size;
+    }
+};
+
+static size_t qHash(const MeshCacheKey &key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.objectFile, key.lastModified, key.size);
+}
+
+struct MeshData
+{
+    QList<GLuint> indices;
+    QList<QVector3D> indexedVertices;
+    QList<QVector2D> indexedUVs;
+    QList<QVector3D> indexedNormals;
+};
+
+struct MeshCacheData
+{
+    MeshCacheData()
+        : cache(defaultMaxCost)
+    {
+    }
+
+    QMutex mutex;
+    QCache<MeshCacheKey, MeshData> cache;
+};
+
+Q_GLOBAL_STATIC(MeshCacheData, cacheData)
+
+static bool loadMeshData(const QString &objectFile, MeshData &data)
+{
+    QByteArray header;
+    {
+        QFile file(objectFile);
+        if (file.open(QIODevice::ReadOnly))
+            header = file.peek(4);
+    }
+
+    if (MeshLoader::isBinaryMesh(header)) {
+        return MeshLoader::loadMesh(objectFile, data.indices, data.indexedVertices,
+                                    data.indexedUVs, data.indexedNormals);
+    }
+
+    QList<QVector3D> vertices;
+    QList<QVector2D> uvs;
+    QList<QVector3D> normals;
+    if (!MeshLoader::loadOBJ(objectFile, vertices, uvs, normals))
+        return false;
+
+    VertexIndexer::indexVBO(vertices, uvs, normals, data.indices, data.indexedVertices,
+                            data.indexedUVs, data.indexedNormals);
+    return true;
+}
+
+static MeshCacheKey cacheKey(const QString &objectFile)
+{
+    // Files on disk may be changed between loads, so they are keyed by their time stamp and
+    // size as well. Resources cannot change.
+    MeshCacheKey key;
+    key.objectFile = objectFile;
+    key.size = 0;
+    if (!objectFile.startsWith(QLatin1Char(':'))) {
+        QFileInfo fileInfo(objectFile);
+        key.lastModified = fileInfo.lastModified();
+        key.size = fileInfo.size();
+    }
+    return key;
+}
+
+bool MeshCache::mesh(const QString &objectFile, QList<GLuint> &indices,
+                     QList<QVector3D> &indexedVertices, QList<QVector2D> &indexedUVs,
+                     QList<QVector3D> &indexedNormals)
+{
+    const MeshCacheKey key = cacheKey(objectFile);
+
+    MeshCacheData *cache = cacheData();
+    {
+        QMutexLocker locker(&cache->mutex);
+        if (MeshData *data = cache->cache.object(key)) {
+            indices = data->indices;
+            indexedVertices = data->indexedVertices;
+            indexedUVs = data->indexedUVs;
+            indexedNormals = data->indexedNormals;
+            return true;
+        }
+    }
+
+    // Load outside the lock, so that other threads are not blocked by it
+    MeshData *data = new MeshData;
+    if (!loadMeshData(objectFile, *data) || data->indices.isEmpty()) {
+        delete data;
+        return false;
+    }
+
+    indices = data->indices;
+    indexedVertices = data->indexedVertices;
+    indexedUVs = data->indexedUVs;
+    indexedNormals = data->indexedNormals;
+
+    const qsizetype bytes = data->indices.size() * sizeof(GLuint)
+            + data->indexedVertices.size() * (2 * sizeof(QVector3D) + sizeof(QVector2D));
+    QMutexLocker locker(&cache->mutex);
+    cache->cache.insert(key, data, qMax(1, int(bytes / 1024)));
+    return true;
+}
+
+bool MeshCache::preload(const QString &objectFile)
+{
+    QList<GLuint> indices;
+    QList<QVector3D> indexedVertices;
+    QList<QVector2D> indexedUVs;
+    QList<QVector3D> indexedNormals;
+    return mesh(objectFile, indices, indexedVertices, indexedUVs, indexedNormals);
+}
+
+bool MeshCache::isCached(const QString &objectFile)
+{
+    const MeshCacheKey key = cacheKey(objectFile);
+    MeshCacheData *cache = cacheData();
+    QMutexLocker locker(&cache->mutex);
+    return cache->cache.contains(key);
+}
+
+QT_END_NAMESPACE
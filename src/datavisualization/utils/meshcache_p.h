@@ -0,0 +1,37 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef MESHCACHE_P_H
+#define MESHCACHE_P_H
+
+#include "datavisualizationglobal_p.h"
+#include <QtGui/QVector2D>
+
+QT_BEGIN_NAMESPACE
+
+// Process wide cache of loaded and indexed mesh data. Every renderer needs its own buffer
+// objects, but the parsing and indexing of a mesh file only needs to happen once, no matter
+// how many graphs use it. The cached lists are implicitly shared with the callers.
+class MeshCache
+{
+public:
+    static bool mesh(const QString &objectFile, QList<GLuint> &indices,
+                     QList<QVector3D> &indexedVertices, QList<QVector2D> &indexedUVs,
+                     QList<QVector3D> &indexedNormals);
+    static bool preload(const QString &objectFile);
+    static bool isCached(const QString &objectFile);
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -4,94 +4,370 @@
 #include "meshloader_p.h"
 
 #include <QtCore/QFile>
-#include <QtCore/QStringList>
 #include <QtCore/QList>
+#include <QtCore/QVarLengthArray>
+#include <QtCore/QtEndian>
+#include <QtCore/qmath.h>
 #include <QtGui/QVector2D>
 
+#include <cstring>
+
 QT_BEGIN_NAMESPACE
 
-QString slashTag = QStringLiteral("/");
+// Precompiled mesh format, see tools/meshconverter/obj2mesh.py
+static const char meshMagic[] = {'Q', 'D', 'V', 'M'};
+const quint32 meshVersion = 1;
+const int meshHeaderSize = 16;
+
+// The .obj parser works directly on the raw file data, one line at a time, without
+// converting anything to QString. Unknown statements (o, s, g, usemtl, ...) are skipped.
+
+struct ObjCorner {
+    int vertex;
+    int uv;
+    int normal;
+};
+
+static inline bool isObjSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline bool isObjDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static inline const char *skipObjSpaces(const char *p, const char *end)
+{
+    while (p < end && isObjSpace(*p))
+        ++p;
+    return p;
+}
+
+static double powerOfTen(int exponent)
+{
+    // Powers of ten up to 10^22 are exact in double precision
+    static const double exactPowers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    if (exponent <= 22)
+        return exactPowers[exponent];
+    return qPow(10.0, exponent);
+}
+
+static bool parseObjFloat(const char *&p, const char *end, float &value)
+{
+    const char *s = p;
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+')) {
+        negative = (*s == '-');
+        ++s;
+    }
+
+    // Up to 19 significant digits fit in the mantissa, which is plenty for a float
+    quint64 mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    while (s < end && isObjDigit(*s)) {
+        if (significantDigits < 19) {
+            mantissa = mantissa * 10 + quint64(*s - '0');
+            if (mantissa)
+                significantDigits++;
+        } else {
+            exponent++;
+        }
+        hasDigits = true;
+        ++s;
+    }
+    if (s < end && *s == '.') {
+        ++s;
+        while (s < end && isObjDigit(*s)) {
+            if (significantDigits < 19) {
+                mantissa = mantissa * 10 + quint64(*s - '0');
+                if (mantissa)
+                    significantDigits++;
+                exponent--;
+            }
+            hasDigits = true;
+            ++s;
+        }
+    }
+    if (!hasDigits)
+        return false;
+
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        const char *e = s + 1;
+        bool negativeExponent = false;
+        if (e < end && (*e == '-' || *e == '+')) {
+            negativeExponent = (*e == '-');
+            ++e;
+        }
+        if (e < end && isObjDigit(*e)) {
+            int fileExponent = 0;
+            while (e < end && isObjDigit(*e)) {
+                if (fileExponent < 10000)
+                    fileExponent = fileExponent * 10 + (*e - '0');
+                ++e;
+            }
+            exponent += negativeExponent ? -fileExponent : fileExponent;
+            s = e;
+        }
+    }
+    if (s < end && !isObjSpace(*s))
+        return false;
+
+    double result = double(mantissa);
+    if (mantissa && exponent < 0)
+        result /= powerOfTen(-exponent);
+    else if (mantissa && exponent > 0)
+        result *= powerOfTen(exponent);
+    value = float(negative ? -result : result);
+    p = s;
+    return true;
+}
+
+static bool parseObjIndex(const char *&p, const char *end, int count, int &index)
+{
+    const char *s = p;
+    bool negative = false;
+    if (s < end && *s == '-') {
+        negative = true;
+        ++s;
+    }
+    if (s == end || !isObjDigit(*s))
+        return false;
+    qint64 value = 0;
+    while (s < end && isObjDigit(*s)) {
+        if (value <= count)
+            value = value * 10 + (*s - '0');
+        ++s;
+    }
+
+    // Indices are one based, negative indices are relative to the end of the list
+    if (negative)
+        value = count - value;
+    else
+        value = value - 1;
+    if (value < 0 || value >= count)
+        return false;
+    index = int(value);
+    p = s;
+    return true;
+}
+
+static bool parseObjCorner(const char *&p, const char *end, int vertexCount, int uvCount,
+                           int normalCount, ObjCorner &corner)
+{
+    // Accepts v, v/vt, v//vn and v/vt/vn
+    corner.uv = -1;
+    corner.normal = -1;
+    if (!parseObjIndex(p, end, vertexCount, corner.vertex))
+        return false;
+    if (p < end && *p == '/') {
+        ++p;
+        if (p < end && *p != '/' && !isObjSpace(*p)) {
+            if (!parseObjIndex(p, end, uvCount, corner.uv))
+                return false;
+        }
+        if (p < end && *p == '/') {
+            ++p;
+            if (!parseObjIndex(p, end, normalCount, corner.normal))
+                return false;
+        }
+    }
+    return p == end || isObjSpace(*p);
+}
+
+static inline bool isObjKeyword(const char *p, const char *keywordEnd, const char *keyword,
+                                int length)
+{
+    return keywordEnd - p == length && !memcmp(p, keyword, length);
+}
 
 bool MeshLoader::loadOBJ(const QString &path, QList<QVector3D> &out_vertices,
                          QList<QVector2D> &out_uvs, QList<QVector3D> &out_normals)
 {
-    QList<unsigned int> vertexIndices, uvIndices, normalIndices;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning("Cannot open the file %s", qPrintable(path));
+        return false;
+    }
+
+    // Map the file where possible, large meshes are not copied into memory that way
+    QByteArray contents;
+    qint64 size = file.size();
+    const char *data = reinterpret_cast<const char *>(file.map(0, size));
+    if (!data) {
+        contents = file.readAll();
+        data = contents.constData();
+        size = contents.size();
+    }
+    const char *const end = data + size;
+
     QList<QVector3D> temp_vertices;
     QList<QVector2D> temp_uvs;
     QList<QVector3D> temp_normals;
+    QList<ObjCorner> corners;
+    QVarLengthArray<ObjCorner, 8> polygon;
 
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning("Cannot open the file");
-        return false;
-    }
+    const char *p = data;
+    int lineNumber = 0;
+    while (p < end) {
+        lineNumber++;
+        const char *lineEnd = static_cast<const char *>(memchr(p, '\n', end - p));
+        if (!lineEnd)
+            lineEnd = end;
+
+        p = skipObjSpaces(p, lineEnd);
+        const char *keywordEnd = p;
+        while (keywordEnd < lineEnd && !isObjSpace(*keywordEnd))
+            ++keywordEnd;
 
-    QTextStream textIn(&file);
-    while (!textIn.atEnd()) {
-        QString line = textIn.readLine();
-        QStringList lineContents = line.split(QStringLiteral(" "));
-        if (!lineContents.at(0).compare(QStringLiteral("v"))) {
-            QVector3D vertex;
-            vertex.setX(lineContents.at(1).toFloat());
-            vertex.setY(lineContents.at(2).toFloat());
-            vertex.setZ(lineContents.at(3).toFloat());
-            temp_vertices.append(vertex);
+        bool lineOk = true;
+        if (isObjKeyword(p, keywordEnd, "v", 1)) {
+            float x, y, z;
+            p = skipObjSpaces(keywordEnd, lineEnd);
+            lineOk = parseObjFloat(p, lineEnd, x);
+            p = skipObjSpaces(p, lineEnd);
+            lineOk = lineOk && parseObjFloat(p, lineEnd, y);
+            p = skipObjSpaces(p, lineEnd);
+            lineOk = lineOk && parseObjFloat(p, lineEnd, z);
+            if (lineOk)
+                temp_vertices.append(QVector3D(x, y, z));
+        } else if (isObjKeyword(p, keywordEnd, "vt", 2)) {
+            float u, v;
+            p = skipObjSpaces(keywordEnd, lineEnd);
+            lineOk = parseObjFloat(p, lineEnd, u);
+            p = skipObjSpaces(p, lineEnd);
+            lineOk = lineOk && parseObjFloat(p, lineEnd, v); // invert this if using DDS textures
+            if (lineOk)
+                temp_uvs.append(QVector2D(u, v));
+        } else if (isObjKeyword(p, keywordEnd, "vn", 2)) {
+            float x, y, z;
+            p = skipObjSpaces(keywordEnd, lineEnd);
+            lineOk = parseObjFloat(p, lineEnd, x);
+            p = skipObjSpaces(p, lineEnd);
+            lineOk = lineOk && parseObjFloat(p, lineEnd, y);
+            p = skipObjSpaces(p, lineEnd);
+            lineOk = lineOk && parseObjFloat(p, lineEnd, z);
+            if (lineOk)
+                temp_normals.append(QVector3D(x, y, z));
+        } else if (isObjKeyword(p, keywordEnd, "f", 1)) {
+            polygon.clear();
+            p = skipObjSpaces(keywordEnd, lineEnd);
+            while (lineOk && p < lineEnd) {
+                ObjCorner corner;
+                lineOk = parseObjCorner(p, lineEnd, temp_vertices.size(), temp_uvs.size(),
+                                        temp_normals.size(), corner);
+                polygon.append(corner);
+                p = skipObjSpaces(p, lineEnd);
+            }
+            lineOk = lineOk && polygon.size() >= 3;
+            // Polygons with more than three corners are split into a triangle fan
+            for (int i = 2; lineOk && i < polygon.size(); i++) {
+                corners.append(polygon.at(0));
+                corners.append(polygon.at(i - 1));
+                corners.append(polygon.at(i));
+            }
         }
-        else if (!lineContents.at(0).compare(QStringLiteral("vt"))) {
-            QVector2D uv;
-            uv.setX(lineContents.at(1).toFloat());
-            uv.setY(lineContents.at(2).toFloat()); // invert this if using DDS textures
-            temp_uvs.append(uv);
+
+        if (!lineOk) {
+            qWarning("Invalid mesh data in %s on line %d", qPrintable(path), lineNumber);
+            return false;
         }
-        else if (!lineContents.at(0).compare(QStringLiteral("vn"))) {
-            QVector3D normal;
-            normal.setX(lineContents.at(1).toFloat());
-            normal.setY(lineContents.at(2).toFloat());
-            normal.setZ(lineContents.at(3).toFloat());
-            temp_normals.append(normal);
+        p = lineEnd + 1;
+    }
+
+    if (corners.isEmpty()) {
+        qWarning("No faces found in %s", qPrintable(path));
+        return false;
+    }
+
+    // Expand the faces into flat attribute lists. Missing uvs are left at zero, and missing
+    // normals are replaced with the face normal.
+    const qsizetype cornerCount = corners.size();
+    out_vertices.resize(cornerCount);
+    out_uvs.resize(cornerCount);
+    out_normals.resize(cornerCount);
+    for (qsizetype i = 0; i < cornerCount; i += 3) {
+        const ObjCorner *triangle = corners.constData() + i;
+        for (int j = 0; j < 3; j++) {
+            out_vertices[i + j] = temp_vertices.at(triangle[j].vertex);
+            if (triangle[j].uv >= 0)
+                out_uvs[i + j] = temp_uvs.at(triangle[j].uv);
         }
-        else if (!lineContents.at(0).compare(QStringLiteral("f"))) {
-            unsigned int vertexIndex[3], uvIndex[3], normalIndex[3];
-            QStringList set1 = lineContents.at(1).split(slashTag);
-            QStringList set2 = lineContents.at(2).split(slashTag);
-            QStringList set3 = lineContents.at(3).split(slashTag);
-            vertexIndex[0] = set1.at(0).toUInt();
-            vertexIndex[1] = set2.at(0).toUInt();
-            vertexIndex[2] = set3.at(0).toUInt();
-            uvIndex[0] = set1.at(1).toUInt();
-            uvIndex[1] = set2.at(1).toUInt();
-            uvIndex[2] = set3.at(1).toUInt();
-            normalIndex[0] = set1.at(2).toUInt();
-            normalIndex[1] = set2.at(2).toUInt();
-            normalIndex[2] = set3.at(2).toUInt();
-            vertexIndices.append(vertexIndex[0]);
-            vertexIndices.append(vertexIndex[1]);
-            vertexIndices.append(vertexIndex[2]);
-            uvIndices.append(uvIndex[0]);
-            uvIndices.append(uvIndex[1]);
-            uvIndices.append(uvIndex[2]);
-            normalIndices.append(normalIndex[0]);
-            normalIndices.append(normalIndex[1]);
-            normalIndices.append(normalIndex[2]);
+        QVector3D faceNormal;
+        for (int j = 0; j < 3; j++) {
+            if (triangle[j].normal >= 0) {
+                out_normals[i + j] = temp_normals.at(triangle[j].normal);
+            } else {
+                if (faceNormal.isNull()) {
+                    faceNormal = QVector3D::normal(out_vertices.at(i), out_vertices.at(i + 1),
+                                                   out_vertices.at(i + 2));
+                }
+                out_normals[i + j] = faceNormal;
+            }
         }
     }
 
-    // For each vertex of each triangle
-    for (int i = 0; i < vertexIndices.size(); i++) {
-        // Get the indices of its attributes
-        unsigned int vertexIndex = vertexIndices[i];
-        unsigned int uvIndex = uvIndices[i];
-        unsigned int normalIndex = normalIndices[i];
+    return true;
+}
 
-        // Get the attributes thanks to the index
-        QVector3D vertex = temp_vertices[vertexIndex - 1];
-        QVector2D uv = temp_uvs[uvIndex - 1];
-        QVector3D normal = temp_normals[normalIndex - 1];
+bool MeshLoader::isBinaryMesh(const QByteArray &header)
+{
+    return header.size() >= int(sizeof(meshMagic))
+            && !memcmp(header.constData(), meshMagic, sizeof(meshMagic));
+}
 
-        // Put the attributes in buffers
-        out_vertices.append(vertex);
-        out_uvs.append(uv);
-        out_normals.append(normal);
+bool MeshLoader::loadMesh(const QString &path, QList<GLuint> &out_indices,
+                          QList<QVector3D> &out_vertices, QList<QVector2D> &out_uvs,
+                          QList<QVector3D> &out_normals)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning("Cannot open the file");
+        return false;
+    }
+    const QByteArray data = file.readAll();
+    if (data.size() < meshHeaderSize || !isBinaryMesh(data)) {
+        qWarning("Invalid mesh file");
+        return false;
+    }
+
+    const uchar *src = reinterpret_cast<const uchar *>(data.constData());
+    const quint32 version = qFromLittleEndian<quint32>(src + 4);
+    const qsizetype vertexCount = qFromLittleEndian<quint32>(src + 8);
+    const qsizetype indexCount = qFromLittleEndian<quint32>(src + 12);
+    const qsizetype expectedSize = meshHeaderSize + vertexCount * 8 * qsizetype(sizeof(float))
+            + indexCount * qsizetype(sizeof(quint32));
+    if (version != meshVersion || data.size() != expectedSize) {
+        qWarning("Unsupported or truncated mesh file");
+        return false;
+    }
+    src += meshHeaderSize;
+
+    // QVector2D and QVector3D are tightly packed floats, so the arrays can be copied directly
+    out_vertices.resize(vertexCount);
+    qFromLittleEndian<float>(src, vertexCount * 3, out_vertices.data());
+    src += vertexCount * 3 * sizeof(float);
+    out_uvs.resize(vertexCount);
+    qFromLittleEndian<float>(src, vertexCount * 2, out_uvs.data());
+    src += vertexCount * 2 * sizeof(float);
+    out_normals.resize(vertexCount);
+    qFromLittleEndian<float>(src, vertexCount * 3, out_normals.data());
+    src += vertexCount * 3 * sizeof(float);
+    out_indices.resize(indexCount);
+    qFromLittleEndian<quint32>(src, indexCount, out_indices.data());
+
+    foreach (GLuint index, out_indices) {
+        if (index >= GLuint(vertexCount)) {
+            qWarning("Mesh index out of range");
+            out_indices.clear();
+            return false;
+        }
     }
 
     return true;
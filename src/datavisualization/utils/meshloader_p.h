@@ -19,11 +19,15 @@
 
 QT_BEGIN_NAMESPACE
 
-class MeshLoader
+class Q_DATAVISUALIZATION_EXPORT MeshLoader
 {
     public:
         static bool loadOBJ(const QString &path, QList<QVector3D> &out_vertices,
                             QList<QVector2D> &out_uvs, QList<QVector3D> &out_normals);
+        static bool isBinaryMesh(const QByteArray &header);
+        static bool loadMesh(const QString &path, QList<GLuint> &out_indices,
+                             QList<QVector3D> &out_vertices, QList<QVector2D> &out_uvs,
+                             QList<QVector3D> &out_normals);
 };
 
 QT_END_NAMESPACE
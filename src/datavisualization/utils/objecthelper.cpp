@@ -1,96 +1,78 @@
 // Copyright (C) 2016 The Qt Company Ltd.
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
 
-#include "meshloader_p.h"
-#include "vertexindexer_p.h"
+#include "contextgroupcache_p.h"
+#include "meshcache_p.h"
 #include "objecthelper_p.h"
 
+#include <QtCore/QMutex>
+
 QT_BEGIN_NAMESPACE
 
 ObjectHelper::ObjectHelper(const QString &objectFile)
-    : m_objectFile(objectFile)
+    : m_objectFile(objectFile),
+      m_cache(0),
+      m_refCount(0)
 {
     load();
 }
 
-struct ObjectHelperRef {
-    int refCount;
-    ObjectHelper *obj;
-};
-
-// The "Abstract3DRenderer *" key identifies the renderer
-static QHash<const Abstract3DRenderer *, QHash<QString, ObjectHelperRef *> *> cacheTable;
-
 ObjectHelper::~ObjectHelper()
 {
 }
 
-void ObjectHelper::resetObjectHelper(const Abstract3DRenderer *cacheId, ObjectHelper *&obj,
-                                     const QString &meshFile)
+void ObjectHelper::resetObjectHelper(ObjectHelper *&obj, const QString &meshFile)
 {
-    Q_ASSERT(cacheId);
-
     if (obj) {
         const QString &oldFile = obj->objectFile();
         if (meshFile == oldFile)
             return; // same file, do nothing
-        releaseObjectHelper(cacheId, obj);
+        releaseObjectHelper(obj);
     }
-    obj = getObjectHelper(cacheId, meshFile);
+    obj = getObjectHelper(meshFile);
 }
 
-void ObjectHelper::releaseObjectHelper(const Abstract3DRenderer *cacheId, ObjectHelper *&obj)
+void ObjectHelper::releaseObjectHelper(ObjectHelper *&obj)
 {
-    Q_ASSERT(cacheId);
-
     if (obj) {
-        QHash<QString, ObjectHelperRef *> *objectTable = cacheTable.value(cacheId, 0);
-        if (objectTable) {
-            // Delete object if last reference is released
-            ObjectHelperRef *objRef = objectTable->value(obj->m_objectFile, 0);
-            if (objRef) {
-                objRef->refCount--;
-                if (objRef->refCount <= 0) {
-                    objectTable->remove(obj->m_objectFile);
-                    delete objRef->obj;
-                    delete objRef;
-                }
-            }
-            if (objectTable->isEmpty()) {
-                // Remove the entire cache if last object was removed
-                cacheTable.remove(cacheId);
-                delete objectTable;
-            }
-        } else {
-            // Just delete the object if unknown cache
+        QMutexLocker locker(ContextGroupCache::mutex());
+        // Delete object if last reference is released
+        obj->m_refCount--;
+        if (obj->m_refCount <= 0) {
+            if (obj->m_cache)
+                obj->m_cache->objects().remove(obj->m_objectFile);
             delete obj;
         }
         obj = 0;
     }
 }
 
-ObjectHelper *ObjectHelper::getObjectHelper(const Abstract3DRenderer *cacheId,
-                                            const QString &objectFile)
+ObjectHelper *ObjectHelper::getObjectHelper(const QString &objectFile)
 {
     if (objectFile.isEmpty())
         return 0;
 
-    QHash<QString, ObjectHelperRef *> *objectTable = cacheTable.value(cacheId, 0);
-    if (!objectTable) {
-        objectTable = new QHash<QString, ObjectHelperRef *>;
-        cacheTable.insert(cacheId, objectTable);
+    // Objects are keyed by the context group, so that the buffers are shared by all renderers
+    // that can use them
+    QMutexLocker locker(ContextGroupCache::mutex());
+    ContextGroupCache *cache = ContextGroupCache::current();
+    if (!cache) {
+        // Nothing to share the object with
+        ObjectHelper *obj = new ObjectHelper(objectFile);
+        obj->m_refCount = 1;
+        return obj;
     }
 
     // Check if object helper for this mesh already exists
-    ObjectHelperRef *objRef = objectTable->value(objectFile, 0);
-    if (!objRef) {
-        objRef = new ObjectHelperRef;
-        objRef->refCount = 0;
-        objRef->obj = new ObjectHelper(objectFile);
-        objectTable->insert(objectFile, objRef);
+    ObjectHelper *obj = cache->objects().value(objectFile, 0);
+    if (!obj) {
+        obj = new ObjectHelper(objectFile);
+        obj->m_cache = cache;
+        cache->objects().insert(objectFile, obj);
+        cache->finishUpload();
     }
-    objRef->refCount++;
-    return objRef->obj;
+    obj->m_refCount++;
+    return obj;
 }
 
 void ObjectHelper::load()
@@ -110,40 +92,42 @@ void ObjectHelper::load()
         m_normalbuffer = 0;
         m_elementbuffer = 0;
     }
-    QList<QVector3D> vertices;
-    QList<QVector2D> uvs;
-    QList<QVector3D> normals;
-    bool loadOk = MeshLoader::loadOBJ(m_objectFile, vertices, uvs, normals);
-    if (!loadOk)
-        qFatal("loading failed");
-
-    // Index vertices
-    VertexIndexer::indexVBO(vertices, uvs, normals, m_indices, m_indexedVertices, m_indexedUVs,
-                            m_indexedNormals);
+    // Parsed and indexed mesh data is shared by all renderers, only the buffers are per context group
+    bool loadOk = MeshCache::mesh(m_objectFile, m_indices, m_indexedVertices, m_indexedUVs,
+                                  m_indexedNormals);
+    if (!loadOk) {
+        // Leave the mesh empty instead of aborting, so that a broken custom mesh file only
+        // makes its own item disappear
+        qWarning("Failed to load mesh %s", qPrintable(m_objectFile));
+        m_indices.clear();
+        m_indexedVertices.clear();
+        m_indexedUVs.clear();
+        m_indexedNormals.clear();
+    }
 
     m_indexCount = m_indices.size();
 
     glGenBuffers(1, &m_vertexbuffer);
     glBindBuffer(GL_ARRAY_BUFFER, m_vertexbuffer);
     glBufferData(GL_ARRAY_BUFFER, m_indexedVertices.size() * sizeof(QVector3D),
-                 &m_indexedVertices.at(0),
+                 m_indexedVertices.constData(),
                  GL_STATIC_DRAW);
 
     glGenBuffers(1, &m_normalbuffer);
     glBindBuffer(GL_ARRAY_BUFFER, m_normalbuffer);
     glBufferData(GL_ARRAY_BUFFER, m_indexedNormals.size() * sizeof(QVector3D),
-                 &m_indexedNormals.at(0),
+                 m_indexedNormals.constData(),
                  GL_STATIC_DRAW);
 
     glGenBuffers(1, &m_uvbuffer);
     glBindBuffer(GL_ARRAY_BUFFER, m_uvbuffer);
     glBufferData(GL_ARRAY_BUFFER, m_indexedUVs.size() * sizeof(QVector2D),
-                 &m_indexedUVs.at(0), GL_STATIC_DRAW);
+                 m_indexedUVs.constData(), GL_STATIC_DRAW);
 
     glGenBuffers(1, &m_elementbuffer);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementbuffer);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(GLuint),
-                 &m_indices.at(0), GL_STATIC_DRAW);
+                 m_indices.constData(), GL_STATIC_DRAW);
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
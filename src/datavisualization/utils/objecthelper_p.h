@@ -19,19 +19,20 @@
 
 QT_BEGIN_NAMESPACE
 
-class Abstract3DRenderer;
+class ContextGroupCache;
 
-class ObjectHelper : public AbstractObjectHelper
+class Q_DATAVISUALIZATION_EXPORT ObjectHelper : public AbstractObjectHelper
 {
 private:
     ObjectHelper(const QString &objectFile);
 public:
     virtual ~ObjectHelper();
 
-    static void resetObjectHelper(const Abstract3DRenderer *cacheId, ObjectHelper *&obj,
-                                  const QString &meshFile);
-    static void releaseObjectHelper(const Abstract3DRenderer *cacheId, ObjectHelper *&obj);
-    inline const QString &objectFile() { return m_objectFile; }
+    // Objects are shared by all renderers whose contexts share resources, so these must be
+    // called with the renderer context current
+    static void resetObjectHelper(ObjectHelper *&obj, const QString &meshFile);
+    static void releaseObjectHelper(ObjectHelper *&obj);
+    inline const QString &objectFile() const { return m_objectFile; }
 
     inline const QList<GLuint> &indices() const { return m_indices; }
     inline const QList<QVector3D> &indexedvertices() const { return m_indexedVertices; }
@@ -39,15 +40,18 @@ public:
     inline const QList<QVector3D> &indexedNormals() const { return m_indexedNormals; }
 
 private:
-    static ObjectHelper *getObjectHelper(const Abstract3DRenderer *cacheId,
-                                         const QString &objectFile);
+    static ObjectHelper *getObjectHelper(const QString &objectFile);
     void load();
 
     QString m_objectFile;
+    ContextGroupCache *m_cache;
+    int m_refCount;
     QList<GLuint> m_indices;
     QList<QVector3D> m_indexedVertices;
     QList<QVector2D> m_indexedUVs;
     QList<QVector3D> m_indexedNormals;
+
+    friend class ContextGroupCache;
 };
 
 QT_END_NAMESPACE
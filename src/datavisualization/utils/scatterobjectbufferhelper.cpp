@@ -139,7 +139,7 @@ void ScatterObjectBufferHelper::fullLoad(ScatterSeriesRenderCache *cache, qreal
 
     m_indexCount = indicesCount * itemCount;
 
-    if (itemCount > 0) {
+    if (itemCount > 0 && indicesCount > 0) {
         glGenBuffers(1, &m_vertexbuffer);
         glBindBuffer(GL_ARRAY_BUFFER, m_vertexbuffer);
         glBufferData(GL_ARRAY_BUFFER, verticeCount * itemCount * sizeof(QVector3D),
@@ -177,7 +177,7 @@ void ScatterObjectBufferHelper::updateUVs(ScatterSeriesRenderCache *cache)
     const bool updateAll = (cache->updateIndices().size() == 0);
     const int updateSize = updateAll ? renderArray.size() : cache->updateIndices().size();
 
-    if (!updateSize)
+    if (!updateSize || !uvsCount)
         return;
 
     QList<QVector2D> buffered_uvs;
@@ -288,13 +288,13 @@ void ScatterObjectBufferHelper::update(ScatterSeriesRenderCache *cache, qreal do
     const int updateSize = updateAll ? renderArray.size() : cache->updateIndices().size();
     QQuaternion seriesRotation(cache->meshRotation());
 
-    if (!updateSize)
-        return;
-
     // Index vertices
     const QList<QVector3D> indexed_vertices = dotObj->indexedvertices();
     int verticeCount = indexed_vertices.count();
 
+    if (!updateSize || !verticeCount)
+        return;
+
     float itemSize = cache->itemSize() / itemScaler;
     if (itemSize == 0.0f)
         itemSize = dotScale;
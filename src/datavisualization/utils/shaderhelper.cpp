@@ -49,13 +49,18 @@ ShaderHelper::ShaderHelper(QObject *parent,
       m_cameraPositionRelativeToModelUniform(0),
       m_color8BitUniform(0),
       m_textureDimensionsUniform(0),
+      m_occupancyUniform(0),
+      m_occupancyScaleUniform(0),
+      m_brickDimensionsUniform(0),
       m_sampleCountUniform(0),
       m_alphaMultiplierUniform(0),
       m_preserveOpacityUniform(0),
       m_minBoundsUniform(0),
       m_maxBoundsUniform(0),
       m_sliceFrameWidthUniform(0),
-      m_initialized(false)
+      m_atlasRectUniform(0),
+      m_initialized(false),
+      m_compilePending(false)
 {
 }
 
@@ -78,15 +83,44 @@ void ShaderHelper::setTextures(const QString &texture,
     m_depthTextureFile = depthTexture;
 }
 
+// Adds a fragment shader that is linked into the same program, for functions that are
+// shared between several programs
+void ShaderHelper::addFragmentShader(const QString &fragmentShader)
+{
+    m_extraFragmentShaderFiles.append(fragmentShader);
+}
+
 void ShaderHelper::initialize()
 {
     if (m_program)
         delete m_program;
     m_program = new QOpenGLShaderProgram(m_caller);
-    if (!m_program->addShaderFromSourceFile(QOpenGLShader::Vertex, m_vertexShaderFile))
+    m_initialized = false;
+    // Compiling is deferred to first use, so that the variants no series needs are never built
+    m_compilePending = true;
+}
+
+void ShaderHelper::compile()
+{
+    if (!m_compilePending)
+        qFatal("Shader not initialized");
+    m_compilePending = false;
+
+    // Cacheable shaders are linked from a program binary stored on disk when the driver
+    // supports it. The cache is keyed by the shader sources and the driver, so changed
+    // shaders or drivers simply miss it.
+    if (!m_program->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, m_vertexShaderFile))
         qFatal("Compiling Vertex shader failed");
-    if (!m_program->addShaderFromSourceFile(QOpenGLShader::Fragment, m_fragmentShaderFile))
+    if (!m_program->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment,
+                                                      m_fragmentShaderFile)) {
         qFatal("Compiling Fragment shader failed");
+    }
+    foreach (const QString &fragmentShaderFile, m_extraFragmentShaderFiles) {
+        if (!m_program->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment,
+                                                          fragmentShaderFile)) {
+            qFatal("Compiling Fragment shader failed");
+        }
+    }
 
     if (!m_program->link()) {
         qWarning() << "Unable to link shader program:" <<
@@ -118,12 +152,16 @@ void ShaderHelper::initialize()
     m_cameraPositionRelativeToModelUniform = m_program->uniformLocation("cameraPositionRelativeToModel");
     m_color8BitUniform = m_program->uniformLocation("color8Bit");
     m_textureDimensionsUniform = m_program->uniformLocation("textureDimensions");
+    m_occupancyUniform = m_program->uniformLocation("occupancySampler");
+    m_occupancyScaleUniform = m_program->uniformLocation("occupancyScale");
+    m_brickDimensionsUniform = m_program->uniformLocation("brickDimensions");
     m_sampleCountUniform = m_program->uniformLocation("sampleCount");
     m_alphaMultiplierUniform = m_program->uniformLocation("alphaMultiplier");
     m_preserveOpacityUniform = m_program->uniformLocation("preserveOpacity");
     m_minBoundsUniform = m_program->uniformLocation("minBounds");
     m_maxBoundsUniform = m_program->uniformLocation("maxBounds");
     m_sliceFrameWidthUniform = m_program->uniformLocation("sliceFrameWidth");
+    m_atlasRectUniform = m_program->uniformLocation("atlasRect");
     m_initialized = true;
 }
 
@@ -140,6 +178,10 @@ bool ShaderHelper::testCompile()
         result = false;
     if (!m_program->addShaderFromSourceFile(QOpenGLShader::Fragment, m_fragmentShaderFile))
         result = false;
+    foreach (const QString &fragmentShaderFile, m_extraFragmentShaderFiles) {
+        if (!m_program->addShaderFromSourceFile(QOpenGLShader::Fragment, fragmentShaderFile))
+            result = false;
+    }
 
     // Restore actual message handler
     qInstallMessageHandler(handler);
@@ -148,6 +190,8 @@ bool ShaderHelper::testCompile()
 
 void ShaderHelper::bind()
 {
+    if (m_compilePending)
+        compile();
     m_program->bind();
 }
 
@@ -194,175 +238,196 @@ void ShaderHelper::setUniformValueArray(GLint uniform, const QVector4D *values,
 GLint ShaderHelper::MVP()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_mvpMatrixUniform;
 }
 
 GLint ShaderHelper::view()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_viewMatrixUniform;
 }
 
 GLint ShaderHelper::model()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_modelMatrixUniform;
 }
 
 GLint ShaderHelper::nModel()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_invTransModelMatrixUniform;
 }
 
 GLint ShaderHelper::depth()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_depthMatrixUniform;
 }
 
 GLint ShaderHelper::lightP()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_lightPositionUniform;
 }
 
 GLint ShaderHelper::lightS()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_lightStrengthUniform;
 }
 
 GLint ShaderHelper::ambientS()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_ambientStrengthUniform;
 }
 
 GLint ShaderHelper::shadowQ()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_shadowQualityUniform;
 }
 
 GLint ShaderHelper::color()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_colorUniform;
 }
 
 GLint ShaderHelper::texture()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_textureUniform;
 }
 
 GLint ShaderHelper::shadow()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_shadowUniform;
 }
 
 GLint ShaderHelper::gradientMin()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_gradientMinUniform;
 }
 
 GLint ShaderHelper::gradientHeight()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_gradientHeightUniform;
 }
 
 GLint ShaderHelper::lightColor()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_lightColorUniform;
 }
 
 GLint ShaderHelper::volumeSliceIndices()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_volumeSliceIndicesUniform;
 }
 
 GLint ShaderHelper::colorIndex()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_colorIndexUniform;
 }
 
 GLint ShaderHelper::cameraPositionRelativeToModel()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_cameraPositionRelativeToModelUniform;
 }
 
 GLint ShaderHelper::color8Bit()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_color8BitUniform;
 }
 
 GLint ShaderHelper::textureDimensions()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_textureDimensionsUniform;
 }
 
+GLint ShaderHelper::occupancy()
+{
+    if (!m_initialized)
+        compile();
+    return m_occupancyUniform;
+}
+
+GLint ShaderHelper::occupancyScale()
+{
+    if (!m_initialized)
+        compile();
+    return m_occupancyScaleUniform;
+}
+
+GLint ShaderHelper::brickDimensions()
+{
+    if (!m_initialized)
+        compile();
+    return m_brickDimensionsUniform;
+}
+
 GLint ShaderHelper::sampleCount()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_sampleCountUniform;
 }
 
 GLint ShaderHelper::alphaMultiplier()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_alphaMultiplierUniform;
 }
 
 GLint ShaderHelper::preserveOpacity()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_preserveOpacityUniform;
 }
 
 GLint ShaderHelper::maxBounds()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_maxBoundsUniform;
 }
 
 GLint ShaderHelper::minBounds()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_minBoundsUniform;
 }
 
@@ -370,28 +435,35 @@ GLint ShaderHelper::sliceFrameWidth()
 {
 
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_sliceFrameWidthUniform;
 }
 
+GLint ShaderHelper::atlasRect()
+{
+    if (!m_initialized)
+        compile();
+    return m_atlasRectUniform;
+}
+
 GLint ShaderHelper::posAtt()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_positionAttr;
 }
 
 GLint ShaderHelper::uvAtt()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_uvAttr;
 }
 
 GLint ShaderHelper::normalAtt()
 {
     if (!m_initialized)
-        qFatal("Shader not initialized");
+        compile();
     return m_normalAttr;
 }
 
@@ -15,6 +15,7 @@
 #define SHADERHELPER_P_H
 
 #include "datavisualizationglobal_p.h"
+#include <QtCore/QStringList>
 
 QT_FORWARD_DECLARE_CLASS(QOpenGLShaderProgram)
 
@@ -32,6 +33,7 @@ class ShaderHelper
 
     void setShaders(const QString &vertexShader, const QString &fragmentShader);
     void setTextures(const QString &texture, const QString &depthTexture);
+    void addFragmentShader(const QString &fragmentShader);
 
     void initialize();
     bool testCompile();
@@ -65,23 +67,30 @@ class ShaderHelper
     GLint cameraPositionRelativeToModel();
     GLint color8Bit();
     GLint textureDimensions();
+    GLint occupancy();
+    GLint occupancyScale();
+    GLint brickDimensions();
     GLint sampleCount();
     GLint alphaMultiplier();
     GLint preserveOpacity();
     GLint maxBounds();
     GLint minBounds();
     GLint sliceFrameWidth();
+    GLint atlasRect();
 
     GLint posAtt();
     GLint uvAtt();
     GLint normalAtt();
 
     private:
+    void compile();
+
     QObject *m_caller;
     QOpenGLShaderProgram *m_program;
 
     QString m_vertexShaderFile;
     QString m_fragmentShaderFile;
+    QStringList m_extraFragmentShaderFiles;
 
     QString m_textureFile;
     QString m_depthTextureFile;
@@ -110,14 +119,19 @@ class ShaderHelper
     GLint m_cameraPositionRelativeToModelUniform;
     GLint m_color8BitUniform;
     GLint m_textureDimensionsUniform;
+    GLint m_occupancyUniform;
+    GLint m_occupancyScaleUniform;
+    GLint m_brickDimensionsUniform;
     GLint m_sampleCountUniform;
     GLint m_alphaMultiplierUniform;
     GLint m_preserveOpacityUniform;
     GLint m_minBoundsUniform;
     GLint m_maxBoundsUniform;
     GLint m_sliceFrameWidthUniform;
+    GLint m_atlasRectUniform;
 
     GLboolean m_initialized;
+    bool m_compilePending;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,88 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "contextgroupcache_p.h"
+#include "sharedtexture_p.h"
+#include "texturehelper_p.h"
+
+#include <QtCore/QMutex>
+
+QT_BEGIN_NAMESPACE
+
+SharedTexture::SharedTexture(const QString &key)
+    : m_key(key),
+      m_textureId(0),
+      m_cache(0),
+      m_refCount(0)
+{
+}
+
+SharedTexture::~SharedTexture()
+{
+}
+
+void SharedTexture::resetUniformTexture(SharedTexture *&texture, TextureHelper *textureHelper,
+                                        const QColor &color)
+{
+    resetSharedTexture(texture, textureHelper,
+                       QStringLiteral("uniform:") + color.name(QColor::HexArgb), color, 0);
+}
+
+void SharedTexture::resetGradientTexture(SharedTexture *&texture, TextureHelper *textureHelper,
+                                         const QLinearGradient &gradient)
+{
+    // The renderers only vary the stops of the gradients
+    QString key = QStringLiteral("gradient:");
+    foreach (const QGradientStop &stop, gradient.stops()) {
+        key += QString::number(stop.first) + QLatin1Char('=')
+                + stop.second.name(QColor::HexArgb) + QLatin1Char(';');
+    }
+    resetSharedTexture(texture, textureHelper, key, QColor(), &gradient);
+}
+
+void SharedTexture::releaseSharedTexture(SharedTexture *&texture, TextureHelper *textureHelper)
+{
+    if (texture) {
+        QMutexLocker locker(ContextGroupCache::mutex());
+        // Delete texture if last reference is released
+        texture->m_refCount--;
+        if (texture->m_refCount <= 0) {
+            if (texture->m_cache)
+                texture->m_cache->textures().remove(texture->m_key);
+            if (textureHelper)
+                textureHelper->deleteTexture(&texture->m_textureId);
+            delete texture;
+        }
+        texture = 0;
+    }
+}
+
+void SharedTexture::resetSharedTexture(SharedTexture *&texture, TextureHelper *textureHelper,
+                                       const QString &key, const QColor &color,
+                                       const QLinearGradient *gradient)
+{
+    if (texture) {
+        if (texture->m_key == key)
+            return; // same contents, do nothing
+        releaseSharedTexture(texture, textureHelper);
+    }
+
+    QMutexLocker locker(ContextGroupCache::mutex());
+    ContextGroupCache *cache = ContextGroupCache::current();
+    texture = cache ? cache->textures().value(key, 0) : 0;
+    if (!texture) {
+        texture = new SharedTexture(key);
+        if (gradient)
+            texture->m_textureId = textureHelper->createGradientTexture(*gradient);
+        else
+            texture->m_textureId = textureHelper->createUniformTexture(color);
+        if (cache) {
+            texture->m_cache = cache;
+            cache->textures().insert(key, texture);
+            cache->finishUpload();
+        }
+    }
+    texture->m_refCount++;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,62 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SHAREDTEXTURE_P_H
+#define SHAREDTEXTURE_P_H
+
+#include "datavisualizationglobal_p.h"
+#include <QtGui/QLinearGradient>
+
+QT_BEGIN_NAMESPACE
+
+class ContextGroupCache;
+class TextureHelper;
+
+// Series color and gradient textures, keyed by their contents and shared the same way as the
+// ObjectHelper meshes
+class Q_DATAVISUALIZATION_EXPORT SharedTexture
+{
+private:
+    SharedTexture(const QString &key);
+public:
+    ~SharedTexture();
+
+    // Textures are shared by all renderers whose contexts share resources, so these must be
+    // called with the renderer context current
+    static void resetUniformTexture(SharedTexture *&texture, TextureHelper *textureHelper,
+                                    const QColor &color);
+    static void resetGradientTexture(SharedTexture *&texture, TextureHelper *textureHelper,
+                                     const QLinearGradient &gradient);
+    static void releaseSharedTexture(SharedTexture *&texture, TextureHelper *textureHelper);
+
+    static inline GLuint textureId(const SharedTexture *texture)
+    {
+        return texture ? texture->m_textureId : 0;
+    }
+
+private:
+    static void resetSharedTexture(SharedTexture *&texture, TextureHelper *textureHelper,
+                                   const QString &key, const QColor &color,
+                                   const QLinearGradient *gradient);
+
+    QString m_key;
+    GLuint m_textureId;
+    ContextGroupCache *m_cache;
+    int m_refCount;
+
+    friend class ContextGroupCache;
+};
+
+QT_END_NAMESPACE
+
+#endif
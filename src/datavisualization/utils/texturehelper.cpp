@@ -6,6 +6,7 @@
 
 #include <QtGui/QImage>
 #include <QtGui/QPainter>
+#include <QtGui/QOpenGLExtraFunctions>
 #include <QtCore/QTime>
 
 QT_BEGIN_NAMESPACE
@@ -47,9 +48,35 @@ GLuint TextureHelper::create2DTexture(const QImage &image, bool useTrilinearFilt
     if (image.isNull())
         return 0;
 
+    return createPrepared2DTexture(prepare2DTextureImage(image, Utils::isOpenGLES(), convert,
+                                                         smoothScale),
+                                   useTrilinearFiltering, smoothScale, clampY);
+}
+
+// Prepared images are uploaded as BGRA only if prepare2DTextureImage() left them in ARGB32
+GLenum TextureHelper::uploadFormat(const QImage &preparedImage, bool isOpenGLES)
+{
+#if !QT_CONFIG(opengles2)
+    if (preparedImage.format() == QImage::Format_ARGB32
+            && QSysInfo::ByteOrder == QSysInfo::LittleEndian && !isOpenGLES) {
+        return GL_BGRA;
+    }
+#else
+    Q_UNUSED(preparedImage);
+    Q_UNUSED(isOpenGLES);
+#endif
+    return GL_RGBA;
+}
+
+QImage TextureHelper::prepare2DTextureImage(const QImage &image, bool isOpenGLES, bool convert,
+                                            bool smoothScale)
+{
+    if (image.isNull())
+        return image;
+
     QImage texImage = image;
 
-    if (Utils::isOpenGLES()) {
+    if (isOpenGLES) {
         GLuint imageWidth = Utils::getNearestPowerOfTwo(image.width());
         GLuint imageHeight = Utils::getNearestPowerOfTwo(image.height());
         if (smoothScale) {
@@ -60,13 +87,37 @@ GLuint TextureHelper::create2DTexture(const QImage &image, bool useTrilinearFilt
         }
     }
 
+    if (convert) {
+#if !QT_CONFIG(opengles2)
+        // Desktop GL takes ARGB32 data directly as BGRA on little endian hosts, so it only
+        // needs to be mirrored
+        if (!isOpenGLES && QSysInfo::ByteOrder == QSysInfo::LittleEndian
+                && texImage.format() == QImage::Format_ARGB32) {
+            return texImage.mirrored();
+        }
+#endif
+        texImage = convertToGLFormat(texImage);
+    } else if (texImage.format() == QImage::Format_ARGB32) {
+        // Unconverted data is uploaded as is, so it must not be taken for BGRA data
+        texImage.reinterpretAsFormat(QImage::Format_RGBA8888);
+    }
+
+    return texImage;
+}
+
+GLuint TextureHelper::createPrepared2DTexture(const QImage &preparedImage,
+                                              bool useTrilinearFiltering, bool smoothScale,
+                                              bool clampY)
+{
+    if (preparedImage.isNull())
+        return 0;
+
     GLuint textureId;
     glGenTextures(1, &textureId);
     glBindTexture(GL_TEXTURE_2D, textureId);
-    if (convert)
-        texImage = convertToGLFormat(texImage);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texImage.width(), texImage.height(),
-                 0, GL_RGBA, GL_UNSIGNED_BYTE, texImage.bits());
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, preparedImage.width(), preparedImage.height(),
+                 0, uploadFormat(preparedImage, Utils::isOpenGLES()), GL_UNSIGNED_BYTE,
+                 preparedImage.constBits());
     if (smoothScale)
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     else
@@ -84,7 +135,117 @@ GLuint TextureHelper::create2DTexture(const QImage &image, bool useTrilinearFilt
     return textureId;
 }
 
-GLuint TextureHelper::create3DTexture(const QList<uchar> *data, int width, int height, int depth,
+GLuint TextureHelper::update2DTexture(GLuint textureId, const QImage &image,
+                                      TextureStream &stream, bool useTrilinearFiltering,
+                                      bool convert, bool smoothScale, bool clampY)
+{
+    return updatePrepared2DTexture(textureId,
+                                   prepare2DTextureImage(image, Utils::isOpenGLES(), convert,
+                                                         smoothScale),
+                                   stream, useTrilinearFiltering, smoothScale, clampY);
+}
+
+GLuint TextureHelper::updatePrepared2DTexture(GLuint textureId, const QImage &preparedImage,
+                                              TextureStream &stream, bool useTrilinearFiltering,
+                                              bool smoothScale, bool clampY)
+{
+    if (preparedImage.isNull()) {
+        deleteTexture(&textureId);
+        deleteTextureStream(stream);
+        return 0;
+    }
+
+    // The storage can only be reused if it has the same size
+    if (!textureId || preparedImage.size() != stream.size) {
+        deleteTexture(&textureId);
+        stream.size = preparedImage.size();
+        return createPrepared2DTexture(preparedImage, useTrilinearFiltering, smoothScale,
+                                       clampY);
+    }
+
+    const GLenum format = uploadFormat(preparedImage, Utils::isOpenGLES());
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    bool uploaded = false;
+#if !QT_CONFIG(opengles2)
+    if (!Utils::isOpenGLES()) {
+        // Copy the data into one of two alternating pixel buffers, so that writing the new
+        // data does not have to wait for the transfer of the previous update to finish
+        GLuint &pixelBuffer = stream.pixelBuffers[stream.nextBuffer];
+        if (!pixelBuffer)
+            glGenBuffers(1, &pixelBuffer);
+        const qsizetype byteCount = preparedImage.sizeInBytes();
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+        // Orphan the old storage instead of synchronizing with it
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, byteCount, 0, GL_STREAM_DRAW);
+        void *pixels = m_openGlFunctions_2_1->glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+        if (pixels) {
+            memcpy(pixels, preparedImage.constBits(), byteCount);
+            m_openGlFunctions_2_1->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, preparedImage.width(),
+                            preparedImage.height(), format, GL_UNSIGNED_BYTE, 0);
+            uploaded = true;
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        stream.nextBuffer = 1 - stream.nextBuffer;
+    }
+#endif
+    if (!uploaded) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, preparedImage.width(), preparedImage.height(),
+                        format, GL_UNSIGNED_BYTE, preparedImage.constBits());
+    }
+    if (useTrilinearFiltering)
+        glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return textureId;
+}
+
+void TextureHelper::update2DSubTexture(GLuint textureId, const QImage &image,
+                                       const QPoint &position, int textureHeight)
+{
+    if (!textureId || image.isNull())
+        return;
+
+    // The texture is uploaded mirrored, so the rows of the part are counted from the bottom
+    const bool isOpenGLES = Utils::isOpenGLES();
+    const QImage preparedImage = isOpenGLES ? convertToGLFormat(image)
+                                            : prepare2DTextureImage(image, false);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, position.x(),
+                    textureHeight - position.y() - image.height(), image.width(),
+                    image.height(), uploadFormat(preparedImage, isOpenGLES), GL_UNSIGNED_BYTE,
+                    preparedImage.constBits());
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void TextureHelper::limitMipLevels(GLuint textureId, int level)
+{
+    glBindTexture(GL_TEXTURE_2D, textureId);
+#if !QT_CONFIG(opengles2)
+    if (!Utils::isOpenGLES()) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return;
+    }
+#endif
+    // OpenGL ES2 has no maximum level, so only the base level is used there
+    Q_UNUSED(level);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void TextureHelper::deleteTextureStream(TextureStream &stream)
+{
+    if (QOpenGLContext::currentContext()) {
+        for (int i = 0; i < 2; i++) {
+            if (stream.pixelBuffers[i])
+                glDeleteBuffers(1, &stream.pixelBuffers[i]);
+        }
+    }
+    stream = TextureStream();
+}
+
+GLuint TextureHelper::create3DTexture(const uchar *data, int width, int height, int depth,
                                       QImage::Format dataFormat)
 {
     if (Utils::isOpenGLES() || !width || !height || !depth)
@@ -112,14 +273,23 @@ GLuint TextureHelper::create3DTexture(const QList<uchar> *data, int width, int h
 
     GLint internalFormat = 4;
     GLint format = GL_BGRA;
+    GLenum type = GL_UNSIGNED_BYTE;
     if (dataFormat == QImage::Format_Indexed8) {
         internalFormat = 1;
         format = GL_RED;
         // Align width to 32bits
         width = width + width % 4;
+    } else if (dataFormat == QImage::Format_Grayscale8) {
+        // Lines are already aligned to 32bits, which matches the default unpack alignment
+        internalFormat = GL_LUMINANCE8;
+        format = GL_RED;
+    } else if (dataFormat == QImage::Format_Grayscale16) {
+        internalFormat = GL_LUMINANCE16;
+        format = GL_RED;
+        type = GL_UNSIGNED_SHORT;
     }
     m_openGlFunctions_2_1->glTexImage3D(GL_TEXTURE_3D, 0, internalFormat, width, height, depth, 0,
-                                        format, GL_UNSIGNED_BYTE, data->constData());
+                                        format, type, data);
     status = glGetError();
     if (status)
         qWarning() << __FUNCTION__ << "3D texture creation failed:" << status;
@@ -130,6 +300,63 @@ GLuint TextureHelper::create3DTexture(const QList<uchar> *data, int width, int h
     return textureId;
 }
 
+void TextureHelper::update3DTexture(GLuint textureId, const uchar *data, int width,
+                                    int height, int depth, QImage::Format dataFormat,
+                                    int x, int y, int z, int subWidth, int subHeight, int subDepth)
+{
+    if (Utils::isOpenGLES() || !textureId || !data)
+        return;
+
+#if QT_CONFIG(opengles2)
+    Q_UNUSED(width);
+    Q_UNUSED(height);
+    Q_UNUSED(depth);
+    Q_UNUSED(dataFormat);
+    Q_UNUSED(x);
+    Q_UNUSED(y);
+    Q_UNUSED(z);
+    Q_UNUSED(subWidth);
+    Q_UNUSED(subHeight);
+    Q_UNUSED(subDepth);
+#else
+    Q_UNUSED(depth);
+
+    GLint format = GL_BGRA;
+    GLenum type = GL_UNSIGNED_BYTE;
+    if (dataFormat == QImage::Format_Indexed8) {
+        format = GL_RED;
+        // Lines are aligned to 32bits, same as in create3DTexture()
+        width = width + width % 4;
+    } else if (dataFormat == QImage::Format_Grayscale8) {
+        format = GL_RED;
+    } else if (dataFormat == QImage::Format_Grayscale16) {
+        format = GL_RED;
+        type = GL_UNSIGNED_SHORT;
+    }
+
+    glBindTexture(GL_TEXTURE_3D, textureId);
+
+    // Read the box directly out of the whole volume data instead of packing it first
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+    glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, height);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, x);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, y);
+    glPixelStorei(GL_UNPACK_SKIP_IMAGES, z);
+
+    m_openGlFunctions_2_1->glTexSubImage3D(GL_TEXTURE_3D, 0, x, y, z,
+                                           subWidth, subHeight, subDepth,
+                                           format, type, data);
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_IMAGES, 0);
+
+    glBindTexture(GL_TEXTURE_3D, 0);
+#endif
+}
+
 GLuint TextureHelper::createCubeMapTexture(const QImage &image, bool useTrilinearFiltering)
 {
     if (image.isNull())
@@ -239,6 +466,134 @@ GLuint TextureHelper::createCursorPositionTexture(const QSize &size, GLuint &fra
     return textureid;
 }
 
+GLuint TextureHelper::createLayerTexture(const QSize &size, GLuint &frameBuffer,
+                                         GLuint &depthBuffer, GLenum depthFormat,
+                                         bool hasStencil, bool hasAlpha)
+{
+    const GLenum colorFormat = hasAlpha ? GL_RGBA : GL_RGB;
+    GLuint textureid;
+    glGenTextures(1, &textureid);
+    glBindTexture(GL_TEXTURE_2D, textureid);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, colorFormat, size.width(), size.height(), 0, colorFormat,
+                 GL_UNSIGNED_BYTE, NULL);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (depthBuffer)
+        glDeleteRenderbuffers(1, &depthBuffer);
+    depthBuffer = 0;
+    if (depthFormat) {
+        glGenRenderbuffers(1, &depthBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, depthFormat, size.width(), size.height());
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    }
+
+    if (!frameBuffer)
+        glGenFramebuffers(1, &frameBuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureid, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                              hasStencil ? depthBuffer : 0);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        qCritical() << "Layer frame buffer creation failed:" << status;
+        glDeleteTextures(1, &textureid);
+        textureid = 0;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    return textureid;
+}
+
+bool TextureHelper::createLayerRenderbuffers(const QSize &size, int samples, bool hasAlpha,
+                                             GLenum depthFormat, bool hasStencil,
+                                             GLuint &frameBuffer, GLuint &colorBuffer,
+                                             GLuint &depthBuffer)
+{
+#if QT_CONFIG(opengles2)
+    Q_UNUSED(size);
+    Q_UNUSED(samples);
+    Q_UNUSED(hasAlpha);
+    Q_UNUSED(depthFormat);
+    Q_UNUSED(hasStencil);
+    Q_UNUSED(frameBuffer);
+    Q_UNUSED(colorBuffer);
+    Q_UNUSED(depthBuffer);
+    return false;
+#else
+    QOpenGLExtraFunctions *extraFunctions = QOpenGLContext::currentContext()->extraFunctions();
+    const GLenum colorFormat = hasAlpha ? GL_RGBA8 : GL_RGB8;
+    if (!colorBuffer)
+        glGenRenderbuffers(1, &colorBuffer);
+    if (!depthBuffer)
+        glGenRenderbuffers(1, &depthBuffer);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    if (samples) {
+        extraFunctions->glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, colorFormat,
+                                                         size.width(), size.height());
+    } else {
+        glRenderbufferStorage(GL_RENDERBUFFER, colorFormat, size.width(), size.height());
+    }
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    if (samples) {
+        extraFunctions->glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, depthFormat,
+                                                         size.width(), size.height());
+    } else {
+        glRenderbufferStorage(GL_RENDERBUFFER, depthFormat, size.width(), size.height());
+    }
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    if (!frameBuffer)
+        glGenFramebuffers(1, &frameBuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                              hasStencil ? depthBuffer : 0);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        qCritical() << "Layer frame buffer creation failed:" << status;
+        return false;
+    }
+
+    return true;
+#endif
+}
+
+// Framebuffer dimensions are rounded up to multiples of this
+static const int framebufferBucketGranularity = 128;
+
+QSize TextureHelper::framebufferBucketSize(const QSize &size)
+{
+    const int maxSize = qMax(Utils::getMaxTextureSize(), 1);
+    int width = (size.width() + framebufferBucketGranularity - 1)
+            / framebufferBucketGranularity * framebufferBucketGranularity;
+    int height = (size.height() + framebufferBucketGranularity - 1)
+            / framebufferBucketGranularity * framebufferBucketGranularity;
+    return QSize(qBound(1, width, qMax(maxSize, size.width())),
+                 qBound(1, height, qMax(maxSize, size.height())));
+}
+
+bool TextureHelper::framebufferFits(const QSize &allocatedSize, const QSize &size)
+{
+    if (size.width() > allocatedSize.width() || size.height() > allocatedSize.height())
+        return false;
+
+    // Give the memory back once the size has shrunk to less than half of the allocation
+    const QSize bucketSize = framebufferBucketSize(size);
+    return qint64(allocatedSize.width()) * allocatedSize.height()
+            <= 2 * qint64(bucketSize.width()) * bucketSize.height();
+}
+
 GLuint TextureHelper::createUniformTexture(const QColor &color)
 {
     QImage image(QSize(int(uniformTextureWidth), int(uniformTextureHeight)),
@@ -333,128 +688,9 @@ void TextureHelper::deleteTexture(GLuint *texture)
 
 QImage TextureHelper::convertToGLFormat(const QImage &srcImage)
 {
-    QImage res(srcImage.size(), QImage::Format_ARGB32);
-    convertToGLFormatHelper(res, srcImage.convertToFormat(QImage::Format_ARGB32), GL_RGBA);
-    return res;
-}
-
-void TextureHelper::convertToGLFormatHelper(QImage &dstImage, const QImage &srcImage,
-                                            GLenum texture_format)
-{
-    Q_ASSERT(dstImage.depth() == 32);
-    Q_ASSERT(srcImage.depth() == 32);
-
-    if (dstImage.size() != srcImage.size()) {
-        int target_width = dstImage.width();
-        int target_height = dstImage.height();
-        float sx = target_width / float(srcImage.width());
-        float sy = target_height / float(srcImage.height());
-
-        quint32 *dest = (quint32 *) dstImage.scanLine(0); // NB! avoid detach here
-        uchar *srcPixels = (uchar *) srcImage.scanLine(srcImage.height() - 1);
-        int sbpl = srcImage.bytesPerLine();
-        int dbpl = dstImage.bytesPerLine();
-
-        int ix = int(0x00010000 / sx);
-        int iy = int(0x00010000 / sy);
-
-        quint32 basex = int(0.5 * ix);
-        quint32 srcy = int(0.5 * iy);
-
-        // scale, swizzle and mirror in one loop
-        while (target_height--) {
-            const uint *src = (const quint32 *) (srcPixels - (srcy >> 16) * sbpl);
-            int srcx = basex;
-            for (int x=0; x<target_width; ++x) {
-                dest[x] = qt_gl_convertToGLFormatHelper(src[srcx >> 16], texture_format);
-                srcx += ix;
-            }
-            dest = (quint32 *)(((uchar *) dest) + dbpl);
-            srcy += iy;
-        }
-    } else {
-        const int width = srcImage.width();
-        const int height = srcImage.height();
-        const uint *p = (const uint*) srcImage.scanLine(srcImage.height() - 1);
-        uint *q = (uint*) dstImage.scanLine(0);
-
-#if !QT_CONFIG(opengles2)
-        if (texture_format == GL_BGRA) {
-#else
-        if (texture_format == GL_BGRA8_EXT) {
-#endif
-            if (QSysInfo::ByteOrder == QSysInfo::BigEndian) {
-                // mirror + swizzle
-                for (int i=0; i < height; ++i) {
-                    const uint *end = p + width;
-                    while (p < end) {
-                        *q = ((*p << 24) & 0xff000000)
-                                | ((*p >> 24) & 0x000000ff)
-                                | ((*p << 8) & 0x00ff0000)
-                                | ((*p >> 8) & 0x0000ff00);
-                        p++;
-                        q++;
-                    }
-                    p -= 2 * width;
-                }
-            } else {
-                const uint bytesPerLine = srcImage.bytesPerLine();
-                for (int i=0; i < height; ++i) {
-                    memcpy(q, p, bytesPerLine);
-                    q += width;
-                    p -= width;
-                }
-            }
-        } else {
-            if (QSysInfo::ByteOrder == QSysInfo::BigEndian) {
-                for (int i=0; i < height; ++i) {
-                    const uint *end = p + width;
-                    while (p < end) {
-                        *q = (*p << 8) | ((*p >> 24) & 0xff);
-                        p++;
-                        q++;
-                    }
-                    p -= 2 * width;
-                }
-            } else {
-                for (int i=0; i < height; ++i) {
-                    const uint *end = p + width;
-                    while (p < end) {
-                        *q = ((*p << 16) & 0xff0000) | ((*p >> 16) & 0xff) | (*p & 0xff00ff00);
-                        p++;
-                        q++;
-                    }
-                    p -= 2 * width;
-                }
-            }
-        }
-    }
-}
-
-QRgb TextureHelper::qt_gl_convertToGLFormatHelper(QRgb src_pixel, GLenum texture_format)
-{
-#if !QT_CONFIG(opengles2)
-    if (texture_format == GL_BGRA) {
-#else
-    if (texture_format == GL_BGRA8_EXT) {
-#endif
-        if (QSysInfo::ByteOrder == QSysInfo::BigEndian) {
-            return ((src_pixel << 24) & 0xff000000)
-                    | ((src_pixel >> 24) & 0x000000ff)
-                    | ((src_pixel << 8) & 0x00ff0000)
-                    | ((src_pixel >> 8) & 0x0000ff00);
-        } else {
-            return src_pixel;
-        }
-    } else {  // GL_RGBA
-        if (QSysInfo::ByteOrder == QSysInfo::BigEndian) {
-            return (src_pixel << 8) | ((src_pixel >> 24) & 0xff);
-        } else {
-            return ((src_pixel << 16) & 0xff0000)
-                    | ((src_pixel >> 16) & 0xff)
-                    | (src_pixel & 0xff00ff00);
-        }
-    }
+    // QImage's own format conversions are vectorized, so let them do the swizzling and only
+    // mirror the rows here, which is a plain copy
+    return srcImage.convertToFormat(QImage::Format_RGBA8888).mirrored();
 }
 
 QT_END_NAMESPACE
@@ -15,6 +15,7 @@
 #define TEXTUREHELPER_P_H
 
 #include "datavisualizationglobal_p.h"
+#include <QtCore/QSize>
 #include <QtGui/QRgb>
 #include <QtGui/QLinearGradient>
 #if !QT_CONFIG(opengles2)
@@ -24,7 +25,22 @@
 
 QT_BEGIN_NAMESPACE
 
-class TextureHelper : protected QOpenGLFunctions
+// State for streaming new contents into an existing texture, see update2DTexture()
+struct TextureStream
+{
+    TextureStream()
+        : nextBuffer(0)
+    {
+        pixelBuffers[0] = 0;
+        pixelBuffers[1] = 0;
+    }
+
+    GLuint pixelBuffers[2];
+    int nextBuffer;
+    QSize size;
+};
+
+class Q_DATAVISUALIZATION_EXPORT TextureHelper : protected QOpenGLFunctions
 {
     public:
     TextureHelper();
@@ -33,12 +49,56 @@ class TextureHelper : protected QOpenGLFunctions
     // Ownership of created texture is transferred to caller
     GLuint create2DTexture(const QImage &image, bool useTrilinearFiltering = false,
                            bool convert = true, bool smoothScale = true, bool clampY = false);
-    GLuint create3DTexture(const QList<uchar> *data, int width, int height, int depth,
+    // Does the CPU side work of create2DTexture(), can be called from any thread
+    static QImage prepare2DTextureImage(const QImage &image, bool isOpenGLES, bool convert = true,
+                                        bool smoothScale = true);
+    // Pixel format in which an image returned by prepare2DTextureImage() is uploaded
+    static GLenum uploadFormat(const QImage &preparedImage, bool isOpenGLES);
+    // Mirrors the image and converts it to GL_RGBA byte order
+    static QImage convertToGLFormat(const QImage &srcImage);
+    GLuint createPrepared2DTexture(const QImage &preparedImage,
+                                   bool useTrilinearFiltering = false, bool smoothScale = true,
+                                   bool clampY = false);
+    // Replaces the contents of the texture, reusing its storage when the size is unchanged.
+    // Returns the texture to use, which is a new one if the old one could not be reused.
+    GLuint update2DTexture(GLuint textureId, const QImage &image, TextureStream &stream,
+                           bool useTrilinearFiltering = false, bool convert = true,
+                           bool smoothScale = true, bool clampY = false);
+    GLuint updatePrepared2DTexture(GLuint textureId, const QImage &preparedImage,
+                                   TextureStream &stream, bool useTrilinearFiltering = false,
+                                   bool smoothScale = true, bool clampY = false);
+    void deleteTextureStream(TextureStream &stream);
+    // Replaces a part of a texture created by create2DTexture() from an image that was not
+    // scaled. The position is in the coordinates of that image. Mipmaps are not updated.
+    void update2DSubTexture(GLuint textureId, const QImage &image, const QPoint &position,
+                            int textureHeight);
+    // Limits sampling of a mipmapped texture to the mip levels up to the given one
+    void limitMipLevels(GLuint textureId, int level);
+    // Texture contents are left undefined if data is null
+    GLuint create3DTexture(const uchar *data, int width, int height, int depth,
                            QImage::Format dataFormat);
+    // Uploads the given box of the volume data to an existing texture created by create3DTexture()
+    void update3DTexture(GLuint textureId, const uchar *data, int width, int height,
+                         int depth, QImage::Format dataFormat, int x, int y, int z,
+                         int subWidth, int subHeight, int subDepth);
     GLuint createCubeMapTexture(const QImage &image, bool useTrilinearFiltering = false);
     // Returns selection texture and inserts generated framebuffers to framebuffer parameters
     GLuint createSelectionTexture(const QSize &size, GLuint &frameBuffer, GLuint &depthBuffer);
     GLuint createCursorPositionTexture(const QSize &size, GLuint &frameBuffer);
+    // Returns the color texture of an offscreen layer. A depth buffer is only created if a
+    // format is given, and is also attached as the stencil buffer if hasStencil is set.
+    GLuint createLayerTexture(const QSize &size, GLuint &frameBuffer, GLuint &depthBuffer,
+                              GLenum depthFormat = 0, bool hasStencil = false,
+                              bool hasAlpha = true);
+    // Creates the buffers of an offscreen layer as renderbuffers, multisampled if samples is
+    // nonzero, so that the layer can be copied to and from a framebuffer of the same formats
+    bool createLayerRenderbuffers(const QSize &size, int samples, bool hasAlpha,
+                                  GLenum depthFormat, bool hasStencil, GLuint &frameBuffer,
+                                  GLuint &colorBuffer, GLuint &depthBuffer);
+    // Framebuffers that only need to cover a viewport are allocated in size buckets and kept
+    // while the viewport still fits them, so that resizing does not reallocate them every frame
+    static QSize framebufferBucketSize(const QSize &size);
+    static bool framebufferFits(const QSize &allocatedSize, const QSize &size);
     GLuint createUniformTexture(const QColor &color);
     GLuint createGradientTexture(const QLinearGradient &gradient);
     GLuint createDepthTexture(const QSize &size, GLuint textureSize);
@@ -47,10 +107,6 @@ class TextureHelper : protected QOpenGLFunctions
     void deleteTexture(GLuint *texture);
 
     private:
-    QImage convertToGLFormat(const QImage &srcImage);
-    void convertToGLFormatHelper(QImage &dstImage, const QImage &srcImage, GLenum texture_format);
-    QRgb qt_gl_convertToGLFormatHelper(QRgb src_pixel, GLenum texture_format);
-
 #if !QT_CONFIG(opengles2)
     QOpenGLFunctions_2_1 *m_openGlFunctions_2_1 = nullptr;
 #endif
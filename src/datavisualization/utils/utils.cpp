@@ -315,6 +315,13 @@ bool Utils::isOpenGLES()
     return isES;
 }
 
+GLint Utils::getMaxTextureSize()
+{
+    if (!staticsResolved)
+        resolveStatics();
+    return maxTextureSize;
+}
+
 void Utils::resolveStatics()
 {
     QOpenGLContext *ctx = QOpenGLContext::currentContext();
@@ -55,6 +55,7 @@ public:
     static float wrapValue(float value, float min, float max);
     static QQuaternion calculateRotation(const QVector3D &xyzRotations);
     static bool isOpenGLES();
+    static GLint getMaxTextureSize();
     static void resolveStatics();
 
 private:
@@ -4,17 +4,16 @@
 #include "vertexindexer_p.h"
 
 #include <QtCore/qmath.h>
-#include <QtCore/qmap.h>
 
 QT_BEGIN_NAMESPACE
 
 int unique_vertices = 0;
 
 bool VertexIndexer::getSimilarVertexIndex_fast(const PackedVertex &packed,
-                                               QMap<PackedVertex, GLuint> &VertexToOutIndex,
+                                               QHash<PackedVertex, GLuint> &VertexToOutIndex,
                                                GLuint &result)
 {
-    QMap<PackedVertex, GLuint>::iterator it = VertexToOutIndex.find(packed);
+    QHash<PackedVertex, GLuint>::iterator it = VertexToOutIndex.find(packed);
     if (it == VertexToOutIndex.end()) {
         return false;
     } else {
@@ -29,7 +28,9 @@ void VertexIndexer::indexVBO(const QList<QVector3D> &in_vertices, const QList<QV
                              QList<QVector3D> &out_normals)
 {
     unique_vertices = 0;
-    QMap<PackedVertex, GLuint> VertexToOutIndex;
+    QHash<PackedVertex, GLuint> VertexToOutIndex;
+    VertexToOutIndex.reserve(in_vertices.size());
+    out_indices.reserve(out_indices.size() + in_vertices.size());
 
     // For each input vertex
     for (int i = 0; i < in_vertices.size(); i++) {
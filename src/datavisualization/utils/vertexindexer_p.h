@@ -16,6 +16,7 @@
 
 #include "datavisualizationglobal_p.h"
 
+#include <QtCore/QHash>
 #include <QtCore/QList>
 #include <QtGui/QVector2D>
 
@@ -31,6 +32,9 @@ public:
         bool operator<(const PackedVertex that) const {
             return memcmp((void*)this, (void*)&that, sizeof(PackedVertex)) > 0;
         }
+        bool operator==(const PackedVertex &that) const {
+            return memcmp((void*)this, (void*)&that, sizeof(PackedVertex)) == 0;
+        }
     };
 
     static void indexVBO(const QList<QVector3D> &in_vertices, const QList<QVector2D> &in_uvs,
@@ -40,10 +44,15 @@ public:
 
 private:
     static bool getSimilarVertexIndex_fast(const PackedVertex &packed,
-                                           QMap<PackedVertex, GLuint> &VertexToOutIndex,
+                                           QHash<PackedVertex, GLuint> &VertexToOutIndex,
                                            GLuint &result);
 };
 
+inline size_t qHash(const VertexIndexer::PackedVertex &key, size_t seed = 0)
+{
+    return qHashBits(&key, sizeof(VertexIndexer::PackedVertex), seed);
+}
+
 QT_END_NAMESPACE
 
 #endif
@@ -357,10 +357,9 @@ void AbstractDeclarative::activateOpenGLContext(QQuickWindow *window)
         m_context->create();
         m_context->makeCurrent(window);
 #else
-        // Shared contexts don't work properly in some platforms, so just store the
-        // context state on those
+        // Shared contexts don't work properly in some platforms, so just reset the
+        // context state the graph changes on those
         m_stateStore = new GLStateStore(QOpenGLContext::currentContext());
-        m_stateStore->storeGLState();
 #endif
         m_controller->initializeOpenGL();
 
@@ -370,8 +369,6 @@ void AbstractDeclarative::activateOpenGLContext(QQuickWindow *window)
     } else {
 #ifdef USE_SHARED_CONTEXT
         m_context->makeCurrent(window);
-#else
-        m_stateStore->storeGLState();
 #endif
     }
 }
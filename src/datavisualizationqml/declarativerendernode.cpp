@@ -3,6 +3,7 @@
 
 #include "declarativerendernode_p.h"
 #include "abstractdeclarative_p.h"
+#include <private/texturehelper_p.h>
 #include <QtOpenGL/QOpenGLFramebufferObject>
 #include <QtCore/QMutexLocker>
 
@@ -13,6 +14,7 @@ DeclarativeRenderNode::DeclarativeRenderNode(AbstractDeclarative *declarative,
     : QSGGeometryNode(),
       m_geometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 4),
       m_texture(0),
+      m_fboSamples(0),
       m_declarative(declarative),
       m_controller(0),
       m_fbo(0),
@@ -59,38 +61,52 @@ void DeclarativeRenderNode::updateFBO()
 {
     m_declarative->activateOpenGLContext(m_window);
 
-    if (m_fbo)
-        delete m_fbo;
-
-    m_fbo = new QOpenGLFramebufferObject(m_size);
-    m_fbo->setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
-
-    // Multisampled
-    if (m_multisampledFBO) {
-        delete m_multisampledFBO;
-        m_multisampledFBO = 0;
-    }
-    if (m_samples > 0) {
-        QOpenGLFramebufferObjectFormat multisampledFrambufferFormat;
-        multisampledFrambufferFormat.setSamples(m_samples);
-        multisampledFrambufferFormat.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
-
-        m_multisampledFBO = new QOpenGLFramebufferObject(m_size, multisampledFrambufferFormat);
+    // The graph is rendered to the bottom left corner of framebuffers allocated in size
+    // buckets, so that animated resizes do not create new framebuffers every frame
+    if (!m_fbo || m_fboSamples != m_samples
+            || !TextureHelper::framebufferFits(m_fboSize, m_size)) {
+        m_fboSize = TextureHelper::framebufferBucketSize(m_size);
+        m_fboSamples = m_samples;
+
+        if (m_fbo)
+            delete m_fbo;
+
+        m_fbo = new QOpenGLFramebufferObject(m_fboSize);
+        m_fbo->setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+
+        // Multisampled
+        if (m_multisampledFBO) {
+            delete m_multisampledFBO;
+            m_multisampledFBO = 0;
+        }
+        if (m_samples > 0) {
+            QOpenGLFramebufferObjectFormat multisampledFrambufferFormat;
+            multisampledFrambufferFormat.setSamples(m_samples);
+            multisampledFrambufferFormat.setAttachment(
+                        QOpenGLFramebufferObject::CombinedDepthStencil);
+
+            m_multisampledFBO = new QOpenGLFramebufferObject(m_fboSize,
+                                                             multisampledFrambufferFormat);
+        }
+
+        delete m_texture;
+        const uint id = m_fbo->texture();
+        m_texture = QNativeInterface::QSGOpenGLTexture::fromNative(id, m_window, m_fboSize);
+        m_material.setTexture(m_texture);
+        m_materialO.setTexture(m_texture);
     }
 
+    // Show only the part of the texture the graph is rendered to
+    const qreal usedWidth = qreal(m_size.width()) / qreal(m_fboSize.width());
+    const qreal usedHeight = qreal(m_size.height()) / qreal(m_fboSize.height());
     QSGGeometry::updateTexturedRectGeometry(&m_geometry,
                                             QRectF(0, 0,
                                                    m_size.width()
                                                    / m_controller->scene()->devicePixelRatio(),
                                                    m_size.height()
                                                    / m_controller->scene()->devicePixelRatio()),
-                                            QRectF(0, 1, 1, -1));
-
-    delete m_texture;
-    const uint id = m_fbo->texture();
-    m_texture = QNativeInterface::QSGOpenGLTexture::fromNative(id, m_window, m_size);
-    m_material.setTexture(m_texture);
-    m_materialO.setTexture(m_texture);
+                                            QRectF(0, usedHeight, usedWidth, -usedHeight));
+    markDirty(DirtyGeometry);
 
     m_declarative->doneOpenGLContext(m_window);
 }
@@ -142,8 +158,10 @@ void DeclarativeRenderNode::preprocess()
 
     targetFBO->release();
 
-    if (m_samples > 0)
-        QOpenGLFramebufferObject::blitFramebuffer(m_fbo, m_multisampledFBO);
+    if (m_samples > 0) {
+        const QRect usedRect(QPoint(0, 0), m_size);
+        QOpenGLFramebufferObject::blitFramebuffer(m_fbo, usedRect, m_multisampledFBO, usedRect);
+    }
 
     m_declarative->doneOpenGLContext(m_window);
 }
@@ -57,6 +57,8 @@ private:
     QSGGeometry m_geometry;
     QSGTexture *m_texture;
     QSize m_size;
+    QSize m_fboSize;
+    int m_fboSamples;
 
     AbstractDeclarative *m_declarative;
     Abstract3DController *m_controller;
@@ -35,16 +35,7 @@ GLStateStore::GLStateStore(QOpenGLContext *context, QObject *parent) :
     }
 #endif
 
-    m_maxVertexAttribs = qMin(maxVertexAttribs, 2); // Datavis only uses 2 attribs max
-    m_vertexAttribArrayEnabledStates.reset(new GLint[maxVertexAttribs]);
-    m_vertexAttribArrayBoundBuffers.reset(new GLint[maxVertexAttribs]);
-    m_vertexAttribArraySizes.reset(new GLint[maxVertexAttribs]);
-    m_vertexAttribArrayTypes.reset(new GLint[maxVertexAttribs]);
-    m_vertexAttribArrayNormalized.reset(new GLint[maxVertexAttribs]);
-    m_vertexAttribArrayStrides.reset(new GLint[maxVertexAttribs]);
-    m_vertexAttribArrayOffsets.reset(new void *[maxVertexAttribs]);
-
-    initGLDefaultState();
+    m_maxVertexAttribs = maxVertexAttribs;
 }
 
 GLStateStore::~GLStateStore()
@@ -55,58 +46,6 @@ GLStateStore::~GLStateStore()
 #endif
 }
 
-void GLStateStore::storeGLState()
-{
-#ifdef VERBOSE_STATE_STORE
-    printCurrentState(true);
-#endif
-
-#if !QT_CONFIG(opengles2)
-    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_drawFramebuffer);
-    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &m_readFramebuffer);
-    glGetIntegerv(GL_RENDERBUFFER_BINDING, &m_renderbuffer);
-#endif
-    glGetFloatv(GL_COLOR_CLEAR_VALUE, m_clearColor);
-    m_isBlendingEnabled = glIsEnabled(GL_BLEND);
-    m_isDepthTestEnabled = glIsEnabled(GL_DEPTH_TEST);
-    glGetBooleanv(GL_DEPTH_WRITEMASK, &m_isDepthWriteEnabled);
-    glGetFloatv(GL_DEPTH_CLEAR_VALUE, &m_clearDepth);
-    glGetIntegerv(GL_DEPTH_FUNC, &m_depthFunc);
-    glGetBooleanv(GL_POLYGON_OFFSET_FILL, &m_polygonOffsetFillEnabled);
-    glGetFloatv(GL_POLYGON_OFFSET_FACTOR, &m_polygonOffsetFactor);
-    glGetFloatv(GL_POLYGON_OFFSET_UNITS, &m_polygonOffsetUnits);
-
-    glGetIntegerv(GL_CURRENT_PROGRAM, &m_currentProgram);
-    glGetIntegerv(GL_ACTIVE_TEXTURE, &m_activeTexture);
-    glGetIntegerv(GL_TEXTURE_BINDING_2D, &m_texBinding2D);
-    glGetIntegerv(GL_FRONT_FACE, &m_frontFace);
-    m_isCullFaceEnabled = glIsEnabled(GL_CULL_FACE);
-    glGetIntegerv(GL_CULL_FACE_MODE, &m_cullFaceMode);
-    glGetIntegerv(GL_BLEND_EQUATION_RGB, &m_blendEquationRGB);
-    glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &m_blendEquationAlpha);
-    glGetIntegerv(GL_BLEND_DST_ALPHA, &m_blendDestAlpha);
-    glGetIntegerv(GL_BLEND_DST_RGB, &m_blendDestRGB);
-    glGetIntegerv(GL_BLEND_SRC_ALPHA, &m_blendSrcAlpha);
-    glGetIntegerv(GL_BLEND_SRC_RGB, &m_blendSrcRGB);
-    glGetIntegerv(GL_SCISSOR_BOX, m_scissorBox);
-    m_isScissorTestEnabled = glIsEnabled(GL_SCISSOR_TEST);
-
-    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &m_boundArrayBuffer);
-    glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &m_boundElementArrayBuffer);
-
-    for (int i = 0; i < m_maxVertexAttribs;i++) {
-        glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_ENABLED,
-                            &m_vertexAttribArrayEnabledStates[i]);
-        glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING,
-                            &m_vertexAttribArrayBoundBuffers[i]);
-        glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_SIZE, &m_vertexAttribArraySizes[i]);
-        glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_TYPE, &m_vertexAttribArrayTypes[i]);
-        glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_NORMALIZED,
-                            &m_vertexAttribArrayNormalized[i]);
-        glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_STRIDE, &m_vertexAttribArrayStrides[i]);
-    }
-}
-
 #ifdef VERBOSE_STATE_STORE
 void GLStateStore::printCurrentState(bool in)
 {
@@ -207,8 +146,8 @@ void GLStateStore::printCurrentState(bool in)
         msg << "    GL_RENDERBUFFER_BINDING " << renderbuffer << endl;
 #endif
         msg << "    GL_SCISSOR_TEST " << bool(isScissorTestEnabled) << endl;
-        msg << "    GL_SCISSOR_BOX " << m_scissorBox[0] << m_scissorBox[1] << m_scissorBox[2]
-            << m_scissorBox[3] << endl;
+        msg << "    GL_SCISSOR_BOX " << scissorBox[0] << scissorBox[1] << scissorBox[2]
+            << scissorBox[3] << endl;
         msg << "    GL_COLOR_CLEAR_VALUE "<< color << endl;
         msg << "    GL_DEPTH_CLEAR_VALUE "<< clearDepth << endl;
         msg << "    GL_BLEND "<< bool(isBlendingEnabled) << endl;
@@ -252,116 +191,36 @@ void GLStateStore::printCurrentState(bool in)
 
 void GLStateStore::restoreGLState()
 {
-#if !QT_CONFIG(opengles2)
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_readFramebuffer);
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_drawFramebuffer);
-    glBindRenderbuffer(GL_RENDERBUFFER_BINDING, m_renderbuffer);
+#ifdef VERBOSE_STATE_STORE
+    printCurrentState(true);
 #endif
 
-    if (m_isScissorTestEnabled)
-        glEnable(GL_SCISSOR_TEST);
-    else
-        glDisable(GL_SCISSOR_TEST);
-
-    glScissor(m_scissorBox[0], m_scissorBox[1], m_scissorBox[2], m_scissorBox[3]);
-    glClearColor(m_clearColor[0], m_clearColor[1], m_clearColor[2], m_clearColor[3]);
-    glClearDepthf(m_clearDepth);
-    if (m_isBlendingEnabled)
-        glEnable(GL_BLEND);
-    else
-        glDisable(GL_BLEND);
-
-    if (m_isDepthTestEnabled)
-        glEnable(GL_DEPTH_TEST);
-    else
-        glDisable(GL_DEPTH_TEST);
-
-    if (m_isCullFaceEnabled)
-        glEnable(GL_CULL_FACE);
-    else
-        glDisable(GL_CULL_FACE);
-
-    glCullFace(m_cullFaceMode);
-
-    glBlendEquationSeparate(m_blendEquationRGB, m_blendEquationAlpha);
-    glBlendFuncSeparate(m_blendSrcRGB, m_blendDestRGB, m_blendSrcAlpha, m_blendDestAlpha);
-
-    glDepthMask(m_isDepthWriteEnabled);
-    glDepthFunc(m_depthFunc);
-    glFrontFace(m_frontFace);
-
-    if (m_polygonOffsetFillEnabled)
-        glEnable(GL_POLYGON_OFFSET_FILL);
-    else
-        glDisable(GL_POLYGON_OFFSET_FILL);
-
-    glPolygonOffset(m_polygonOffsetFactor, m_polygonOffsetUnits);
-
-    glUseProgram(m_currentProgram);
-
-    glActiveTexture(m_activeTexture);
-    glBindTexture(GL_TEXTURE_2D, m_texBinding2D);
-
-    // Restore bound element array buffer and array buffers
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_boundElementArrayBuffer);
-    for (int i = 0; i < m_maxVertexAttribs; i++) {
-        if (m_vertexAttribArrayEnabledStates[i])
-            glEnableVertexAttribArray(i);
-        else
-            glDisableVertexAttribArray(i);
-
-        glBindBuffer(GL_ARRAY_BUFFER, m_vertexAttribArrayBoundBuffers[i]);
-        glVertexAttribPointer(i, m_vertexAttribArraySizes[i],
-                              m_vertexAttribArrayTypes[i],
-                              m_vertexAttribArrayNormalized[i],
-                              m_vertexAttribArrayStrides[i],
-                              m_vertexAttribArrayOffsets[i]);
+    // Qt Quick renders through QRhi, which sets its whole pipeline state (depth, blending,
+    // culling, scissor, viewport, clear values and the render target) again after the external
+    // commands, so that state is left as it is. Only the state QRhi expects to be in its
+    // default values is reset here, and only the parts of it the renderers change: vertex
+    // attribute arrays, buffer, program and texture bindings, and the fixed function state
+    // QRhi never touches. The state is not queried, as each glGet call stalls the pipeline.
+    for (int i = 0; i < m_maxVertexAttribs; i++)
+        glDisableVertexAttribArray(i);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    glUseProgram(0);
+
+    // The renderers use texture units from 0 to 3
+    for (int i = 3; i >= 0; i--) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, 0);
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_boundArrayBuffer);
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(0.0f, 0.0f);
+    glDisable(GL_STENCIL_TEST);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glEnable(GL_DITHER);
 
 #ifdef VERBOSE_STATE_STORE
     printCurrentState(false);
 #endif
 }
-
-void GLStateStore::initGLDefaultState()
-{
-#if !QT_CONFIG(opengles2)
-    m_drawFramebuffer = 0;
-    m_readFramebuffer = 0;
-    m_renderbuffer = 0;
-#endif
-    m_clearColor[0] = m_clearColor[1] = m_clearColor[2] = m_clearColor[3] = 1.0f;
-    m_clearDepth = 1.0f;
-    m_isBlendingEnabled = GL_FALSE;
-    m_isDepthTestEnabled = GL_FALSE;
-    m_depthFunc = GL_LESS;
-    m_isDepthWriteEnabled = GL_TRUE;
-    m_currentProgram = 0;
-    m_texBinding2D = 0;
-    for (int i = 0; i < m_maxVertexAttribs;i++) {
-        m_vertexAttribArrayEnabledStates[i] = GL_FALSE;
-        m_vertexAttribArrayBoundBuffers[i] = 0;
-        m_vertexAttribArraySizes[i] = 4;
-        m_vertexAttribArrayTypes[i] = GL_FLOAT;
-        m_vertexAttribArrayNormalized[i] = GL_FALSE;
-        m_vertexAttribArrayStrides[i] = 0;
-        m_vertexAttribArrayOffsets[i] = 0;
-    }
-    m_activeTexture = GL_TEXTURE0;
-    m_frontFace = GL_CCW;
-    m_isCullFaceEnabled = false;
-    m_cullFaceMode = GL_BACK;
-    m_blendEquationRGB = GL_FUNC_ADD;
-    m_blendEquationAlpha = GL_FUNC_ADD;
-    m_scissorBox[0] = 0;
-    m_scissorBox[1] = 0;
-    m_scissorBox[2] = 0;
-    m_scissorBox[3] = 0;
-    m_isScissorTestEnabled = GL_FALSE;
-
-    m_polygonOffsetFillEnabled = GL_FALSE;
-    m_polygonOffsetFactor = 0.0;
-    m_polygonOffsetUnits = 0.0;
-}
@@ -0,0 +1,172 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/private/objecthelper_p.h>
+#include <QtDataVisualization/private/sharedtexture_p.h>
+#include <QtDataVisualization/private/texturehelper_p.h>
+
+#include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLContext>
+
+class tst_contextgroupcache: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void sharedObjects();
+    void sharedTextures();
+    void objectOutlivesGroup();
+
+private:
+    QOffscreenSurface *m_surface;
+};
+
+static const QString meshFile(QStringLiteral(":/defaultMeshes/barFull"));
+
+void tst_contextgroupcache::initTestCase()
+{
+    m_surface = new QOffscreenSurface;
+    m_surface->create();
+    QOpenGLContext context;
+    if (!context.create() || !context.makeCurrent(m_surface))
+        QSKIP("OpenGL is not available");
+    context.doneCurrent();
+}
+
+void tst_contextgroupcache::cleanupTestCase()
+{
+    delete m_surface;
+}
+
+void tst_contextgroupcache::sharedObjects()
+{
+    // Two graphs whose contexts share resources, and one graph that has its own
+    QOpenGLContext first;
+    QVERIFY(first.create());
+    QOpenGLContext second;
+    second.setShareContext(&first);
+    QVERIFY(second.create());
+    QCOMPARE(second.shareGroup(), first.shareGroup());
+    QOpenGLContext other;
+    QVERIFY(other.create());
+    QVERIFY(other.shareGroup() != first.shareGroup());
+
+    ObjectHelper *firstObj = 0;
+    ObjectHelper *secondObj = 0;
+    ObjectHelper *otherObj = 0;
+
+    QVERIFY(first.makeCurrent(m_surface));
+    ObjectHelper::resetObjectHelper(firstObj, meshFile);
+    QVERIFY(firstObj);
+    QVERIFY(firstObj->indexCount() > 0);
+
+    QVERIFY(second.makeCurrent(m_surface));
+    ObjectHelper::resetObjectHelper(secondObj, meshFile);
+    QCOMPARE(secondObj, firstObj);
+
+    QVERIFY(other.makeCurrent(m_surface));
+    ObjectHelper::resetObjectHelper(otherObj, meshFile);
+    QVERIFY(otherObj);
+    QVERIFY(otherObj != firstObj);
+    ObjectHelper::releaseObjectHelper(otherObj);
+    QVERIFY(!otherObj);
+
+    // The object stays while it is referenced
+    QVERIFY(first.makeCurrent(m_surface));
+    ObjectHelper::releaseObjectHelper(firstObj);
+    QVERIFY(!firstObj);
+    QCOMPARE(secondObj->objectFile(), meshFile);
+    QVERIFY(secondObj->vertexBuf());
+    ObjectHelper::releaseObjectHelper(secondObj);
+    QVERIFY(!secondObj);
+    first.doneCurrent();
+}
+
+void tst_contextgroupcache::sharedTextures()
+{
+    QOpenGLContext first;
+    QVERIFY(first.create());
+    QOpenGLContext second;
+    second.setShareContext(&first);
+    QVERIFY(second.create());
+
+    QLinearGradient gradient;
+    gradient.setColorAt(0.0, Qt::black);
+    gradient.setColorAt(1.0, Qt::red);
+    QLinearGradient otherGradient;
+    otherGradient.setColorAt(0.0, Qt::black);
+    otherGradient.setColorAt(1.0, Qt::green);
+
+    QVERIFY(first.makeCurrent(m_surface));
+    TextureHelper *firstHelper = new TextureHelper;
+    SharedTexture *firstGradient = 0;
+    SharedTexture *firstColor = 0;
+    SharedTexture::resetGradientTexture(firstGradient, firstHelper, gradient);
+    SharedTexture::resetUniformTexture(firstColor, firstHelper, Qt::blue);
+    QVERIFY(SharedTexture::textureId(firstGradient));
+    QVERIFY(SharedTexture::textureId(firstColor));
+    QVERIFY(firstGradient != firstColor);
+
+    QVERIFY(second.makeCurrent(m_surface));
+    TextureHelper *secondHelper = new TextureHelper;
+    SharedTexture *secondGradient = 0;
+    SharedTexture *secondColor = 0;
+    SharedTexture::resetGradientTexture(secondGradient, secondHelper, gradient);
+    SharedTexture::resetUniformTexture(secondColor, secondHelper, Qt::blue);
+    QCOMPARE(secondGradient, firstGradient);
+    QCOMPARE(secondColor, firstColor);
+
+    // Changed contents are not shared
+    SharedTexture::resetGradientTexture(secondGradient, secondHelper, otherGradient);
+    QVERIFY(secondGradient != firstGradient);
+    SharedTexture::resetUniformTexture(secondColor, secondHelper, Qt::yellow);
+    QVERIFY(secondColor != firstColor);
+
+    SharedTexture::releaseSharedTexture(secondGradient, secondHelper);
+    SharedTexture::releaseSharedTexture(secondColor, secondHelper);
+    QVERIFY(!secondGradient);
+    delete secondHelper;
+
+    QVERIFY(first.makeCurrent(m_surface));
+    SharedTexture::releaseSharedTexture(firstGradient, firstHelper);
+    SharedTexture::releaseSharedTexture(firstColor, firstHelper);
+    QVERIFY(!firstGradient);
+    delete firstHelper;
+    first.doneCurrent();
+}
+
+void tst_contextgroupcache::objectOutlivesGroup()
+{
+    QOpenGLContext *context = new QOpenGLContext;
+    QVERIFY(context->create());
+    QPointer<QOpenGLContextGroup> group = context->shareGroup();
+    QVERIFY(context->makeCurrent(m_surface));
+
+    ObjectHelper *obj = 0;
+    ObjectHelper::resetObjectHelper(obj, meshFile);
+    QVERIFY(obj);
+    const GLuint indexCount = obj->indexCount();
+    QVERIFY(obj->vertexBuf());
+
+    context->doneCurrent();
+    delete context;
+    QTRY_VERIFY(!group);
+
+    // The buffers died with the group, but the object is still usable as a reference
+    QCOMPARE(obj->objectFile(), meshFile);
+    QCOMPARE(obj->indexCount(), indexCount);
+    QCOMPARE(obj->vertexBuf(), GLuint(0));
+    QCOMPARE(obj->elementBuf(), GLuint(0));
+
+    // Releasing it does not touch the buffers of later contexts
+    ObjectHelper::releaseObjectHelper(obj);
+    QVERIFY(!obj);
+}
+
+QTEST_MAIN(tst_contextgroupcache)
+#include "tst_contextgroupcache.moc"
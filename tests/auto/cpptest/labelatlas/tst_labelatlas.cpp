@@ -0,0 +1,120 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/private/labelatlas_p.h>
+
+#include "cpptestutil.h"
+
+class tst_labelatlas: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void packImages();
+    void changedImages();
+
+private:
+    void packAtlas(LabelAtlas &atlas, const QList<QImage> &images);
+};
+
+static QImage labelImage(const QSize &size, const QColor &color)
+{
+    QImage image(size, QImage::Format_ARGB32);
+    image.fill(color);
+    return image;
+}
+
+void tst_labelatlas::initTestCase()
+{
+    // The atlas size is limited by the maximum texture size
+    if (!CpptestUtil::isOpenGLSupported())
+        QSKIP("OpenGL not supported on this platform");
+}
+
+void tst_labelatlas::packAtlas(LabelAtlas &atlas, const QList<QImage> &images)
+{
+    QList<QRect> rects;
+    QImage atlasImage = LabelAtlas::packImages(images, rects);
+    // No texture is created without a context, any name marks the atlas as packed
+    atlas.setTextureId(1);
+    atlas.setContents(images, rects, atlasImage.size());
+}
+
+void tst_labelatlas::packImages()
+{
+    QList<QImage> images;
+    images << labelImage(QSize(40, 20), Qt::red) << QImage()
+           << labelImage(QSize(30, 20), Qt::green) << labelImage(QSize(50, 10), Qt::blue);
+
+    QList<QRect> rects;
+    QImage atlasImage = LabelAtlas::packImages(images, rects);
+    QVERIFY(!atlasImage.isNull());
+    QCOMPARE(rects.size(), images.size());
+    QVERIFY(rects.at(1).isNull());
+
+    for (int i = 0; i < images.size(); i++) {
+        if (images.at(i).isNull())
+            continue;
+        QCOMPARE(rects.at(i).size(), images.at(i).size());
+        QVERIFY(QRect(QPoint(0, 0), atlasImage.size()).contains(rects.at(i)));
+        QCOMPARE(atlasImage.pixel(rects.at(i).center()), images.at(i).pixel(0, 0));
+        // The padding keeps the labels apart
+        for (int j = i + 1; j < images.size(); j++) {
+            if (!images.at(j).isNull())
+                QVERIFY(!rects.at(i).adjusted(-4, -4, 4, 4).intersects(rects.at(j)));
+        }
+    }
+}
+
+void tst_labelatlas::changedImages()
+{
+    QList<QImage> images;
+    images << labelImage(QSize(40, 20), Qt::red) << labelImage(QSize(30, 20), Qt::green)
+           << QImage();
+
+    LabelAtlas atlas;
+    QList<int> changed;
+    // Nothing to replace before the atlas is packed
+    QVERIFY(!atlas.findChangedImages(images, changed));
+
+    packAtlas(atlas, images);
+    QVERIFY(atlas.findChangedImages(images, changed));
+    QVERIFY(changed.isEmpty());
+
+    // Labels that fit into their places are replaced in place
+    QList<QImage> newImages = images;
+    newImages[0] = labelImage(QSize(40, 20), Qt::blue);
+    newImages[1] = labelImage(QSize(20, 10), Qt::green);
+    QVERIFY(atlas.findChangedImages(newImages, changed));
+    QCOMPARE(changed, QList<int>() << 0 << 1);
+    atlas.replaceImages(newImages);
+    QVERIFY(atlas.findChangedImages(newImages, changed));
+    QVERIFY(changed.isEmpty());
+
+    // Labels that were empty when the atlas was packed have no place
+    QList<QImage> filledImages = newImages;
+    filledImages[2] = labelImage(QSize(10, 10), Qt::red);
+    QVERIFY(!atlas.findChangedImages(filledImages, changed));
+
+    // Removed labels leave their places
+    newImages.removeLast();
+    newImages[1] = QImage();
+    QVERIFY(atlas.findChangedImages(newImages, changed));
+    QCOMPARE(changed, QList<int>() << 1);
+    atlas.replaceImages(newImages);
+
+    // The atlas is packed again for grown or added labels
+    newImages[0] = labelImage(QSize(41, 20), Qt::blue);
+    QVERIFY(!atlas.findChangedImages(newImages, changed));
+    QVERIFY(!atlas.findChangedImages(images, changed));
+
+    atlas.clear();
+    QVERIFY(!atlas.findChangedImages(images, changed));
+}
+
+QTEST_MAIN(tst_labelatlas)
+#include "tst_labelatlas.moc"
@@ -0,0 +1,104 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/private/labelimagecache_p.h>
+
+#include "cpptestutil.h"
+
+class tst_labelimagecache: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void hitAndMiss();
+    void budgetEvicts();
+
+private:
+    int m_defaultMaxCost;
+};
+
+void tst_labelimagecache::initTestCase()
+{
+    // Label painting depends on whether the graphs use OpenGL ES
+    if (!CpptestUtil::isOpenGLSupported())
+        QSKIP("OpenGL not supported on this platform");
+}
+
+void tst_labelimagecache::init()
+{
+    m_defaultMaxCost = LabelImageCache::maxCost();
+    LabelImageCache::clear();
+}
+
+void tst_labelimagecache::cleanup()
+{
+    LabelImageCache::setMaxCost(m_defaultMaxCost);
+    LabelImageCache::clear();
+}
+
+void tst_labelimagecache::hitAndMiss()
+{
+    QFont font;
+    QImage first = LabelImageCache::labelImage(font, QStringLiteral("label"), Qt::gray,
+                                               Qt::black, true);
+    QVERIFY(!first.isNull());
+    QCOMPARE(LabelImageCache::missCount(), 1);
+    QCOMPARE(LabelImageCache::hitCount(), 0);
+
+    QImage second = LabelImageCache::labelImage(font, QStringLiteral("label"), Qt::gray,
+                                                Qt::black, true);
+    QCOMPARE(LabelImageCache::missCount(), 1);
+    QCOMPARE(LabelImageCache::hitCount(), 1);
+    QCOMPARE(second, first);
+
+    LabelImageCache::labelImage(font, QStringLiteral("other label"), Qt::gray, Qt::black, true);
+    QCOMPARE(LabelImageCache::missCount(), 2);
+    QCOMPARE(LabelImageCache::hitCount(), 1);
+
+    LabelImageCache::clear();
+    QCOMPARE(LabelImageCache::missCount(), 0);
+    QCOMPARE(LabelImageCache::hitCount(), 0);
+}
+
+void tst_labelimagecache::budgetEvicts()
+{
+    QFont font;
+    font.setPointSize(40);
+    const QString text = QStringLiteral("budget");
+
+    // Labels that only differ in color have the same size, and so the same cost
+    QImage image = LabelImageCache::labelImage(font, text, Qt::gray, Qt::red, true);
+    QVERIFY(!image.isNull());
+    const int cost = qMax(1, int(image.sizeInBytes() / 1024));
+
+    // Only one of the labels fits in the budget
+    LabelImageCache::setMaxCost(cost);
+    QCOMPARE(LabelImageCache::maxCost(), cost);
+    LabelImageCache::labelImage(font, text, Qt::gray, Qt::red, true);
+    QCOMPARE(LabelImageCache::hitCount(), 1);
+
+    LabelImageCache::labelImage(font, text, Qt::gray, Qt::blue, true);
+    QCOMPARE(LabelImageCache::missCount(), 2);
+
+    // The red label was evicted to make room for the blue one
+    LabelImageCache::labelImage(font, text, Qt::gray, Qt::red, true);
+    QCOMPARE(LabelImageCache::missCount(), 3);
+    QCOMPARE(LabelImageCache::hitCount(), 1);
+
+    // With room for both, both stay cached
+    LabelImageCache::setMaxCost(2 * cost);
+    LabelImageCache::labelImage(font, text, Qt::gray, Qt::blue, true);
+    LabelImageCache::labelImage(font, text, Qt::gray, Qt::red, true);
+    LabelImageCache::labelImage(font, text, Qt::gray, Qt::blue, true);
+    QCOMPARE(LabelImageCache::missCount(), 4);
+    QCOMPARE(LabelImageCache::hitCount(), 3);
+}
+
+QTEST_MAIN(tst_labelimagecache)
+#include "tst_labelimagecache.moc"
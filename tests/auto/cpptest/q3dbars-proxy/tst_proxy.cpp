@@ -20,6 +20,8 @@ private slots:
     void initialProperties();
     void initializeProperties();
 
+    void setItems();
+
 private:
     QBarDataProxy *m_proxy;
 };
@@ -76,5 +78,45 @@ void tst_proxy::initializeProperties()
     QCOMPARE(m_proxy->rowLabels().count(), 1);
 }
 
+void tst_proxy::setItems()
+{
+    QVERIFY(m_proxy);
+
+    for (int i = 0; i < 3; i++) {
+        QBarDataRow *data = new QBarDataRow;
+        *data << 1.0f << 2.0f << 3.0f << 4.0f;
+        m_proxy->addRow(data);
+    }
+
+    QSignalSpy itemSpy(m_proxy, &QBarDataProxy::itemChanged);
+    QSignalSpy itemsSpy(m_proxy, &QBarDataProxy::itemsChanged);
+
+    QList<QPoint> positions;
+    positions << QPoint(2, 3) << QPoint(1, 0) << QPoint(2, 1);
+    QList<QBarDataItem> items;
+    items << QBarDataItem(10.0f) << QBarDataItem(20.0f) << QBarDataItem(30.0f);
+    m_proxy->setItems(positions, items);
+
+    QCOMPARE(m_proxy->itemAt(2, 3)->value(), 10.0f);
+    QCOMPARE(m_proxy->itemAt(1, 0)->value(), 20.0f);
+    QCOMPARE(m_proxy->itemAt(2, 1)->value(), 30.0f);
+    QCOMPARE(m_proxy->itemAt(0, 0)->value(), 1.0f);
+
+    QCOMPARE(itemSpy.count(), 0);
+    QCOMPARE(itemsSpy.count(), 1);
+    QCOMPARE(itemsSpy.at(0).at(0).toInt(), 1);
+    QList<QBitArray> changedColumns = itemsSpy.at(0).at(1).value<QList<QBitArray>>();
+    QCOMPARE(changedColumns.size(), 2);
+    QVERIFY(changedColumns.at(0).testBit(0));
+    QCOMPARE(changedColumns.at(0).count(true), 1);
+    QVERIFY(changedColumns.at(1).testBit(1));
+    QVERIFY(changedColumns.at(1).testBit(3));
+    QCOMPARE(changedColumns.at(1).count(true), 2);
+
+    // Empty change emits nothing
+    m_proxy->setItems(QList<QPoint>(), QList<QBarDataItem>());
+    QCOMPARE(itemsSpy.count(), 1);
+}
+
 QTEST_MAIN(tst_proxy)
 #include "tst_proxy.moc"
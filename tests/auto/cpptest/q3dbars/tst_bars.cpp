@@ -44,6 +44,7 @@ private slots:
     void removeCustomItem();
 
     void renderToImage();
+    void changeDataBeforeRender();
 
 private:
     Q3DBars *m_graph;
@@ -58,6 +59,25 @@ QBar3DSeries *newSeries()
     return series;
 }
 
+const QSize imageSize(200, 200);
+
+QBarDataRow *changedRow()
+{
+    QBarDataRow *data = new QBarDataRow;
+    *data << 4.0f << -2.0f << 1.5f << 6.0f << 3.3f;
+    return data;
+}
+
+// Renders the row with a graph that has never seen any other data
+QImage renderReference(QBarDataRow *row)
+{
+    Q3DBars graph;
+    QBar3DSeries *series = new QBar3DSeries;
+    series->dataProxy()->addRow(row);
+    graph.addSeries(series);
+    return graph.renderToImage(0, imageSize);
+}
+
 void tst_bars::initTestCase()
 {
     if (!CpptestUtil::isOpenGLSupported())
@@ -405,5 +425,20 @@ void tst_bars::renderToImage()
     */
 }
 
+void tst_bars::changeDataBeforeRender()
+{
+    QBar3DSeries *series = newSeries();
+    m_graph->addSeries(series);
+    m_graph->renderToImage(0, imageSize);
+
+    // The new row is only converted for rendering when the next frame is drawn
+    series->dataProxy()->setRow(0, changedRow());
+    QImage image = m_graph->renderToImage(0, imageSize);
+    QCOMPARE(image, renderReference(changedRow()));
+
+    // The snapshot is released once it has been converted
+    QVERIFY(series->dataProxy()->rowAt(0)->isDetached());
+}
+
 QTEST_MAIN(tst_bars)
 #include "tst_bars.moc"
@@ -4,6 +4,14 @@
 #include <QtTest/QtTest>
 
 #include <QtDataVisualization/QCustom3DVolume>
+#include <QtDataVisualization/private/qcustom3dvolume_p.h>
+
+// Exposes the private data, which holds the color table passed to the renderer
+class TestVolume : public QCustom3DVolume
+{
+public:
+    using QCustom3DVolume::dptr;
+};
 
 class tst_custom: public QObject
 {
@@ -21,6 +29,12 @@ private slots:
     void initializeProperties();
     void invalidProperties();
 
+    void subTextureBox();
+    void grayscaleFormats();
+    void shortColorTable();
+    void renderSlices();
+    void textureDataFile();
+
 private:
     QCustom3DVolume *m_custom;
 };
@@ -183,5 +197,173 @@ void tst_custom::invalidProperties()
     QCOMPARE(m_custom->textureFormat(), QImage::Format_ARGB32);
 }
 
+void tst_custom::subTextureBox()
+{
+    m_custom->setTextureFormat(QImage::Format_ARGB32);
+    m_custom->setTextureDimensions(4, 3, 2);
+    QList<uchar> *data = new QList<uchar>(4 * 4 * 3 * 2, 0);
+    m_custom->setTextureData(data);
+
+    QSignalSpy spy(m_custom, &QCustom3DVolume::textureDataChanged);
+
+    // 2x2x1 box starting at voxel (1, 1, 1)
+    const uchar box[16] = { 1, 1, 1, 1, 2, 2, 2, 2,
+                            3, 3, 3, 3, 4, 4, 4, 4 };
+    m_custom->setSubTextureData(1, 1, 1, 2, 2, 1, box);
+    QCOMPARE(spy.count(), 1);
+
+    const int lineSize = m_custom->textureDataWidth();
+    const int frameSize = lineSize * 3;
+    QCOMPARE(data->at(frameSize + lineSize + 4), uchar(1));
+    QCOMPARE(data->at(frameSize + lineSize + 8), uchar(2));
+    QCOMPARE(data->at(frameSize + 2 * lineSize + 4), uchar(3));
+    QCOMPARE(data->at(frameSize + 2 * lineSize + 8), uchar(4));
+    QCOMPARE(data->at(frameSize + lineSize), uchar(0));
+    QCOMPARE(data->at(lineSize + 4), uchar(0));
+
+    // Box outside of the volume is rejected
+    m_custom->setSubTextureData(3, 0, 0, 2, 1, 1, box);
+    m_custom->setSubTextureData(0, 0, 0, 1, 1, 1, nullptr);
+    QCOMPARE(spy.count(), 1);
+}
+
+void tst_custom::grayscaleFormats()
+{
+    m_custom->setTextureFormat(QImage::Format_Grayscale16);
+    QCOMPARE(m_custom->textureFormat(), QImage::Format_Grayscale16);
+    m_custom->setTextureDimensions(3, 2, 2);
+    // Lines of three 16-bit voxels are padded to eight bytes
+    QCOMPARE(m_custom->textureDataWidth(), 8);
+
+    QList<uchar> *data = new QList<uchar>(8 * 2 * 2, 0);
+    quint16 *voxels = reinterpret_cast<quint16 *>(data->data());
+    voxels[4 * 2 + 4 + 1] = 0x1234; // x = 1, y = 1, z = 1
+    m_custom->setTextureData(data);
+
+    QImage slice = m_custom->renderSlice(Qt::ZAxis, 1);
+    QCOMPARE(slice.format(), QImage::Format_Grayscale16);
+    QCOMPARE(slice.size(), QSize(3, 2));
+    QCOMPARE(reinterpret_cast<const quint16 *>(slice.constScanLine(1))[1], quint16(0x1234));
+    QCOMPARE(reinterpret_cast<const quint16 *>(slice.constScanLine(0))[1], quint16(0));
+
+    m_custom->setTextureFormat(QImage::Format_Grayscale8);
+    QCOMPARE(m_custom->textureFormat(), QImage::Format_Grayscale8);
+    QCOMPARE(m_custom->textureDataWidth(), 4);
+}
+
+void tst_custom::shortColorTable()
+{
+    TestVolume volume;
+    volume.setTextureFormat(QImage::Format_Grayscale8);
+
+    QList<QRgb> table;
+    table << qRgba(0, 0, 0, 0) << qRgba(255, 255, 255, 255);
+    volume.setColorTable(table);
+    QCOMPARE(volume.colorTable(), table);
+
+    // The two entries are stretched over the whole value range
+    QList<QRgb> renderTable = volume.dptr()->renderColorTable();
+    QCOMPARE(renderTable.size(), 256);
+    QCOMPARE(renderTable.at(0), qRgba(0, 0, 0, 0));
+    QCOMPARE(renderTable.at(128), qRgba(128, 128, 128, 128));
+    QCOMPARE(renderTable.at(255), qRgba(255, 255, 255, 255));
+
+    table << qRgba(255, 0, 0, 255);
+    volume.setColorTable(table);
+    renderTable = volume.dptr()->renderColorTable();
+    QCOMPARE(renderTable.size(), 256);
+    QCOMPARE(renderTable.at(0), table.at(0));
+    QCOMPARE(renderTable.at(255), table.at(2));
+
+    // A single entry applies to all values
+    volume.setColorTable(QList<QRgb>() << qRgba(10, 20, 30, 40));
+    renderTable = volume.dptr()->renderColorTable();
+    QCOMPARE(renderTable.size(), 256);
+    QCOMPARE(renderTable.at(100), qRgba(10, 20, 30, 40));
+
+    // Indexed tables are used as such
+    volume.setTextureFormat(QImage::Format_Indexed8);
+    volume.setColorTable(table);
+    QCOMPARE(volume.dptr()->renderColorTable(), table);
+}
+
+void tst_custom::renderSlices()
+{
+    // Large enough for the slices along the Z axis to be extracted in parallel
+    const int width = 300;
+    const int height = 300;
+    const int depth = 4;
+    m_custom->setTextureFormat(QImage::Format_ARGB32);
+    m_custom->setTextureDimensions(width, height, depth);
+    QList<uchar> *data = new QList<uchar>(width * height * depth * 4);
+    QRgb *voxels = reinterpret_cast<QRgb *>(data->data());
+    for (int z = 0; z < depth; z++) {
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++)
+                voxels[(z * height + y) * width + x] = qRgba(x % 256, y % 256, z, 200);
+        }
+    }
+    m_custom->setTextureData(data);
+    m_custom->setAlphaMultiplier(0.5f);
+
+    QImage slice = m_custom->renderSlice(Qt::ZAxis, 2);
+    QCOMPARE(slice.size(), QSize(width, height));
+    QCOMPARE(slice.pixel(0, 0), qRgba(0, 0, 2, 100));
+    QCOMPARE(slice.pixel(123, 45), qRgba(123, 45, 2, 100));
+    QCOMPARE(slice.pixel(width - 1, height - 1), qRgba(43, 43, 2, 100));
+
+    // X slices run along the depth, Y slices are flipped vertically
+    slice = m_custom->renderSlice(Qt::XAxis, 7);
+    QCOMPARE(slice.size(), QSize(depth, height));
+    QCOMPARE(slice.pixel(3, 210), qRgba(7, 210, 3, 100));
+    slice = m_custom->renderSlice(Qt::YAxis, 20);
+    QCOMPARE(slice.size(), QSize(width, depth));
+    QCOMPARE(slice.pixel(250, 0), qRgba(250, 20, 3, 100));
+    QCOMPARE(slice.pixel(250, depth - 1), qRgba(250, 20, 0, 100));
+
+    QVERIFY(m_custom->renderSlice(Qt::YAxis, height).isNull());
+}
+
+void tst_custom::textureDataFile()
+{
+    m_custom->setTextureFormat(QImage::Format_Grayscale8);
+    m_custom->setTextureDimensions(4, 2, 3);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    // Header that is skipped with the offset
+    file.write("VOL0", 4);
+    QByteArray voxels(4 * 2 * 3, 0);
+    for (int i = 0; i < voxels.size(); i++)
+        voxels[i] = char(i);
+    file.write(voxels);
+    file.flush();
+
+    QVERIFY(!m_custom->setTextureDataFile(QStringLiteral("nonexistent.raw")));
+    QVERIFY(!m_custom->setTextureDataFile(file.fileName(), 8));
+    QVERIFY(m_custom->textureDataFile().isEmpty());
+
+    m_custom->setTextureData(new QList<uchar>(4 * 2 * 3, 0));
+    QSignalSpy spy(m_custom, &QCustom3DVolume::textureDataChanged);
+    QVERIFY(m_custom->setTextureDataFile(file.fileName(), 4));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(m_custom->textureDataFile(), file.fileName());
+    QVERIFY(!m_custom->textureData());
+
+    // Slices are read directly from the file
+    QImage slice = m_custom->renderSlice(Qt::ZAxis, 2);
+    QCOMPARE(slice.size(), QSize(4, 2));
+    QCOMPARE(slice.constScanLine(1)[3], uchar(2 * 8 + 4 + 3));
+
+    // The file is read only
+    const uchar box[1] = { 1 };
+    m_custom->setSubTextureData(0, 0, 0, 1, 1, 1, box);
+    QCOMPARE(spy.count(), 1);
+
+    m_custom->setTextureData(new QList<uchar>(4 * 2 * 3, 0));
+    QVERIFY(m_custom->textureDataFile().isEmpty());
+    QVERIFY(m_custom->textureData());
+}
+
 QTEST_MAIN(tst_custom)
 #include "tst_custom.moc"
@@ -105,6 +105,14 @@ void tst_custom::initializeProperties()
 
     m_custom->setTextureImage(QImage(QSize(10, 10), QImage::Format_ARGB32));
     QCOMPARE(m_custom->textureFile(), QString());
+
+    m_custom->setTextureFile(":/customtexture.jpg");
+    QSignalSpy spy(m_custom, &QCustom3DItem::textureFileChanged);
+    m_custom->updateTextureImage(QImage(QSize(10, 10), QImage::Format_ARGB32));
+    QCOMPARE(spy.size(), 1);
+    QCOMPARE(m_custom->textureFile(), QString());
+    m_custom->updateTextureImage(QImage(QSize(10, 10), QImage::Format_ARGB32));
+    QCOMPARE(spy.size(), 1);
 }
 
 QTEST_MAIN(tst_custom)
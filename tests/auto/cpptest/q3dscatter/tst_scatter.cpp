@@ -30,6 +30,9 @@ private slots:
     void removeMultipleSeries();
     void hasSeries();
 
+    void changeDataBeforeRender();
+    void selectItemBeforeRender();
+
 private:
     Q3DScatter *m_graph;
 };
@@ -43,6 +46,27 @@ QScatter3DSeries *newSeries()
     return series;
 }
 
+const QSize imageSize(200, 200);
+
+QScatterDataArray movedData()
+{
+    QScatterDataArray data;
+    data << QVector3D(-0.5f, 0.2f, 0.1f) << QVector3D(0.4f, -0.1f, -0.5f) << QVector3D(0.1f, 0.3f, 0.4f)
+         << QVector3D(-0.2f, -0.4f, 0.3f) << QVector3D(0.3f, 0.5f, -0.2f) << QVector3D(0.0f, 0.0f, 0.0f);
+    return data;
+}
+
+// Renders the data with a graph that has never seen any other data
+QImage renderReference(const QScatterDataArray &data, int selectedItem)
+{
+    Q3DScatter graph;
+    QScatter3DSeries *series = new QScatter3DSeries;
+    series->dataProxy()->resetArray(new QScatterDataArray(data));
+    graph.addSeries(series);
+    series->setSelectedItem(selectedItem);
+    return graph.renderToImage(0, imageSize);
+}
+
 void tst_scatter::initTestCase()
 {
     if (!CpptestUtil::isOpenGLSupported())
@@ -237,5 +261,44 @@ void tst_scatter::hasSeries()
     QCOMPARE(m_graph->hasSeries(series2), false);
 }
 
+void tst_scatter::changeDataBeforeRender()
+{
+    QScatter3DSeries *series = newSeries();
+    m_graph->addSeries(series);
+    QImage image = m_graph->renderToImage(0, imageSize);
+    QCOMPARE(image.size(), imageSize);
+
+    // The new data is only converted for rendering when the next frame is drawn
+    series->dataProxy()->resetArray(new QScatterDataArray(movedData()));
+    image = m_graph->renderToImage(0, imageSize);
+    QImage reference = renderReference(movedData(), QScatter3DSeries::invalidSelectionIndex());
+    QCOMPARE(image, reference);
+
+    // The snapshot is released once it has been converted, so the proxy is the only owner of
+    // its array again and rendering without changes has nothing left to convert
+    QVERIFY(series->dataProxy()->array()->isDetached());
+    image = m_graph->renderToImage(0, imageSize);
+    QCOMPARE(image, reference);
+}
+
+void tst_scatter::selectItemBeforeRender()
+{
+    QScatter3DSeries *series = newSeries();
+    m_graph->addSeries(series);
+    m_graph->renderToImage(0, imageSize);
+
+    // Select an item that only exists in the data not yet converted for rendering
+    QScatterDataArray data = movedData();
+    series->dataProxy()->resetArray(new QScatterDataArray(data));
+    series->setSelectedItem(4);
+    QCOMPARE(series->selectedItem(), 4);
+    QCOMPARE(m_graph->selectedSeries(), series);
+
+    QImage image = m_graph->renderToImage(0, imageSize);
+    QCOMPARE(series->selectedItem(), 4);
+    QCOMPARE(image, renderReference(data, 4));
+    QVERIFY(image != renderReference(data, QScatter3DSeries::invalidSelectionIndex()));
+}
+
 QTEST_MAIN(tst_scatter)
 #include "tst_scatter.moc"
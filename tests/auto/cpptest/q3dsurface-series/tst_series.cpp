@@ -20,6 +20,7 @@ private slots:
     void initialProperties();
     void initializeProperties();
     void invalidProperties();
+    void updateTexture();
 
 private:
     QSurface3DSeries *m_series;
@@ -101,5 +102,31 @@ void tst_series::invalidProperties()
     QCOMPARE(m_series->mesh(), QAbstract3DSeries::MeshSphere);
 }
 
+void tst_series::updateTexture()
+{
+    QSignalSpy spy(m_series, &QSurface3DSeries::textureChanged);
+
+    QImage texture(QSize(16, 16), QImage::Format_ARGB32);
+    texture.fill(Qt::red);
+    m_series->setTexture(texture);
+    QCOMPARE(spy.size(), 1);
+
+    // Updates are not compared to the previous texture
+    m_series->updateTexture(texture);
+    QCOMPARE(spy.size(), 2);
+    QCOMPARE(m_series->texture(), texture);
+
+    QImage newTexture(QSize(16, 16), QImage::Format_ARGB32);
+    newTexture.fill(Qt::blue);
+    m_series->updateTexture(newTexture);
+    QCOMPARE(spy.size(), 3);
+    QCOMPARE(m_series->texture(), newTexture);
+    QCOMPARE(m_series->textureFile(), QString());
+
+    m_series->updateTexture(QImage());
+    QCOMPARE(spy.size(), 4);
+    QVERIFY(m_series->texture().isNull());
+}
+
 QTEST_MAIN(tst_series)
 #include "tst_series.moc"
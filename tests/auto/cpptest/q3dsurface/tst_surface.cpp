@@ -30,6 +30,8 @@ private slots:
     void removeMultipleSeries();
     void hasSeries();
 
+    void changeDataBeforeRender();
+
 private:
     Q3DSurface *m_graph;
 };
@@ -48,6 +50,34 @@ QSurface3DSeries *newSeries()
     return series;
 }
 
+const QSize imageSize(200, 200);
+
+QSurfaceDataArray *changedData()
+{
+    QSurfaceDataArray *data = new QSurfaceDataArray;
+    QSurfaceDataRow *dataRow1 = new QSurfaceDataRow;
+    QSurfaceDataRow *dataRow2 = new QSurfaceDataRow;
+    QSurfaceDataRow *dataRow3 = new QSurfaceDataRow;
+    *dataRow1 << QVector3D(0.0f, 1.1f, 0.5f) << QVector3D(0.5f, 0.2f, 0.5f)
+              << QVector3D(1.0f, 0.7f, 0.5f);
+    *dataRow2 << QVector3D(0.0f, 0.4f, 0.8f) << QVector3D(0.5f, 1.6f, 0.8f)
+              << QVector3D(1.0f, 0.3f, 0.8f);
+    *dataRow3 << QVector3D(0.0f, 1.4f, 1.0f) << QVector3D(0.5f, 0.9f, 1.0f)
+              << QVector3D(1.0f, 1.9f, 1.0f);
+    *data << dataRow1 << dataRow2 << dataRow3;
+    return data;
+}
+
+// Renders the data with a graph that has never seen any other data
+QImage renderReference(QSurfaceDataArray *data)
+{
+    Q3DSurface graph;
+    QSurface3DSeries *series = new QSurface3DSeries;
+    series->dataProxy()->resetArray(data);
+    graph.addSeries(series);
+    return graph.renderToImage(0, imageSize);
+}
+
 void tst_surface::initTestCase()
 {
     if (!CpptestUtil::isOpenGLSupported())
@@ -247,5 +277,22 @@ void tst_surface::hasSeries()
     QCOMPARE(m_graph->hasSeries(series2), false);
 }
 
+void tst_surface::changeDataBeforeRender()
+{
+    QSurface3DSeries *series = newSeries();
+    m_graph->addSeries(series);
+    m_graph->renderToImage(0, imageSize);
+
+    // The new data is only sampled for rendering when the next frame is drawn
+    series->dataProxy()->resetArray(changedData());
+    QImage image = m_graph->renderToImage(0, imageSize);
+    QCOMPARE(image, renderReference(changedData()));
+
+    // The snapshot is released once it has been converted
+    const QSurfaceDataArray &array = *series->dataProxy()->array();
+    for (int i = 0; i < array.size(); i++)
+        QVERIFY(array.at(i)->isDetached());
+}
+
 QTEST_MAIN(tst_surface)
 #include "tst_surface.moc"
@@ -4,6 +4,13 @@
 #include <QtTest/QtTest>
 
 #include <QtDataVisualization/Q3DTheme>
+#include <QtDataVisualization/QBar3DSeries>
+#include <QtDataVisualization/private/bars3dcontroller_p.h>
+#include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLContext>
+#include <QtOpenGL/QOpenGLFramebufferObject>
+
+#include "cpptestutil.h"
 
 class tst_theme: public QObject
 {
@@ -21,7 +28,11 @@ private slots:
     void initializeProperties();
     void invalidProperties();
 
+    void renderChangedTheme();
+
 private:
+    QImage renderFrame(Abstract3DController *controller, QOpenGLFramebufferObject *fbo);
+
     Q3DTheme *m_theme;
 };
 
@@ -195,5 +206,60 @@ void tst_theme::invalidProperties()
     QCOMPARE(m_theme->lightStrength(), 5.0f);
 }
 
+// Renders a frame the way a graph window does, and returns what was rendered
+QImage tst_theme::renderFrame(Abstract3DController *controller, QOpenGLFramebufferObject *fbo)
+{
+    controller->synchDataToRenderer();
+    fbo->bind();
+    controller->render(fbo->handle());
+    fbo->release();
+    return fbo->toImage();
+}
+
+void tst_theme::renderChangedTheme()
+{
+    if (!CpptestUtil::isOpenGLSupported())
+        QSKIP("OpenGL not supported on this platform");
+
+    QOpenGLContext context;
+    QVERIFY(context.create());
+    QOffscreenSurface surface;
+    surface.setFormat(context.format());
+    surface.create();
+    QVERIFY(context.makeCurrent(&surface));
+
+    const QSize size(200, 200);
+    QOpenGLFramebufferObjectFormat format;
+    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    QOpenGLFramebufferObject fbo(size, format);
+    QVERIFY(fbo.isValid());
+
+    Bars3DController *controller = new Bars3DController(QRect(QPoint(0, 0), size));
+    QBar3DSeries *series = new QBar3DSeries;
+    QBarDataRow *row = new QBarDataRow;
+    *row << 1.0f << 3.0f << 2.0f;
+    series->dataProxy()->addRow(row);
+    controller->addSeries(series);
+    controller->initializeOpenGL();
+
+    // Nothing changes between the second and the third frame, so the third one is drawn from
+    // the copy stored of the second one
+    renderFrame(controller, &fbo);
+    QImage stored = renderFrame(controller, &fbo);
+    QCOMPARE(renderFrame(controller, &fbo), stored);
+
+    // Theme changes must not leave the stored frame on screen
+    controller->activeTheme()->setBackgroundColor(Qt::red);
+    QImage changed = renderFrame(controller, &fbo);
+    QVERIFY(changed != stored);
+    QCOMPARE(renderFrame(controller, &fbo), changed);
+
+    controller->activeTheme()->setGridEnabled(!controller->activeTheme()->isGridEnabled());
+    QVERIFY(renderFrame(controller, &fbo) != changed);
+
+    delete controller;
+    context.doneCurrent();
+}
+
 QTEST_MAIN(tst_theme)
 #include "tst_theme.moc"
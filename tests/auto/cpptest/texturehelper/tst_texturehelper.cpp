@@ -0,0 +1,180 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/private/texturehelper_p.h>
+
+class tst_texturehelper: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void convertToGLFormat_data();
+    void convertToGLFormat();
+    void prepareDesktop_data();
+    void prepareDesktop();
+    void prepareES_data();
+    void prepareES();
+    void bgraUpload();
+    void unconvertedUpload();
+
+private:
+    void addImageData();
+};
+
+// Texels of the image mirrored vertically, in GL_RGBA byte order
+static QByteArray referenceBytes(const QImage &image)
+{
+    const QImage argb = image.convertToFormat(QImage::Format_ARGB32);
+    QByteArray result;
+    for (int y = argb.height() - 1; y >= 0; y--) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(argb.constScanLine(y));
+        for (int x = 0; x < argb.width(); x++) {
+            result.append(char(qRed(line[x])));
+            result.append(char(qGreen(line[x])));
+            result.append(char(qBlue(line[x])));
+            result.append(char(qAlpha(line[x])));
+        }
+    }
+    return result;
+}
+
+// Bytes of a prepared image as the graphics hardware sees them, in GL_RGBA byte order
+static QByteArray uploadedBytes(const QImage &preparedImage, GLenum format)
+{
+#if !QT_CONFIG(opengles2)
+    const bool isBgra = (format == GL_BGRA);
+#else
+    Q_UNUSED(format);
+    const bool isBgra = false;
+#endif
+    QByteArray result;
+    for (int y = 0; y < preparedImage.height(); y++) {
+        const char *line = reinterpret_cast<const char *>(preparedImage.constScanLine(y));
+        for (int x = 0; x < preparedImage.width(); x++) {
+            const char *texel = line + x * 4;
+            if (isBgra) {
+                result.append(texel[2]);
+                result.append(texel[1]);
+                result.append(texel[0]);
+                result.append(texel[3]);
+            } else {
+                result.append(texel, 4);
+            }
+        }
+    }
+    return result;
+}
+
+static QImage testImage(const QSize &size, QImage::Format format)
+{
+    QImage image(size, QImage::Format_ARGB32);
+    for (int y = 0; y < size.height(); y++) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < size.width(); x++)
+            line[x] = qRgba((x * 7) & 0xff, (y * 13) & 0xff, (x + y) & 0xff, (x * y + 64) & 0xff);
+    }
+    return image.convertToFormat(format);
+}
+
+void tst_texturehelper::addImageData()
+{
+    QTest::addColumn<QImage>("image");
+
+    QTest::newRow("argb32") << testImage(QSize(64, 32), QImage::Format_ARGB32);
+    QTest::newRow("odd size") << testImage(QSize(37, 13), QImage::Format_ARGB32);
+    QTest::newRow("premultiplied") << testImage(QSize(64, 64),
+                                                QImage::Format_ARGB32_Premultiplied);
+    QTest::newRow("rgb32") << testImage(QSize(64, 64), QImage::Format_RGB32);
+    QTest::newRow("rgb888") << testImage(QSize(32, 64), QImage::Format_RGB888);
+}
+
+void tst_texturehelper::convertToGLFormat_data()
+{
+    addImageData();
+}
+
+void tst_texturehelper::convertToGLFormat()
+{
+    QFETCH(QImage, image);
+
+    QImage converted = TextureHelper::convertToGLFormat(image);
+    QCOMPARE(converted.format(), QImage::Format_RGBA8888);
+    QCOMPARE(converted.size(), image.size());
+    QCOMPARE(uploadedBytes(converted, GL_RGBA), referenceBytes(image));
+}
+
+void tst_texturehelper::prepareDesktop_data()
+{
+    addImageData();
+}
+
+void tst_texturehelper::prepareDesktop()
+{
+    QFETCH(QImage, image);
+
+    QImage prepared = TextureHelper::prepare2DTextureImage(image, false);
+    QCOMPARE(prepared.size(), image.size());
+    QCOMPARE(uploadedBytes(prepared, TextureHelper::uploadFormat(prepared, false)),
+             referenceBytes(image));
+}
+
+void tst_texturehelper::prepareES_data()
+{
+    addImageData();
+}
+
+void tst_texturehelper::prepareES()
+{
+    QFETCH(QImage, image);
+
+    // Other sizes are scaled to powers of two, which changes the texels
+    if ((image.width() & (image.width() - 1)) || (image.height() & (image.height() - 1)))
+        QSKIP("Image is scaled");
+
+    QImage prepared = TextureHelper::prepare2DTextureImage(image, true);
+    QCOMPARE(prepared.format(), QImage::Format_RGBA8888);
+    QCOMPARE(TextureHelper::uploadFormat(prepared, true), GLenum(GL_RGBA));
+    QCOMPARE(uploadedBytes(prepared, GL_RGBA), referenceBytes(image));
+}
+
+void tst_texturehelper::bgraUpload()
+{
+#if QT_CONFIG(opengles2)
+    QSKIP("BGRA uploads are not used with OpenGL ES");
+#else
+    if (QSysInfo::ByteOrder != QSysInfo::LittleEndian)
+        QSKIP("BGRA uploads are only used on little endian hosts");
+
+    // ARGB32 images are only mirrored, and their bytes are taken as BGRA
+    QImage image = testImage(QSize(37, 13), QImage::Format_ARGB32);
+    QImage prepared = TextureHelper::prepare2DTextureImage(image, false);
+    QCOMPARE(prepared.format(), QImage::Format_ARGB32);
+    QCOMPARE(TextureHelper::uploadFormat(prepared, false), GLenum(GL_BGRA));
+    QCOMPARE(TextureHelper::uploadFormat(prepared, true), GLenum(GL_RGBA));
+    QCOMPARE(uploadedBytes(prepared, GL_BGRA), referenceBytes(image));
+
+    // Other formats are converted
+    image = testImage(QSize(37, 13), QImage::Format_ARGB32_Premultiplied);
+    prepared = TextureHelper::prepare2DTextureImage(image, false);
+    QCOMPARE(prepared.format(), QImage::Format_RGBA8888);
+    QCOMPARE(TextureHelper::uploadFormat(prepared, false), GLenum(GL_RGBA));
+#endif
+}
+
+void tst_texturehelper::unconvertedUpload()
+{
+    // Unconverted ARGB32 images are neither mirrored nor uploaded as BGRA
+    QImage image = testImage(QSize(16, 8), QImage::Format_ARGB32);
+    QImage prepared = TextureHelper::prepare2DTextureImage(image, false, false);
+    QCOMPARE(prepared.format(), QImage::Format_RGBA8888);
+    QCOMPARE(TextureHelper::uploadFormat(prepared, false), GLenum(GL_RGBA));
+    QCOMPARE(QByteArray(reinterpret_cast<const char *>(prepared.constBits()),
+                        int(prepared.sizeInBytes())),
+             QByteArray(reinterpret_cast<const char *>(image.constBits()),
+                        int(image.sizeInBytes())));
+}
+
+QTEST_MAIN(tst_texturehelper)
+#include "tst_texturehelper.moc"
@@ -0,0 +1,183 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/private/meshloader_p.h>
+
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTextStream>
+
+class tst_bench_meshloader: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void compareLoaders();
+    void textStreamLoader_data();
+    void textStreamLoader();
+    void meshLoader_data();
+    void meshLoader();
+
+private:
+    void writeGrid(const QString &path, int size);
+    void addData();
+
+    QTemporaryDir m_dir;
+};
+
+// The QTextStream and QString::split based loader MeshLoader::loadOBJ used to be,
+// kept here as the reference
+static bool textStreamLoadOBJ(const QString &path, QList<QVector3D> &out_vertices,
+                              QList<QVector2D> &out_uvs, QList<QVector3D> &out_normals)
+{
+    QList<unsigned int> vertexIndices, uvIndices, normalIndices;
+    QList<QVector3D> temp_vertices;
+    QList<QVector2D> temp_uvs;
+    QList<QVector3D> temp_normals;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+
+    QTextStream textIn(&file);
+    while (!textIn.atEnd()) {
+        QString line = textIn.readLine();
+        QStringList lineContents = line.split(QStringLiteral(" "));
+        if (!lineContents.at(0).compare(QStringLiteral("v"))) {
+            temp_vertices.append(QVector3D(lineContents.at(1).toFloat(),
+                                           lineContents.at(2).toFloat(),
+                                           lineContents.at(3).toFloat()));
+        } else if (!lineContents.at(0).compare(QStringLiteral("vt"))) {
+            temp_uvs.append(QVector2D(lineContents.at(1).toFloat(),
+                                      lineContents.at(2).toFloat()));
+        } else if (!lineContents.at(0).compare(QStringLiteral("vn"))) {
+            temp_normals.append(QVector3D(lineContents.at(1).toFloat(),
+                                          lineContents.at(2).toFloat(),
+                                          lineContents.at(3).toFloat()));
+        } else if (!lineContents.at(0).compare(QStringLiteral("f"))) {
+            for (int i = 1; i <= 3; i++) {
+                QStringList set = lineContents.at(i).split(QStringLiteral("/"));
+                vertexIndices.append(set.at(0).toUInt());
+                uvIndices.append(set.at(1).toUInt());
+                normalIndices.append(set.at(2).toUInt());
+            }
+        }
+    }
+
+    for (int i = 0; i < vertexIndices.size(); i++) {
+        out_vertices.append(temp_vertices[vertexIndices[i] - 1]);
+        out_uvs.append(temp_uvs[uvIndices[i] - 1]);
+        out_normals.append(temp_normals[normalIndices[i] - 1]);
+    }
+
+    return true;
+}
+
+void tst_bench_meshloader::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    writeGrid(m_dir.filePath(QStringLiteral("small.obj")), 10);
+    writeGrid(m_dir.filePath(QStringLiteral("medium.obj")), 100);
+    writeGrid(m_dir.filePath(QStringLiteral("large.obj")), 500);
+}
+
+void tst_bench_meshloader::writeGrid(const QString &path, int size)
+{
+    // A size x size grid of quads, split into triangles
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    QTextStream out(&file);
+    out << "# Benchmark grid\no grid\n";
+    for (int z = 0; z <= size; z++) {
+        for (int x = 0; x <= size; x++) {
+            const float fx = float(x) / float(size);
+            const float fz = float(z) / float(size);
+            out << "v " << fx * 2.0f - 1.0f << ' ' << qSin(fx * 6.0f) * 0.1f << ' '
+                << fz * 2.0f - 1.0f << '\n';
+            out << "vt " << fx << ' ' << fz << '\n';
+            out << "vn " << 0.0f << ' ' << 1.0f << ' ' << 0.0f << '\n';
+        }
+    }
+    out << "s off\n";
+    const int row = size + 1;
+    for (int z = 0; z < size; z++) {
+        for (int x = 0; x < size; x++) {
+            const int a = z * row + x + 1;
+            const int b = a + 1;
+            const int c = a + row;
+            const int d = c + 1;
+            out << "f " << a << '/' << a << '/' << a << ' ' << c << '/' << c << '/' << c
+                << ' ' << b << '/' << b << '/' << b << '\n';
+            out << "f " << b << '/' << b << '/' << b << ' ' << c << '/' << c << '/' << c
+                << ' ' << d << '/' << d << '/' << d << '\n';
+        }
+    }
+}
+
+void tst_bench_meshloader::addData()
+{
+    QTest::addColumn<QString>("fileName");
+
+    QTest::newRow("small") << m_dir.filePath(QStringLiteral("small.obj"));
+    QTest::newRow("medium") << m_dir.filePath(QStringLiteral("medium.obj"));
+    QTest::newRow("large") << m_dir.filePath(QStringLiteral("large.obj"));
+}
+
+void tst_bench_meshloader::compareLoaders()
+{
+    // Both loaders must produce the same flat attribute lists
+    const QString fileName = m_dir.filePath(QStringLiteral("medium.obj"));
+    QList<QVector3D> vertices;
+    QList<QVector2D> uvs;
+    QList<QVector3D> normals;
+    QVERIFY(textStreamLoadOBJ(fileName, vertices, uvs, normals));
+
+    QList<QVector3D> newVertices;
+    QList<QVector2D> newUvs;
+    QList<QVector3D> newNormals;
+    QVERIFY(MeshLoader::loadOBJ(fileName, newVertices, newUvs, newNormals));
+
+    QCOMPARE(newVertices, vertices);
+    QCOMPARE(newUvs, uvs);
+    QCOMPARE(newNormals, normals);
+}
+
+void tst_bench_meshloader::textStreamLoader_data()
+{
+    addData();
+}
+
+void tst_bench_meshloader::textStreamLoader()
+{
+    QFETCH(QString, fileName);
+
+    QBENCHMARK {
+        QList<QVector3D> vertices;
+        QList<QVector2D> uvs;
+        QList<QVector3D> normals;
+        textStreamLoadOBJ(fileName, vertices, uvs, normals);
+    }
+}
+
+void tst_bench_meshloader::meshLoader_data()
+{
+    addData();
+}
+
+void tst_bench_meshloader::meshLoader()
+{
+    QFETCH(QString, fileName);
+
+    QBENCHMARK {
+        QList<QVector3D> vertices;
+        QList<QVector2D> uvs;
+        QList<QVector3D> normals;
+        MeshLoader::loadOBJ(fileName, vertices, uvs, normals);
+    }
+}
+
+QTEST_MAIN(tst_bench_meshloader)
+#include "tst_bench_meshloader.moc"
@@ -0,0 +1,119 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/private/texturehelper_p.h>
+
+class tst_bench_texturehelper: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void perPixelConversion_data();
+    void perPixelConversion();
+    void rgbaConversion_data();
+    void rgbaConversion();
+    void bgraConversion_data();
+    void bgraConversion();
+
+private:
+    void addImageData();
+};
+
+// The per pixel swizzle and mirror TextureHelper used to do for GL_RGBA uploads, kept here
+// as the baseline. Returns the texels in GL_RGBA byte order.
+static QByteArray perPixelConvert(const QImage &image)
+{
+    const QImage srcImage = image.convertToFormat(QImage::Format_ARGB32);
+    const int width = srcImage.width();
+    const int height = srcImage.height();
+    QByteArray result(width * height * 4, Qt::Uninitialized);
+    uint *q = reinterpret_cast<uint *>(result.data());
+    for (int i = 0; i < height; ++i) {
+        const uint *p = reinterpret_cast<const uint *>(srcImage.constScanLine(height - 1 - i));
+        const uint *end = p + width;
+        while (p < end) {
+            if (QSysInfo::ByteOrder == QSysInfo::BigEndian)
+                *q = (*p << 8) | ((*p >> 24) & 0xff);
+            else
+                *q = ((*p << 16) & 0xff0000) | ((*p >> 16) & 0xff) | (*p & 0xff00ff00);
+            p++;
+            q++;
+        }
+    }
+    return result;
+}
+
+static QImage testImage(const QSize &size, QImage::Format format)
+{
+    QImage image(size, QImage::Format_ARGB32);
+    for (int y = 0; y < size.height(); y++) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < size.width(); x++)
+            line[x] = qRgba((x * 7) & 0xff, (y * 13) & 0xff, (x + y) & 0xff, (x * y + 64) & 0xff);
+    }
+    return image.convertToFormat(format);
+}
+
+void tst_bench_texturehelper::addImageData()
+{
+    QTest::addColumn<QImage>("image");
+
+    QTest::newRow("label") << testImage(QSize(256, 64), QImage::Format_ARGB32);
+    QTest::newRow("odd size") << testImage(QSize(37, 13), QImage::Format_ARGB32);
+    QTest::newRow("premultiplied") << testImage(QSize(512, 512),
+                                                QImage::Format_ARGB32_Premultiplied);
+    QTest::newRow("rgb32") << testImage(QSize(512, 512), QImage::Format_RGB32);
+    QTest::newRow("rgb888") << testImage(QSize(512, 512), QImage::Format_RGB888);
+    QTest::newRow("large") << testImage(QSize(2048, 2048), QImage::Format_ARGB32);
+}
+
+void tst_bench_texturehelper::perPixelConversion_data()
+{
+    addImageData();
+}
+
+void tst_bench_texturehelper::perPixelConversion()
+{
+    QFETCH(QImage, image);
+
+    QBENCHMARK {
+        QByteArray result = perPixelConvert(image);
+        Q_UNUSED(result);
+    }
+}
+
+void tst_bench_texturehelper::rgbaConversion_data()
+{
+    addImageData();
+}
+
+void tst_bench_texturehelper::rgbaConversion()
+{
+    QFETCH(QImage, image);
+
+    // The conversion the ES path does after its power of two scaling
+    QBENCHMARK {
+        QImage result = TextureHelper::convertToGLFormat(image);
+        Q_UNUSED(result);
+    }
+}
+
+void tst_bench_texturehelper::bgraConversion_data()
+{
+    addImageData();
+}
+
+void tst_bench_texturehelper::bgraConversion()
+{
+    QFETCH(QImage, image);
+
+    QBENCHMARK {
+        QImage result = TextureHelper::prepare2DTextureImage(image, false);
+        Q_UNUSED(result);
+    }
+}
+
+QTEST_MAIN(tst_bench_texturehelper)
+#include "tst_bench_texturehelper.moc"
@@ -0,0 +1,117 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/Q3DCamera>
+#include <QtDataVisualization/Q3DScatter>
+#include <QtDataVisualization/QCustom3DVolume>
+
+#include "cpptestutil.h"
+
+// Renders reference volumes with a fixed camera. The volumes have equal size and differ only
+// in how much of them is visible, so the results show what empty space costs to render.
+class tst_bench_volumerendering: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void render_data();
+    void render();
+};
+
+static const int volumeSize = 256;
+static const QSize imageSize(512, 512);
+
+enum VolumeContent {
+    EmptyVolume,
+    SparseVolume,
+    DenseVolume
+};
+
+Q_DECLARE_METATYPE(VolumeContent)
+
+// Creates an indexed volume where color index zero is fully transparent.
+// The sparse volume holds a handful of small spheres, the dense one a noisy solid block.
+static QCustom3DVolume *createVolume(VolumeContent content)
+{
+    QList<uchar> *data = new QList<uchar>(volumeSize * volumeSize * volumeSize, 0);
+    uchar *voxels = data->data();
+    if (content == SparseVolume) {
+        const QVector3D centers[] = { QVector3D(64, 64, 64), QVector3D(192, 96, 160),
+                                      QVector3D(128, 200, 48), QVector3D(40, 180, 210) };
+        const float radius = 12.0f;
+        for (const QVector3D &center : centers) {
+            for (int z = int(center.z() - radius); z <= int(center.z() + radius); z++) {
+                for (int y = int(center.y() - radius); y <= int(center.y() + radius); y++) {
+                    for (int x = int(center.x() - radius); x <= int(center.x() + radius); x++) {
+                        if ((QVector3D(x, y, z) - center).length() <= radius)
+                            voxels[(z * volumeSize + y) * volumeSize + x] = 200;
+                    }
+                }
+            }
+        }
+    } else if (content == DenseVolume) {
+        for (int i = 0; i < data->size(); i++)
+            voxels[i] = uchar(1 + (i * 31) % 255);
+    }
+
+    QList<QRgb> colorTable(256);
+    colorTable[0] = qRgba(0, 0, 0, 0);
+    for (int i = 1; i < 256; i++)
+        colorTable[i] = qRgba(i, 255 - i, 128, 16 + i / 4);
+
+    QCustom3DVolume *volume = new QCustom3DVolume;
+    volume->setScaling(QVector3D(2.0f, 2.0f, 2.0f));
+    volume->setTextureFormat(QImage::Format_Indexed8);
+    volume->setTextureDimensions(volumeSize, volumeSize, volumeSize);
+    volume->setColorTable(colorTable);
+    volume->setTextureData(data);
+    return volume;
+}
+
+void tst_bench_volumerendering::initTestCase()
+{
+    if (!CpptestUtil::isOpenGLSupported())
+        QSKIP("OpenGL not supported on this platform");
+}
+
+void tst_bench_volumerendering::render_data()
+{
+    QTest::addColumn<VolumeContent>("content");
+    QTest::addColumn<bool>("highDefShader");
+
+    QTest::newRow("empty") << EmptyVolume << true;
+    QTest::newRow("sparse") << SparseVolume << true;
+    QTest::newRow("dense") << DenseVolume << true;
+    QTest::newRow("sparse, low def") << SparseVolume << false;
+    QTest::newRow("dense, low def") << DenseVolume << false;
+}
+
+void tst_bench_volumerendering::render()
+{
+    QFETCH(VolumeContent, content);
+    QFETCH(bool, highDefShader);
+
+    Q3DScatter graph;
+    graph.setShadowQuality(QAbstract3DGraph::ShadowQualityNone);
+    graph.scene()->activeCamera()->setCameraPreset(Q3DCamera::CameraPresetIsometricRightHigh);
+    graph.scene()->activeCamera()->setZoomLevel(150.0f);
+
+    QCustom3DVolume *volume = createVolume(content);
+    volume->setUseHighDefShader(highDefShader);
+    graph.addCustomItem(volume);
+
+    // The first frame uploads the volume, keep it out of the measurement
+    QImage image = graph.renderToImage(0, imageSize);
+    QVERIFY(!image.isNull());
+
+    QBENCHMARK {
+        image = graph.renderToImage(0, imageSize);
+    }
+}
+
+QTEST_MAIN(tst_bench_volumerendering)
+#include "tst_bench_volumerendering.moc"
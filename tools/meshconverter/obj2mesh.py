@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+# Copyright (C) 2016 The Qt Company Ltd.
+# SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+"""Converts the built-in .obj meshes into the precompiled binary mesh format.
+
+The output is already indexed the same way VertexIndexer::indexVBO() would index the
+.obj data, so the library can upload it as is. Run this after changing any of the .obj
+files in src/datavisualization/engine/meshes:
+
+    python3 obj2mesh.py ../../src/datavisualization/engine/meshes/*.obj
+
+Binary layout (all values little endian):
+    char[4]     magic "QDVM"
+    uint32      format version (1)
+    uint32      vertex count
+    uint32      index count
+    float32[]   positions (3 per vertex)
+    float32[]   uvs (2 per vertex)
+    float32[]   normals (3 per vertex)
+    uint32[]    indices
+"""
+
+import os
+import struct
+import sys
+
+MAGIC = b'QDVM'
+VERSION = 1
+
+
+def f32(value):
+    return struct.unpack('<f', struct.pack('<f', float(value)))[0]
+
+
+def load_obj(path):
+    positions, uvs, normals = [], [], []
+    vertices = []
+    with open(path, 'r') as obj:
+        for line in obj:
+            parts = line.rstrip('\r\n').split(' ')
+            if parts[0] == 'v':
+                positions.append(tuple(f32(x) for x in parts[1:4]))
+            elif parts[0] == 'vt':
+                uvs.append(tuple(f32(x) for x in parts[1:3]))
+            elif parts[0] == 'vn':
+                normals.append(tuple(f32(x) for x in parts[1:4]))
+            elif parts[0] == 'f':
+                for corner in parts[1:4]:
+                    v, t, n = (int(i) - 1 for i in corner.split('/'))
+                    vertices.append((positions[v], uvs[t], normals[n]))
+    return vertices
+
+
+def index_vertices(vertices):
+    # Same ordering as VertexIndexer::indexVBO(): unique vertices in order of first use,
+    # compared bitwise
+    lookup = {}
+    unique = []
+    indices = []
+    for vertex in vertices:
+        key = struct.pack('<8f', *(vertex[0] + vertex[1] + vertex[2]))
+        index = lookup.get(key)
+        if index is None:
+            index = len(unique)
+            lookup[key] = index
+            unique.append(vertex)
+        indices.append(index)
+    return unique, indices
+
+
+def write_mesh(path, unique, indices):
+    with open(path, 'wb') as out:
+        out.write(MAGIC)
+        out.write(struct.pack('<III', VERSION, len(unique), len(indices)))
+        for component in range(3):
+            size = 2 if component == 1 else 3
+            for vertex in unique:
+                out.write(struct.pack('<%df' % size, *vertex[component]))
+        out.write(struct.pack('<%dI' % len(indices), *indices))
+
+
+def main(args):
+    if not args:
+        print(__doc__)
+        return 1
+    for objPath in args:
+        unique, indices = index_vertices(load_obj(objPath))
+        meshPath = os.path.splitext(objPath)[0] + '.mesh'
+        write_mesh(meshPath, unique, indices)
+        print('%s: %d vertices, %d indices' % (meshPath, len(unique), len(indices)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))